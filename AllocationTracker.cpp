@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationtracker.cpp
+// ============
+// count the heap allocations made while the frame loop is running
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AllocationTracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// true between Begin() and End()
+	std::atomic<bool> g_bTracking(false);
+	// allocations and bytes counted since the last reset
+	std::atomic<long long> g_Allocations(0);
+	std::atomic<long long> g_Bytes(0);
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for starting to count the heap
+ *  allocations of every thread.
+ ***********************************************************/
+void AllocationTracker::Begin()
+{
+	g_bTracking.store(true);
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method is used for no longer counting the heap
+ *  allocations.
+ ***********************************************************/
+void AllocationTracker::End()
+{
+	g_bTracking.store(false);
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for clearing the counted allocations.
+ ***********************************************************/
+void AllocationTracker::Reset()
+{
+	g_Allocations.store(0);
+	g_Bytes.store(0);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the allocations counted
+ *  since the last reset.
+ ***********************************************************/
+ALLOCATION_STATS AllocationTracker::GetStats()
+{
+	ALLOCATION_STATS stats;
+	stats.allocations = g_Allocations.load();
+	stats.bytes = g_Bytes.load();
+
+	return(stats);
+}
+
+/***********************************************************
+ *  OnAllocate()
+ *
+ *  This method is used for counting one heap allocation
+ *  when the allocations are being tracked.
+ ***********************************************************/
+void AllocationTracker::OnAllocate(std::size_t size)
+{
+	if (g_bTracking.load(std::memory_order_relaxed) == true)
+	{
+		g_Allocations.fetch_add(1, std::memory_order_relaxed);
+		g_Bytes.fetch_add((long long)size, std::memory_order_relaxed);
+	}
+}
+
+/***********************************************************
+ *  operator new()
+ *
+ *  The replacements of the global allocation functions, for
+ *  plain and over-aligned types.  The array and non-throwing
+ *  forms of new call these, so every allocation of the
+ *  program passes through here.
+ ***********************************************************/
+void* operator new(std::size_t size)
+{
+	AllocationTracker::OnAllocate(size);
+
+	// malloc may return NULL for an empty request
+	void* pMemory = std::malloc((size > 0) ? size : 1);
+	if (NULL == pMemory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return(pMemory);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	AllocationTracker::OnAllocate(size);
+
+	// aligned_alloc wants a size that is a multiple of the alignment
+	std::size_t align = (std::size_t)alignment;
+	std::size_t alignedSize = (((size > 0) ? size : 1) + align - 1) / align * align;
+#ifdef _WIN32
+	void* pMemory = _aligned_malloc(alignedSize, align);
+#else
+	void* pMemory = std::aligned_alloc(align, alignedSize);
+#endif
+	if (NULL == pMemory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return(pMemory);
+}
+
+/***********************************************************
+ *  operator delete()
+ *
+ *  The replacements of the global deallocation functions,
+ *  matching the allocation functions above.
+ ***********************************************************/
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(pMemory);
+#else
+	std::free(pMemory);
+#endif
+}
+
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(pMemory);
+#else
+	std::free(pMemory);
+#endif
+}
@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationtracker.h
+// ============
+// count the heap allocations made while the frame loop is running
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+// heap allocations counted while tracking
+struct ALLOCATION_STATS
+{
+	long long allocations;		// calls to operator new
+	long long bytes;			// bytes asked for by those calls
+};
+
+/***********************************************************
+ *  AllocationTracker
+ *
+ *  This class counts the calls to the global operator new,
+ *  which this module replaces in its plain and aligned
+ *  forms.  Counting is only switched on between Begin() and
+ *  End(), around the part of a frame that is meant to run
+ *  without touching the heap, and covers every thread, so
+ *  the job system workers count as well.  Outside of that
+ *  window the only cost of the hook is a single flag test
+ *  per allocation.
+ ***********************************************************/
+class AllocationTracker
+{
+public:
+	// start counting the allocations
+	static void Begin();
+	// stop counting the allocations
+	static void End();
+	// clear the counted allocations
+	static void Reset();
+	// get the allocations counted since the last reset
+	static ALLOCATION_STATS GetStats();
+
+	// count one allocation when tracking, called by operator new
+	static void OnAllocate(std::size_t size);
+};
@@ -0,0 +1,402 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.cpp
+// ============
+// scripted camera path and frame time statistics for headless benchmark runs
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+#include "TransformSystem.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// default number of measured and warmup frames
+	const int g_DefaultFrames = 600;
+	const int g_DefaultWarmupFrames = 60;
+	// default file the statistics are written to
+	const char* const g_DefaultStatsFilename = "benchmark.json";
+
+	// frames for one full orbit of the camera path
+	const int g_OrbitFrames = 600;
+	// shape of the camera orbit around the desk
+	const float g_OrbitRadius = 7.0f;
+	const float g_OrbitHeight = 3.5f;
+	const float g_OrbitHeightSwing = 1.5f;
+	// point on the desk the camera keeps looking at
+	const glm::vec3 g_OrbitTarget = glm::vec3(0.0f, 0.4f, -0.3f);
+
+	// area above the desk the extra point lights are spread over,
+	// and the range of their radius
+	const glm::vec3 g_LightAreaMin = glm::vec3(-6.0f, 0.2f, -4.0f);
+	const glm::vec3 g_LightAreaMax = glm::vec3(6.0f, 2.0f, 3.0f);
+	const float g_MinLightRadius = 1.0f;
+	const float g_MaxLightRadius = 2.0f;
+
+	// get the value of a percentile from sorted samples
+	float GetPercentile(const std::vector<float>& sorted, int percentile)
+	{
+		// nearest rank, so the result is always one of the samples
+		int rank = (int)std::ceil(percentile / 100.0 * sorted.size());
+		return(sorted[std::max(rank, 1) - 1]);
+	}
+}
+
+/***********************************************************
+ *  Benchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+Benchmark::Benchmark()
+{
+}
+
+/***********************************************************
+ *  ParseCommandLine()
+ *
+ *  This method is used for filling in the benchmark settings
+ *  from the command line.  With no arguments the application
+ *  runs interactively in a window as before.
+ ***********************************************************/
+bool Benchmark::ParseCommandLine(int argc, char* argv[], BENCHMARK_SETTINGS& settings)
+{
+	settings.bHeadless = false;
+	settings.bTransformBenchmark = false;
+	settings.frames = g_DefaultFrames;
+	settings.warmupFrames = g_DefaultWarmupFrames;
+	settings.statsFilename = g_DefaultStatsFilename;
+	settings.extraLights = 0;
+	settings.bCheckAllocations = false;
+	settings.bNoShaderCache = false;
+	settings.sceneFilename.clear();
+	settings.compileFilename.clear();
+
+	for (int i = 1; i < argc; i++)
+	{
+		// the flag options take no value, every other option does
+		bool bHasValue = (i + 1 < argc);
+
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			settings.bHeadless = true;
+		}
+		else if (strcmp(argv[i], "--transform-benchmark") == 0)
+		{
+			settings.bTransformBenchmark = true;
+		}
+		else if (strcmp(argv[i], "--check-allocations") == 0)
+		{
+			settings.bCheckAllocations = true;
+		}
+		else if (strcmp(argv[i], "--no-shader-cache") == 0)
+		{
+			settings.bNoShaderCache = true;
+		}
+		else if ((strcmp(argv[i], "--frames") == 0) && (bHasValue == true))
+		{
+			settings.frames = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--warmup") == 0) && (bHasValue == true))
+		{
+			settings.warmupFrames = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--stats") == 0) && (bHasValue == true))
+		{
+			settings.statsFilename = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--lights") == 0) && (bHasValue == true))
+		{
+			settings.extraLights = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--scene") == 0) && (bHasValue == true))
+		{
+			settings.sceneFilename = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--compile-scene") == 0) && (bHasValue == true))
+		{
+			settings.compileFilename = argv[++i];
+		}
+		else
+		{
+			std::cout << "Unknown argument:" << argv[i] << std::endl;
+			return(false);
+		}
+	}
+
+	if ((settings.frames <= 0) || (settings.warmupFrames < 0) || (settings.extraLights < 0))
+	{
+		std::cout << "The frame counts must be positive" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  PrintUsage()
+ *
+ *  This method is used for printing the supported command
+ *  line arguments.
+ ***********************************************************/
+void Benchmark::PrintUsage(const char* programName)
+{
+	std::cout << "Usage: " << programName << " [--headless] [--frames N] [--warmup N] [--stats FILE]"
+		<< " [--lights N] [--check-allocations] [--no-shader-cache] [--scene FILE]"
+		<< " [--compile-scene FILE] [--transform-benchmark]\n"
+		<< "  --headless    render offscreen along the benchmark camera path\n"
+		<< "  --frames N    number of measured frames (default " << g_DefaultFrames << ")\n"
+		<< "  --warmup N    frames rendered before measuring (default " << g_DefaultWarmupFrames << ")\n"
+		<< "  --stats FILE  JSON file for the frame time statistics (default "
+		<< g_DefaultStatsFilename << ")\n"
+		<< "  --lights N    add N small point lights over the desk (default 0)\n"
+		<< "  --check-allocations  fail if a measured frame allocates heap memory\n"
+		<< "  --no-shader-cache  compile every shader from source, without saving the binaries\n"
+		<< "  --scene FILE  load the scene layout from a text or compiled scene file\n"
+		<< "  --compile-scene FILE  compile a scene text file into its binary form and exit\n"
+		<< "  --transform-benchmark  time the model matrix composition and exit" << std::endl;
+}
+
+/***********************************************************
+ *  GetCameraPose()
+ *
+ *  This method is used for getting the camera position and
+ *  view direction of a frame.  The camera circles the desk
+ *  while rising and falling, so culling and texture use
+ *  change over the run.  The pose only depends on the frame
+ *  number and never on the clock.
+ ***********************************************************/
+void Benchmark::GetCameraPose(int frame, glm::vec3& position, glm::vec3& front)
+{
+	float angle = 2.0f * 3.14159265f * (frame % g_OrbitFrames) / g_OrbitFrames;
+
+	position = glm::vec3(
+		g_OrbitTarget.x + g_OrbitRadius * std::sin(angle),
+		g_OrbitHeight + g_OrbitHeightSwing * std::sin(2.0f * angle),
+		g_OrbitTarget.z + g_OrbitRadius * std::cos(angle));
+	front = glm::normalize(g_OrbitTarget - position);
+}
+
+/***********************************************************
+ *  GetExtraLight()
+ *
+ *  This method is used for getting the placement, radius and
+ *  color of one of the extra point lights that stress the
+ *  clustered lighting.  The values only depend on the index,
+ *  so every run lights the scene the same way.
+ ***********************************************************/
+void Benchmark::GetExtraLight(int index, glm::vec3& position, float& radius, glm::vec3& color)
+{
+	float values[7];
+	unsigned int seed = 54321u + (unsigned int)index * 2654435761u;
+	for (int j = 0; j < 7; j++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		values[j] = (seed >> 8) / 16777216.0f;
+	}
+
+	position = g_LightAreaMin + (g_LightAreaMax - g_LightAreaMin) * glm::vec3(values[0], values[1], values[2]);
+	radius = g_MinLightRadius + (g_MaxLightRadius - g_MinLightRadius) * values[3];
+	color = glm::vec3(values[4], values[5], values[6]);
+}
+
+/***********************************************************
+ *  RunTransformBenchmark()
+ *
+ *  This method is used for timing the batched composition of
+ *  the model matrices against composing each one through glm
+ *  matrix multiplies, over objects with random transforms.
+ *  The time of an update with nothing changed is also shown,
+ *  since that is the usual frame for a static scene.
+ ***********************************************************/
+void Benchmark::RunTransformBenchmark(int objectCount, int iterations)
+{
+	std::vector<glm::vec3> scales(objectCount);
+	std::vector<glm::vec3> rotations(objectCount);
+	std::vector<glm::vec3> positions(objectCount);
+	std::vector<glm::mat4> matrices(objectCount);
+	TransformSystem transforms;
+
+	// the same pseudo-random values on every run
+	unsigned int seed = 12345;
+	for (int i = 0; i < objectCount; i++)
+	{
+		float values[9];
+		for (int j = 0; j < 9; j++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			values[j] = (seed >> 8) / 16777216.0f;
+		}
+		scales[i] = glm::vec3(0.1f + values[0] * 2.0f, 0.1f + values[1] * 2.0f, 0.1f + values[2] * 2.0f);
+		rotations[i] = glm::vec3(values[3] * 720.0f - 360.0f, values[4] * 720.0f - 360.0f, values[5] * 720.0f - 360.0f);
+		positions[i] = glm::vec3(values[6] * 20.0f - 10.0f, values[7] * 5.0f, values[8] * 20.0f - 10.0f);
+		transforms.Add(scales[i], rotations[i].x, rotations[i].y, rotations[i].z, positions[i]);
+	}
+
+	// per-object glm matrix multiplies
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		for (int i = 0; i < objectCount; i++)
+		{
+			matrices[i] = TransformSystem::ComposeReference(
+				scales[i], rotations[i].x, rotations[i].y, rotations[i].z, positions[i]);
+		}
+	}
+	std::chrono::duration<double, std::milli> referenceTime = std::chrono::steady_clock::now() - start;
+
+	// batched composition with every object changed
+	std::chrono::duration<double, std::milli> batchedTime(0.0);
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		for (int i = 0; i < objectCount; i++)
+		{
+			transforms.Set(i, scales[i], rotations[i].x, rotations[i].y, rotations[i].z, positions[i]);
+		}
+		start = std::chrono::steady_clock::now();
+		transforms.Update();
+		batchedTime += std::chrono::steady_clock::now() - start;
+	}
+
+	// batched composition with every object changed, spread
+	// over a worker per core
+	JobSystem jobSystem;
+	jobSystem.Start();
+	std::chrono::duration<double, std::milli> parallelTime(0.0);
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		for (int i = 0; i < objectCount; i++)
+		{
+			transforms.Set(i, scales[i], rotations[i].x, rotations[i].y, rotations[i].z, positions[i]);
+		}
+		start = std::chrono::steady_clock::now();
+		transforms.Update(&jobSystem);
+		parallelTime += std::chrono::steady_clock::now() - start;
+	}
+
+	// batched composition with nothing changed
+	start = std::chrono::steady_clock::now();
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		transforms.Update();
+	}
+	std::chrono::duration<double, std::milli> unchangedTime = std::chrono::steady_clock::now() - start;
+
+	// largest difference between the two paths
+	float maxError = 0.0f;
+	for (int i = 0; i < objectCount; i++)
+	{
+		const glm::mat4& batched = transforms.GetMatrix(i);
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				maxError = std::max(maxError, std::fabs(batched[column][row] - matrices[i][column][row]));
+			}
+		}
+	}
+
+	double objectUpdates = (double)objectCount * iterations;
+	std::cout << "INFO: Transform benchmark - " << objectCount << " objects, " << iterations << " iterations\n"
+		<< "  glm per object:      " << referenceTime.count() * 1.0e6 / objectUpdates << " ns/object\n"
+		<< "  batched, all dirty:  " << batchedTime.count() * 1.0e6 / objectUpdates << " ns/object ("
+		<< referenceTime.count() / batchedTime.count() << "x)\n"
+		<< "  batched, " << jobSystem.GetThreadCount() << " threads: "
+		<< parallelTime.count() * 1.0e6 / objectUpdates << " ns/object ("
+		<< referenceTime.count() / parallelTime.count() << "x)\n"
+		<< "  batched, unchanged:  " << unchangedTime.count() * 1.0e6 / objectUpdates << " ns/object\n"
+		<< "  largest difference:  " << maxError << std::endl;
+}
+
+/***********************************************************
+ *  AddFrameTime()
+ *
+ *  This method is used for adding the time of one measured
+ *  frame.
+ ***********************************************************/
+void Benchmark::AddFrameTime(double milliseconds)
+{
+	m_frameTimes.push_back((float)milliseconds);
+}
+
+/***********************************************************
+ *  ComputeStats()
+ *
+ *  This method is used for computing the mean, median, tail
+ *  percentiles and maximum of the measured frame times.
+ ***********************************************************/
+void Benchmark::ComputeStats(BENCHMARK_STATS& stats) const
+{
+	stats.frames = (int)m_frameTimes.size();
+	stats.mean = 0.0f;
+	stats.p50 = 0.0f;
+	stats.p95 = 0.0f;
+	stats.p99 = 0.0f;
+	stats.maximum = 0.0f;
+
+	if (m_frameTimes.size() == 0)
+	{
+		return;
+	}
+
+	std::vector<float> sorted = m_frameTimes;
+	std::sort(sorted.begin(), sorted.end());
+
+	double total = 0.0;
+	for (int i = 0; i < sorted.size(); i++)
+	{
+		total += sorted[i];
+	}
+
+	stats.mean = (float)(total / sorted.size());
+	stats.p50 = GetPercentile(sorted, 50);
+	stats.p95 = GetPercentile(sorted, 95);
+	stats.p99 = GetPercentile(sorted, 99);
+	stats.maximum = sorted.back();
+}
+
+/***********************************************************
+ *  WriteJSON()
+ *
+ *  This method is used for writing the statistics of the
+ *  measured frames to a JSON file, along with the number of
+ *  warmup frames that ran before them and the heap
+ *  allocations the measured frames made.
+ ***********************************************************/
+bool Benchmark::WriteJSON(const char* filename, int warmupFrames, long long frameAllocations) const
+{
+	BENCHMARK_STATS stats;
+	ComputeStats(stats);
+
+	FILE* file = fopen(filename, "w");
+	if (file == NULL)
+	{
+		std::cout << "Could not write benchmark statistics:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "  \"frames\": %d,\n", stats.frames);
+	fprintf(file, "  \"warmup_frames\": %d,\n", warmupFrames);
+	fprintf(file, "  \"frame_allocations\": %lld,\n", frameAllocations);
+	fprintf(file, "  \"frame_time_ms\": {\n");
+	fprintf(file, "    \"mean\": %.4f,\n", stats.mean);
+	fprintf(file, "    \"p50\": %.4f,\n", stats.p50);
+	fprintf(file, "    \"p95\": %.4f,\n", stats.p95);
+	fprintf(file, "    \"p99\": %.4f,\n", stats.p99);
+	fprintf(file, "    \"max\": %.4f\n", stats.maximum);
+	fprintf(file, "  }\n");
+	fprintf(file, "}\n");
+
+	return(fclose(file) == 0);
+}
@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.h
+// ============
+// scripted camera path and frame time statistics for headless benchmark runs
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+// settings of a benchmark run, read from the command line
+struct BENCHMARK_SETTINGS
+{
+	bool bHeadless;					// render offscreen with no visible window
+	bool bTransformBenchmark;		// time the model matrix composition and exit
+	int frames;						// number of measured frames
+	int warmupFrames;				// frames rendered before measuring
+	std::string statsFilename;		// JSON file the statistics are written to
+	int extraLights;				// small point lights added over the desk
+	bool bCheckAllocations;			// fail the run if a measured frame allocates
+	bool bNoShaderCache;			// compile every shader instead of loading its binary
+	std::string sceneFilename;		// scene file to load, empty for the desk scene
+	std::string compileFilename;	// scene text file to compile before exiting
+};
+
+// frame time statistics of a benchmark run, in milliseconds
+struct BENCHMARK_STATS
+{
+	int frames;
+	float mean;
+	float p50;
+	float p95;
+	float p99;
+	float maximum;
+};
+
+/***********************************************************
+ *  Benchmark
+ *
+ *  This class drives a reproducible benchmark run.  The
+ *  camera follows a fixed orbit around the scene that only
+ *  depends on the frame number, so every run renders the
+ *  same frames no matter how fast the machine is.  The time
+ *  of every measured frame is kept and reduced to summary
+ *  statistics at the end of the run.
+ ***********************************************************/
+class Benchmark
+{
+public:
+	// constructor
+	Benchmark();
+
+	// fill in the settings from the command line arguments,
+	// returns false if an argument is not understood
+	static bool ParseCommandLine(int argc, char* argv[], BENCHMARK_SETTINGS& settings);
+	// print the supported command line arguments
+	static void PrintUsage(const char* programName);
+
+	// get the camera position and direction for a frame of the path
+	static void GetCameraPose(int frame, glm::vec3& position, glm::vec3& front);
+	// get the placement and color of one of the extra point lights
+	static void GetExtraLight(int index, glm::vec3& position, float& radius, glm::vec3& color);
+
+	// time the batched model matrix composition against composing
+	// each matrix through glm, needs no OpenGL context
+	static void RunTransformBenchmark(int objectCount, int iterations);
+
+	// add the time of one measured frame
+	void AddFrameTime(double milliseconds);
+	// compute the statistics of the measured frames
+	void ComputeStats(BENCHMARK_STATS& stats) const;
+	// write the statistics of the measured frames to a JSON file,
+	// with the heap allocations counted over those frames
+	bool WriteJSON(const char* filename, int warmupFrames, long long frameAllocations) const;
+
+private:
+	// time of every measured frame in milliseconds
+	std::vector<float> m_frameTimes;
+};
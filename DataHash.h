@@ -0,0 +1,32 @@
+///////////////////////////////////////////////////////////////////////////////
+// datahash.h
+// ============
+// hash of a block of data, for naming cache files and spotting changed sources
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  HashData()
+ *
+ *  64-bit FNV-1a hash of a block of data, such as the
+ *  contents of a source file.  It is not meant to resist
+ *  deliberate collisions, only to tell contents apart.
+ ***********************************************************/
+inline uint64_t HashData(const unsigned char* data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+
+	return(hash);
+}
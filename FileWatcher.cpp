@@ -0,0 +1,229 @@
+///////////////////////////////////////////////////////////////////////////////
+// filewatcher.cpp
+// ============
+// notice when files on disk have been changed while the application runs
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FileWatcher.h"
+
+#include <iostream>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// how long a file must be left alone before it is reported
+	const std::chrono::milliseconds g_SettleTime(100);
+	// how often the write times of the polled files are compared
+	const std::chrono::milliseconds g_ScanInterval(250);
+}
+
+/***********************************************************
+ *  FileWatcher()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FileWatcher::FileWatcher()
+{
+	m_inotify = -1;
+	m_lastScan = std::chrono::steady_clock::now();
+
+#ifdef __linux__
+	m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_inotify < 0)
+	{
+		std::cout << "Could not start inotify, polling the watched files instead" << std::endl;
+	}
+#endif
+}
+
+/***********************************************************
+ *  ~FileWatcher()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+	if (m_inotify >= 0)
+	{
+		close(m_inotify);
+		m_inotify = -1;
+	}
+#endif
+}
+
+/***********************************************************
+ *  AddFile()
+ *
+ *  This method is used for starting to watch a file.  The
+ *  directory is watched rather than the file itself, since
+ *  many editors save by writing a new file and renaming it
+ *  over the old one.
+ ***********************************************************/
+void FileWatcher::AddFile(const char* filename)
+{
+	WATCHED_FILE file;
+	file.filename = filename;
+	file.watch = -1;
+	file.bChanged = false;
+	GetFileStamp(filename, file.modifiedTime, file.size);
+
+	std::string directory = ".";
+	size_t separator = file.filename.find_last_of("/\\");
+	if (separator == std::string::npos)
+	{
+		file.name = file.filename;
+	}
+	else
+	{
+		directory = file.filename.substr(0, separator);
+		file.name = file.filename.substr(separator + 1);
+	}
+
+#ifdef __linux__
+	if (m_inotify >= 0)
+	{
+		// a directory that is already watched gives back its watch
+		file.watch = inotify_add_watch(m_inotify, directory.c_str(),
+			IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		if (file.watch < 0)
+		{
+			std::cout << "Could not watch directory:" << directory << ", polling " << filename << std::endl;
+		}
+	}
+#endif
+
+	m_files.push_back(file);
+}
+
+/***********************************************************
+ *  Poll()
+ *
+ *  This method is used for collecting the watched files that
+ *  have changed and have then been left alone for a moment.
+ *  When nothing has changed the list is left empty without
+ *  touching the heap, so it can be called every frame.
+ ***********************************************************/
+int FileWatcher::Poll(std::vector<std::string>& changedFiles)
+{
+	changedFiles.clear();
+
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	ReadEvents(now);
+	if (now - m_lastScan >= g_ScanInterval)
+	{
+		ScanFiles(now);
+		m_lastScan = now;
+	}
+
+	for (int i = 0; i < m_files.size(); i++)
+	{
+		WATCHED_FILE& file = m_files[i];
+		if ((file.bChanged == true) && (now - file.changeTime >= g_SettleTime))
+		{
+			changedFiles.push_back(file.filename);
+			file.bChanged = false;
+		}
+	}
+
+	return((int)changedFiles.size());
+}
+
+/***********************************************************
+ *  ReadEvents()
+ *
+ *  This method is used for reading every waiting inotify
+ *  event and marking the watched file it names as changed.
+ *  Each new event about a file restarts its wait.
+ ***********************************************************/
+void FileWatcher::ReadEvents(std::chrono::steady_clock::time_point now)
+{
+#ifdef __linux__
+	if (m_inotify < 0)
+	{
+		return;
+	}
+
+	alignas(struct inotify_event) char buffer[4096];
+	ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+	while (length > 0)
+	{
+		for (char* pNext = buffer; pNext < buffer + length; )
+		{
+			const struct inotify_event* pEvent = (const struct inotify_event*)pNext;
+			if (pEvent->len > 0)
+			{
+				for (int i = 0; i < m_files.size(); i++)
+				{
+					WATCHED_FILE& file = m_files[i];
+					if ((file.watch == pEvent->wd) && (file.name == pEvent->name))
+					{
+						file.bChanged = true;
+						file.changeTime = now;
+					}
+				}
+			}
+			pNext += sizeof(struct inotify_event) + pEvent->len;
+		}
+		length = read(m_inotify, buffer, sizeof(buffer));
+	}
+#endif
+}
+
+/***********************************************************
+ *  ScanFiles()
+ *
+ *  This method is used for comparing the write time and size
+ *  of every file that is not watched through inotify with
+ *  the ones seen last time.
+ ***********************************************************/
+void FileWatcher::ScanFiles(std::chrono::steady_clock::time_point now)
+{
+	for (int i = 0; i < m_files.size(); i++)
+	{
+		WATCHED_FILE& file = m_files[i];
+		if (file.watch >= 0)
+		{
+			continue;
+		}
+
+		long long modifiedTime = 0;
+		long long size = 0;
+		GetFileStamp(file.filename.c_str(), modifiedTime, size);
+		if ((modifiedTime != file.modifiedTime) || (size != file.size))
+		{
+			file.modifiedTime = modifiedTime;
+			file.size = size;
+			file.bChanged = true;
+			file.changeTime = now;
+		}
+	}
+}
+
+/***********************************************************
+ *  GetFileStamp()
+ *
+ *  This method is used for getting the last write time and
+ *  the size of a file.
+ ***********************************************************/
+void FileWatcher::GetFileStamp(const char* filename, long long& modifiedTime, long long& size)
+{
+	struct stat status;
+	if (stat(filename, &status) != 0)
+	{
+		modifiedTime = 0;
+		size = 0;
+		return;
+	}
+
+	modifiedTime = (long long)status.st_mtime;
+	size = (long long)status.st_size;
+}
@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// filewatcher.h
+// ============
+// notice when files on disk have been changed while the application runs
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  FileWatcher
+ *
+ *  This class reports the watched files that have been
+ *  written since it was last asked.  On Linux the directory
+ *  of each file is watched with inotify, so asking costs one
+ *  read that finds nothing; elsewhere, or when a directory
+ *  cannot be watched, the write times of the files are
+ *  compared a few times a second instead.  Editors often
+ *  write a file in several steps, so a file is only reported
+ *  once it has been left alone for a moment.
+ ***********************************************************/
+class FileWatcher
+{
+public:
+	// constructor
+	FileWatcher();
+	// destructor
+	~FileWatcher();
+
+	// start watching a file, which does not need to exist yet
+	void AddFile(const char* filename);
+	// get the watched files that have changed since the last
+	// call, returns the number of files
+	int Poll(std::vector<std::string>& changedFiles);
+
+private:
+	struct WATCHED_FILE
+	{
+		// path as it was passed in, and the name in its directory
+		std::string filename;
+		std::string name;
+		// inotify watch of the directory, -1 when the file is polled
+		int watch;
+		// write time and size last seen when polling
+		long long modifiedTime;
+		long long size;
+		// true when the file has changed and is not yet reported
+		bool bChanged;
+		std::chrono::steady_clock::time_point changeTime;
+	};
+
+	// every watched file
+	std::vector<WATCHED_FILE> m_files;
+	// inotify instance, -1 when the files are polled
+	int m_inotify;
+	// when the write times of the polled files were last compared
+	std::chrono::steady_clock::time_point m_lastScan;
+
+	// mark the files that the waiting events are about as changed
+	void ReadEvents(std::chrono::steady_clock::time_point now);
+	// compare the write times of the polled files
+	void ScanFiles(std::chrono::steady_clock::time_point now);
+	// get the write time and size of a file, both 0 when it is missing
+	static void GetFileStamp(const char* filename, long long& modifiedTime, long long& size);
+};
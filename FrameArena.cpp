@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.cpp
+// ============
+// linear allocator for the scratch data that only lives for one frame
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameArena.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// alignment of every block, enough for any plain item
+	const size_t g_BlockAlignment = alignof(std::max_align_t);
+}
+
+/***********************************************************
+ *  FrameArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameArena::FrameArena()
+{
+	m_pBlock = NULL;
+	m_used = 0;
+	m_frameBytes = 0;
+	m_stats.capacity = 0;
+	m_stats.peakBytes = 0;
+	m_stats.overflows = 0;
+}
+
+/***********************************************************
+ *  ~FrameArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameArena::~FrameArena()
+{
+	FreeOverflowBlocks();
+	delete[] m_pBlock;
+	m_pBlock = NULL;
+}
+
+/***********************************************************
+ *  Reserve()
+ *
+ *  This method is used for making sure the block has room
+ *  for a number of bytes.  Anything handed out this frame is
+ *  taken back, so this belongs before the frame begins.
+ ***********************************************************/
+void FrameArena::Reserve(size_t bytes)
+{
+	m_used = 0;
+	m_frameBytes = 0;
+	FreeOverflowBlocks();
+
+	if (bytes <= m_stats.capacity)
+	{
+		return;
+	}
+
+	delete[] m_pBlock;
+	m_pBlock = new unsigned char[bytes];
+	m_stats.capacity = bytes;
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for taking back everything handed out
+ *  since the last reset.  When the frame needed more than
+ *  the block holds, the block grows to half again what the
+ *  frame asked for, so a slowly growing scene does not grow
+ *  it every frame.
+ ***********************************************************/
+void FrameArena::Reset()
+{
+	m_stats.peakBytes = std::max(m_stats.peakBytes, m_frameBytes);
+
+	if (m_overflowBlocks.size() > 0)
+	{
+		m_stats.overflows++;
+		Reserve(m_frameBytes + m_frameBytes / 2);
+	}
+
+	m_used = 0;
+	m_frameBytes = 0;
+}
+
+/***********************************************************
+ *  AllocateBytes()
+ *
+ *  This method is used for handing out room for a number of
+ *  bytes at an alignment, which must be a power of two no
+ *  larger than that of any plain item.  The room is taken
+ *  from the block when it fits, or else from an overflow
+ *  block of its own.
+ ***********************************************************/
+void* FrameArena::AllocateBytes(size_t size, size_t alignment)
+{
+	size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+	m_frameBytes += size + (offset - m_used);
+
+	if (offset + size <= m_stats.capacity)
+	{
+		m_used = offset + size;
+		return(m_pBlock + offset);
+	}
+
+	unsigned char* pOverflow = new unsigned char[std::max(size, g_BlockAlignment)];
+	m_overflowBlocks.push_back(pOverflow);
+
+	return(pOverflow);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the counters of the
+ *  arena use.
+ ***********************************************************/
+const FRAME_ARENA_STATS& FrameArena::GetStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  FreeOverflowBlocks()
+ *
+ *  This method is used for releasing the blocks of the
+ *  requests that did not fit in the arena.
+ ***********************************************************/
+void FrameArena::FreeOverflowBlocks()
+{
+	for (int i = 0; i < m_overflowBlocks.size(); i++)
+	{
+		delete[] m_overflowBlocks[i];
+	}
+	m_overflowBlocks.clear();
+}
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.h
+// ============
+// linear allocator for the scratch data that only lives for one frame
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// counters of the arena use since it was created
+struct FRAME_ARENA_STATS
+{
+	size_t capacity;				// bytes in the arena block
+	size_t peakBytes;				// most bytes handed out in one frame
+	int overflows;					// frames that did not fit and grew the block
+};
+
+/***********************************************************
+ *  FrameArena
+ *
+ *  This class hands out scratch memory for the current frame
+ *  by bumping an offset into one block, and takes all of it
+ *  back at once when the next frame begins.  Nothing is
+ *  freed on its own and no item is constructed, so only
+ *  plain data belongs in the arena.  A request that does not
+ *  fit gets a block of its own for the rest of the frame,
+ *  and the arena grows to the frame's total at the next
+ *  reset, so a steady frame never touches the heap.  The
+ *  arena is not thread safe and belongs to the rendering
+ *  thread.
+ ***********************************************************/
+class FrameArena
+{
+public:
+	// constructor
+	FrameArena();
+	// destructor
+	~FrameArena();
+
+	// make room for a number of bytes each frame
+	void Reserve(size_t bytes);
+	// take back everything handed out, growing the block first
+	// when the last frame did not fit
+	void Reset();
+
+	// get uninitialized room for a number of plain items, which
+	// stays valid until the next reset
+	template <typename T>
+	T* Allocate(size_t count)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "only plain data belongs in the frame arena");
+		return(static_cast<T*>(AllocateBytes(sizeof(T) * count, alignof(T))));
+	}
+	// get uninitialized room for a number of bytes
+	void* AllocateBytes(size_t size, size_t alignment);
+
+	// get the counters of the arena use
+	const FRAME_ARENA_STATS& GetStats() const;
+
+private:
+	// the block the memory is handed out from
+	unsigned char* m_pBlock;
+	size_t m_used;
+	// blocks of the requests that did not fit this frame
+	std::vector<unsigned char*> m_overflowBlocks;
+	// bytes asked for this frame, including the overflow
+	size_t m_frameBytes;
+	FRAME_ARENA_STATS m_stats;
+
+	// release the overflow blocks
+	void FreeOverflowBlocks();
+};
@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.cpp
+// ============
+// timestamped keyboard and mouse events handed from the callbacks to the frame
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputQueue.h"
+
+/***********************************************************
+ *  InputQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputQueue::InputQueue()
+	: m_head(0), m_tail(0), m_pushed(0), m_dropped(0)
+{
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used for adding an event to the queue.
+ *  The event is written before the new tail is published,
+ *  so the reader never sees a slot that is half written.
+ *  The positions only ever count up and are wrapped when
+ *  used, which keeps a full ring apart from an empty one.
+ ***********************************************************/
+bool InputQueue::Push(const INPUT_EVENT& event)
+{
+	unsigned int tail = m_tail.load(std::memory_order_relaxed);
+	unsigned int head = m_head.load(std::memory_order_acquire);
+	if (tail - head >= CAPACITY)
+	{
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return(false);
+	}
+
+	m_events[tail & (CAPACITY - 1)] = event;
+	m_tail.store(tail + 1, std::memory_order_release);
+	m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Pop()
+ *
+ *  This method is used for taking the oldest event from the
+ *  queue.  The slot is read before the new head is
+ *  published, so the writer never reuses it too early.
+ ***********************************************************/
+bool InputQueue::Pop(INPUT_EVENT& event)
+{
+	unsigned int head = m_head.load(std::memory_order_relaxed);
+	unsigned int tail = m_tail.load(std::memory_order_acquire);
+	if (head == tail)
+	{
+		return(false);
+	}
+
+	event = m_events[head & (CAPACITY - 1)];
+	m_head.store(head + 1, std::memory_order_release);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetPushedCount()
+ *
+ *  This method is used for getting the number of events
+ *  added to the queue.
+ ***********************************************************/
+int InputQueue::GetPushedCount() const
+{
+	return(m_pushed.load(std::memory_order_relaxed));
+}
+
+/***********************************************************
+ *  GetDroppedCount()
+ *
+ *  This method is used for getting the number of events
+ *  dropped because the queue was full.
+ ***********************************************************/
+int InputQueue::GetDroppedCount() const
+{
+	return(m_dropped.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.h
+// ============
+// timestamped keyboard and mouse events handed from the callbacks to the frame
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+// kinds of input events
+const int INPUT_KEY = 0;
+const int INPUT_CURSOR = 1;
+const int INPUT_SCROLL = 2;
+
+// one input event as it was received
+struct INPUT_EVENT
+{
+	int type;						// INPUT_KEY, INPUT_CURSOR or INPUT_SCROLL
+	int key;						// GLFW key of a key event
+	int action;						// GLFW_PRESS, GLFW_REPEAT or GLFW_RELEASE
+	double x;						// cursor position, or scroll offset
+	double y;
+	std::chrono::steady_clock::time_point time;	// when the event was received
+};
+
+/***********************************************************
+ *  InputQueue
+ *
+ *  This class hands input events from the window callbacks
+ *  to the code that applies them to the camera.  It is a
+ *  fixed ring of events with one writer and one reader that
+ *  only agree through two atomic positions, so neither side
+ *  ever takes a lock or allocates.  An event that arrives
+ *  while the ring is full is dropped and counted.
+ ***********************************************************/
+class InputQueue
+{
+public:
+	// constructor
+	InputQueue();
+
+	// add an event, returns false when the queue is full - only
+	// one thread may add events
+	bool Push(const INPUT_EVENT& event);
+	// take the oldest event, returns false when the queue is
+	// empty - only one thread may take events
+	bool Pop(INPUT_EVENT& event);
+
+	// get the number of events added since the queue was created
+	int GetPushedCount() const;
+	// get the number of events dropped because the queue was full
+	int GetDroppedCount() const;
+
+private:
+	// events the ring holds, a power of two
+	static const unsigned int CAPACITY = 1024;
+
+	// ring of events
+	INPUT_EVENT m_events[CAPACITY];
+	// position of the next event to take, only moved by the reader
+	std::atomic<unsigned int> m_head;
+	// position of the next event to add, only moved by the writer
+	std::atomic<unsigned int> m_tail;
+	// event counters
+	std::atomic<int> m_pushed;
+	std::atomic<int> m_dropped;
+};
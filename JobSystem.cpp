@@ -0,0 +1,303 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.cpp
+// ============
+// work-stealing job scheduler for spreading per-frame CPU work across cores
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// the most worker threads started when no count is given
+	const int g_MaxDefaultWorkers = 15;
+
+	// jobs a queue has room for when the first one is added
+	const int g_InitialQueueSize = 64;
+
+	// queue used by the current thread, workers set their own
+	thread_local int t_QueueIndex = 0;
+}
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JobSystem::JobSystem()
+{
+	m_queuedJobs = 0;
+	m_bStopping = false;
+	m_queues.push_back(std::unique_ptr<JOB_QUEUE>(new JOB_QUEUE()));
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the worker threads.  By
+ *  default there is one worker per core besides the one the
+ *  submitting thread runs on.
+ ***********************************************************/
+void JobSystem::Start(int workerCount)
+{
+	if (m_workers.size() > 0)
+	{
+		return;
+	}
+
+	if (workerCount <= 0)
+	{
+		int cores = (int)std::thread::hardware_concurrency();
+		workerCount = std::min(std::max(cores - 1, 0), g_MaxDefaultWorkers);
+	}
+
+	// every queue exists before any worker can steal from it
+	m_bStopping = false;
+	for (int i = 0; i < workerCount; i++)
+	{
+		m_queues.push_back(std::unique_ptr<JOB_QUEUE>(new JOB_QUEUE()));
+	}
+	for (int i = 0; i < workerCount; i++)
+	{
+		m_workers.push_back(std::thread(&JobSystem::WorkerMain, this, i + 1));
+	}
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the worker threads.
+ *  Every parallel loop has finished before it returns, so
+ *  the queues are already empty.
+ ***********************************************************/
+void JobSystem::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_bStopping = true;
+	}
+	m_wakeWorkers.notify_all();
+
+	for (int i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+	m_queues.resize(1);
+}
+
+/***********************************************************
+ *  GetThreadCount()
+ *
+ *  This method is used for getting the number of threads
+ *  that work on a parallel loop.
+ ***********************************************************/
+int JobSystem::GetThreadCount() const
+{
+	return((int)m_workers.size() + 1);
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method is used for running a function over a number
+ *  of items.  The items are split into ranges that are
+ *  queued for the workers to steal, except for the first
+ *  range which the calling thread runs itself.  The caller
+ *  then helps with the queued ranges until all are done.
+ *  Loops no bigger than one range run straight through on
+ *  the calling thread.
+ ***********************************************************/
+void JobSystem::ParallelFor(int count, int grainSize, const RANGE_FUNCTION& function)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	grainSize = std::max(grainSize, 1);
+	if ((m_workers.size() == 0) || (count <= grainSize))
+	{
+		function(0, count);
+		return;
+	}
+
+	int jobCount = (count + grainSize - 1) / grainSize;
+	std::atomic<int> remaining(jobCount);
+
+	{
+		JOB_QUEUE& queue = *m_queues[t_QueueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		for (int i = 1; i < jobCount; i++)
+		{
+			JOB job;
+			job.pFunction = &function;
+			job.begin = i * grainSize;
+			job.end = std::min(job.begin + grainSize, count);
+			job.pRemaining = &remaining;
+			PushJob(queue, job);
+		}
+	}
+	{
+		// taking the lock keeps a worker from missing the wake up
+		// between checking for jobs and going to sleep
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_queuedJobs += jobCount - 1;
+	}
+	m_wakeWorkers.notify_all();
+
+	JOB first;
+	first.pFunction = &function;
+	first.begin = 0;
+	first.end = std::min(grainSize, count);
+	first.pRemaining = &remaining;
+	RunJob(first);
+
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		JOB job;
+		if ((PopJob(t_QueueIndex, job) == true) || (StealJob(t_QueueIndex, job) == true))
+		{
+			RunJob(job);
+		}
+		else
+		{
+			// the last ranges are running on other threads
+			std::this_thread::yield();
+		}
+	}
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is the body of each worker thread.  It runs
+ *  jobs from its own queue or stolen from the others, and
+ *  sleeps while every queue is empty.
+ ***********************************************************/
+void JobSystem::WorkerMain(int queueIndex)
+{
+	t_QueueIndex = queueIndex;
+
+	while (true)
+	{
+		JOB job;
+		if ((PopJob(queueIndex, job) == true) || (StealJob(queueIndex, job) == true))
+		{
+			RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_wakeWorkers.wait(lock, [this] { return((m_bStopping == true) || (m_queuedJobs > 0)); });
+		if (m_bStopping == true)
+		{
+			return;
+		}
+	}
+}
+
+/***********************************************************
+ *  PopJob()
+ *
+ *  This method is used for taking the most recently queued
+ *  job from a thread's own queue, which is the one most
+ *  likely to still have its data in the cache.
+ ***********************************************************/
+bool JobSystem::PopJob(int queueIndex, JOB& job)
+{
+	JOB_QUEUE& queue = *m_queues[queueIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.count == 0)
+	{
+		return(false);
+	}
+
+	queue.count--;
+	job = queue.jobs[(queue.first + queue.count) % queue.jobs.size()];
+	m_queuedJobs--;
+
+	return(true);
+}
+
+/***********************************************************
+ *  StealJob()
+ *
+ *  This method is used for taking the oldest job from the
+ *  queue of another thread.  The search starts after the
+ *  thief's own queue so the thieves spread out.
+ ***********************************************************/
+bool JobSystem::StealJob(int queueIndex, JOB& job)
+{
+	int queueCount = (int)m_queues.size();
+
+	for (int i = 1; i < queueCount; i++)
+	{
+		JOB_QUEUE& queue = *m_queues[(queueIndex + i) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.count > 0)
+		{
+			job = queue.jobs[queue.first];
+			queue.first = (queue.first + 1) % (int)queue.jobs.size();
+			queue.count--;
+			m_queuedJobs--;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  PushJob()
+ *
+ *  This method is used for adding a job after the newest one
+ *  of a queue.  A full ring is unrolled into one twice its
+ *  size, so once the queue has held the largest loop it
+ *  never allocates again.
+ ***********************************************************/
+void JobSystem::PushJob(JOB_QUEUE& queue, const JOB& job)
+{
+	int capacity = (int)queue.jobs.size();
+	if (queue.count == capacity)
+	{
+		std::vector<JOB> jobs(std::max(capacity * 2, g_InitialQueueSize));
+		for (int i = 0; i < queue.count; i++)
+		{
+			jobs[i] = queue.jobs[(queue.first + i) % capacity];
+		}
+		queue.jobs.swap(jobs);
+		queue.first = 0;
+	}
+
+	queue.jobs[(queue.first + queue.count) % queue.jobs.size()] = job;
+	queue.count++;
+}
+
+/***********************************************************
+ *  RunJob()
+ *
+ *  This method is used for running one range of a parallel
+ *  loop and counting it as done.  The release makes the
+ *  results visible to the thread waiting on the loop.
+ ***********************************************************/
+void JobSystem::RunJob(const JOB& job)
+{
+	(*job.pFunction)(job.begin, job.end);
+	job.pRemaining->fetch_sub(1, std::memory_order_release);
+}
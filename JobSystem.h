@@ -0,0 +1,128 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.h
+// ============
+// work-stealing job scheduler for spreading per-frame CPU work across cores
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class runs ranges of work on a pool of worker
+ *  threads.  Every thread has its own queue of jobs: a
+ *  thread takes the newest job from its own queue, and when
+ *  that is empty steals the oldest job from another thread.
+ *  The thread that splits up a range keeps working on it
+ *  until every part is done, so waiting never idles a core.
+ *
+ *  The jobs must not call OpenGL, which stays on the thread
+ *  that owns the context.  Only one thread other than the
+ *  workers may submit work, normally the rendering thread.
+ *  Submitting a loop never allocates: the function is only
+ *  referenced, since the loop is done before ParallelFor()
+ *  returns, and the queues keep their room between loops.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	// reference to a function working on the items from begin up
+	// to, but not including, end - the function itself is not
+	// copied, so it must outlive the reference
+	class RANGE_FUNCTION
+	{
+	public:
+		template <typename FUNCTION>
+		RANGE_FUNCTION(const FUNCTION& function)
+		{
+			m_pFunction = &function;
+			m_pCall = &Call<FUNCTION>;
+		}
+
+		void operator()(int begin, int end) const
+		{
+			m_pCall(m_pFunction, begin, end);
+		}
+
+	private:
+		const void* m_pFunction;
+		void (*m_pCall)(const void* pFunction, int begin, int end);
+
+		template <typename FUNCTION>
+		static void Call(const void* pFunction, int begin, int end)
+		{
+			(*static_cast<const FUNCTION*>(pFunction))(begin, end);
+		}
+	};
+
+	// constructor
+	JobSystem();
+	// destructor
+	~JobSystem();
+
+	// start the worker threads, 0 picks a count from the CPU
+	void Start(int workerCount = 0);
+	// stop the worker threads, any work must be finished
+	void Stop();
+	// get the number of threads working on a range, including
+	// the thread that submits it
+	int GetThreadCount() const;
+
+	// run a function over count items split into ranges of
+	// grainSize items, returns when every range is done
+	void ParallelFor(int count, int grainSize, const RANGE_FUNCTION& function);
+
+private:
+	// one range of a parallel loop
+	struct JOB
+	{
+		const RANGE_FUNCTION* pFunction;
+		int begin;
+		int end;
+		std::atomic<int>* pRemaining;
+	};
+
+	// the jobs queued by one thread, kept in a ring that only
+	// grows, with the oldest job at first
+	struct JOB_QUEUE
+	{
+		std::mutex mutex;
+		std::vector<JOB> jobs;
+		int first;
+		int count;
+	};
+
+	// worker threads, the submitting thread uses queue 0 and
+	// worker n uses queue n + 1
+	std::vector<std::thread> m_workers;
+	std::vector<std::unique_ptr<JOB_QUEUE>> m_queues;
+	// number of jobs sitting in all of the queues
+	std::atomic<int> m_queuedJobs;
+	// wakes the sleeping workers when jobs are queued
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeWorkers;
+	// set to make the workers exit
+	bool m_bStopping;
+
+	// body of each worker thread
+	void WorkerMain(int queueIndex);
+	// take the newest job from a thread's own queue
+	bool PopJob(int queueIndex, JOB& job);
+	// take the oldest job from any other thread's queue
+	bool StealJob(int queueIndex, JOB& job);
+	// add a job after the newest one of a queue, the queue must
+	// be locked
+	static void PushJob(JOB_QUEUE& queue, const JOB& job);
+	// run a job and count it as done
+	static void RunJob(const JOB& job);
+};
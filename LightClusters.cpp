@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.cpp
+// ============
+// assign the scene point lights to view-space clusters with a compute pass
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightClusters.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables
+namespace
+{
+	// clusters in the whole grid
+	const int g_ClusterCount = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+	// clusters assigned by one work group - this must match the
+	// light cluster shader
+	const int g_ClustersPerGroup = 128;
+	// lights the light buffer has room for when first created
+	const int g_InitialLightCapacity = 16;
+}
+
+/***********************************************************
+ *  LightClusters()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightClusters::LightClusters()
+{
+	m_viewLocation = -1;
+	m_projectionLocation = -1;
+	m_depthRangeLocation = -1;
+	m_lightCountLocation = -1;
+	m_lightBuffer = 0;
+	m_lightCapacity = 0;
+	m_lightCount = 0;
+	m_clusterCountBuffer = 0;
+	m_clusterIndexBuffer = 0;
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_bLightsDirty = true;
+	m_clusterMapping = glm::vec4(0.0f);
+}
+
+/***********************************************************
+ *  ~LightClusters()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightClusters::~LightClusters()
+{
+	if (m_lightBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_lightBuffer);
+		glDeleteBuffers(1, &m_clusterCountBuffer);
+		glDeleteBuffers(1, &m_clusterIndexBuffer);
+		m_lightBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for building the compute pass and
+ *  creating the light and cluster buffers.  The buffers are
+ *  attached to their binding points once, since nothing
+ *  else uses those points.  Every cluster starts out empty.
+ ***********************************************************/
+bool LightClusters::Create(const char* computeShaderFilename)
+{
+	if (m_clusterProgram.LoadCompute(computeShaderFilename) == false)
+	{
+		return(false);
+	}
+
+	m_viewLocation = m_clusterProgram.GetUniformLocation("view");
+	m_projectionLocation = m_clusterProgram.GetUniformLocation("projection");
+	m_depthRangeLocation = m_clusterProgram.GetUniformLocation("depthRange");
+	m_lightCountLocation = m_clusterProgram.GetUniformLocation("lightCount");
+
+	std::vector<GLuint> emptyCounts(g_ClusterCount, 0);
+
+	glGenBuffers(1, &m_lightBuffer);
+	glGenBuffers(1, &m_clusterCountBuffer);
+	glGenBuffers(1, &m_clusterIndexBuffer);
+
+	m_lightCapacity = g_InitialLightCapacity;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(POINT_LIGHT) * m_lightCapacity, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_clusterCountBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint) * g_ClusterCount, emptyCounts.data(), GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_clusterIndexBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GLuint) * g_ClusterCount * MAX_LIGHTS_PER_CLUSTER, NULL, GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BUFFER_BINDING, m_lightBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_COUNT_BINDING, m_clusterCountBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_INDEX_BINDING, m_clusterIndexBuffer);
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for replacing the lights in the light
+ *  buffer.  The buffer only grows, so changing the lights of
+ *  a scene never reallocates it.
+ ***********************************************************/
+void LightClusters::SetLights(const std::vector<POINT_LIGHT>& lights)
+{
+	if (m_lightBuffer == 0)
+	{
+		return;
+	}
+
+	m_lightCount = (int)lights.size();
+	m_bLightsDirty = true;
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightBuffer);
+	if (m_lightCount > m_lightCapacity)
+	{
+		m_lightCapacity = m_lightCount * 2;
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(POINT_LIGHT) * m_lightCapacity, NULL, GL_DYNAMIC_DRAW);
+		// the binding point keeps the buffer object, not its storage
+	}
+	if (m_lightCount > 0)
+	{
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(POINT_LIGHT) * m_lightCount, lights.data());
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used for getting the number of lights in
+ *  the light buffer.
+ ***********************************************************/
+int LightClusters::GetLightCount() const
+{
+	return(m_lightCount);
+}
+
+/***********************************************************
+ *  ReloadShaders()
+ *
+ *  This method is used for building the compute pass again
+ *  after its shader file was edited.  The current pass keeps
+ *  running until the new one is ready.
+ ***********************************************************/
+void LightClusters::ReloadShaders(const char* filename)
+{
+	if (m_clusterProgram.UsesFile(filename) == true)
+	{
+		m_clusterProgram.BeginReload();
+	}
+}
+
+/***********************************************************
+ *  SwapReloadedShaders()
+ *
+ *  This method is used for switching to the rebuilt compute
+ *  pass once it has built.  Its uniforms are looked up again,
+ *  and the lights are assigned to the clusters again by the
+ *  next update.
+ ***********************************************************/
+bool LightClusters::SwapReloadedShaders()
+{
+	if (m_clusterProgram.UpdatePendingLoad() == false)
+	{
+		return(false);
+	}
+
+	m_viewLocation = m_clusterProgram.GetUniformLocation("view");
+	m_projectionLocation = m_clusterProgram.GetUniformLocation("projection");
+	m_depthRangeLocation = m_clusterProgram.GetUniformLocation("depthRange");
+	m_lightCountLocation = m_clusterProgram.GetUniformLocation("lightCount");
+	m_bLightsDirty = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for running the compute pass that
+ *  assigns the lights to the clusters of a view.  The near
+ *  and far planes are taken from the projection matrix, so
+ *  perspective and orthographic views both work.  Nothing
+ *  runs when the lights and view are unchanged.
+ *  Returns true when the pass ran, which leaves the compute
+ *  program current.
+ ***********************************************************/
+bool LightClusters::Update(const glm::mat4& view, const glm::mat4& projection)
+{
+	if (m_clusterProgram.IsLoaded() == false)
+	{
+		return(false);
+	}
+
+	if ((m_bLightsDirty == false) && (view == m_view) && (projection == m_projection))
+	{
+		return(false);
+	}
+	m_view = view;
+	m_projection = projection;
+	m_bLightsDirty = false;
+
+	// view depths where the projected depth is -1 and +1
+	float nearPlane = (projection[3][2] + projection[3][3]) / (projection[2][2] + projection[2][3]);
+	float farPlane = (projection[3][2] - projection[3][3]) / (projection[2][2] - projection[2][3]);
+	nearPlane = std::max(nearPlane, 0.0001f);
+	farPlane = std::max(farPlane, nearPlane * 1.001f);
+
+	// a fragment's depth slice is log(depth) * scale - bias
+	float logDepthRange = std::log(farPlane / nearPlane);
+	m_clusterMapping = glm::vec4(
+		CLUSTER_GRID_Z / logDepthRange,
+		CLUSTER_GRID_Z * std::log(nearPlane) / logDepthRange,
+		0.0f, 0.0f);
+
+	glUseProgram(m_clusterProgram.GetProgram());
+	glUniformMatrix4fv(m_viewLocation, 1, GL_FALSE, glm::value_ptr(view));
+	glUniformMatrix4fv(m_projectionLocation, 1, GL_FALSE, glm::value_ptr(projection));
+	glUniform2f(m_depthRangeLocation, nearPlane, farPlane);
+	glUniform1i(m_lightCountLocation, m_lightCount);
+	glDispatchCompute((g_ClusterCount + g_ClustersPerGroup - 1) / g_ClustersPerGroup, 1, 1);
+
+	// the fragment shader reads what the pass wrote
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetClusterMapping()
+ *
+ *  This method is used for getting the values the fragment
+ *  shader finds the depth slice of a fragment with, from its
+ *  view depth.
+ ***********************************************************/
+glm::vec4 LightClusters::GetClusterMapping() const
+{
+	return(m_clusterMapping);
+}
+
+/***********************************************************
+ *  GetView()
+ *
+ *  This method is used for getting the view the lights were
+ *  last assigned to the clusters with.  The fragment shader
+ *  finds the cluster of a fragment with it, rather than with
+ *  the view the frame is drawn with.
+ ***********************************************************/
+glm::mat4 LightClusters::GetView() const
+{
+	return(m_view);
+}
+
+/***********************************************************
+ *  GetProjection()
+ *
+ *  This method is used for getting the projection the lights
+ *  were last assigned to the clusters with.
+ ***********************************************************/
+glm::mat4 LightClusters::GetProjection() const
+{
+	return(m_projection);
+}
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.h
+// ============
+// assign the scene point lights to view-space clusters with a compute pass
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderProgram.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// shader storage binding points of the light buffers - these
+// must match the light cluster and fragment shaders
+const GLuint LIGHT_BUFFER_BINDING = 2;
+const GLuint CLUSTER_COUNT_BINDING = 3;
+const GLuint CLUSTER_INDEX_BINDING = 4;
+
+// size of the cluster grid across the screen and in depth, and
+// the most lights one cluster can hold - these must match the
+// defines in the light cluster and fragment shaders
+const int CLUSTER_GRID_X = 16;
+const int CLUSTER_GRID_Y = 9;
+const int CLUSTER_GRID_Z = 24;
+const int MAX_LIGHTS_PER_CLUSTER = 128;
+
+// std430 layout of one point light in the light buffer
+struct POINT_LIGHT
+{
+	glm::vec4 position;				// xyz = position, w = radius, 0 lights everything
+	glm::vec4 ambient;
+	glm::vec4 diffuse;
+	glm::vec4 specular;
+	glm::vec4 shadow;				// x = shadow map index, -1 for none, y = reach of the shadows
+};
+
+/***********************************************************
+ *  LightClusters
+ *
+ *  This class keeps the scene point lights in a shader
+ *  storage buffer and splits the view frustum into a grid of
+ *  clusters - tiles of the screen sliced exponentially in
+ *  depth.  A compute pass tests every light against every
+ *  cluster box and writes the indices of the lights reaching
+ *  each cluster, so the fragment shader only lights a
+ *  fragment with the lights of its own cluster.  The pass
+ *  only runs again when the lights or the view change.
+ ***********************************************************/
+class LightClusters
+{
+public:
+	// constructor
+	LightClusters();
+	// destructor
+	~LightClusters();
+
+	// build the compute pass and create the cluster buffers,
+	// returns false when the compute shader fails to build
+	bool Create(const char* computeShaderFilename);
+	// replace the lights in the light buffer
+	void SetLights(const std::vector<POINT_LIGHT>& lights);
+	// get the number of lights in the light buffer
+	int GetLightCount() const;
+	// start building the compute pass again when it is built
+	// from a changed file
+	void ReloadShaders(const char* filename);
+	// swap in the rebuilt compute pass once it is ready, returns
+	// true when it took over
+	bool SwapReloadedShaders();
+
+	// assign the lights to the clusters of a view, the scene
+	// program must be made current again afterwards
+	bool Update(const glm::mat4& view, const glm::mat4& projection);
+	// get the values the fragment shader maps a fragment to its
+	// depth slice with: x = depth slice scale, y = depth slice bias
+	glm::vec4 GetClusterMapping() const;
+	// get the view and projection the lights were last assigned
+	// to the clusters with
+	glm::mat4 GetView() const;
+	glm::mat4 GetProjection() const;
+
+private:
+	// compute pass assigning the lights to the clusters
+	ShaderProgram m_clusterProgram;
+	GLint m_viewLocation;
+	GLint m_projectionLocation;
+	GLint m_depthRangeLocation;
+	GLint m_lightCountLocation;
+	// light buffer and the capacity it was created with
+	GLuint m_lightBuffer;
+	int m_lightCapacity;
+	int m_lightCount;
+	// number of lights reaching each cluster and their indices
+	GLuint m_clusterCountBuffer;
+	GLuint m_clusterIndexBuffer;
+	// view the clusters were last assigned for, and whether the
+	// lights have changed since
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	bool m_bLightsDirty;
+	// mapping from a fragment to its cluster
+	glm::vec4 m_clusterMapping;
+};
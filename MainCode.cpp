@@ -1,186 +1,546 @@
-///////////////////////////////////////////////////////////////////////////////
-// maincode.cpp
-// ============
-// gets called when application is launched - initializes GLEW, GLFW
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"shaders/vertexShader.glsl",
-		"shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
+///////////////////////////////////////////////////////////////////////////////
+// maincode.cpp
+// ============
+// gets called when application is launched - initializes GLEW, GLFW
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <chrono>           // benchmark frame timing
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "AllocationTracker.h"
+#include "SceneFile.h"
+#include "ShaderCache.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// profiler object for timing the frame loop on the CPU and GPU
+	Profiler* g_Profiler = nullptr;
+	// job system object for spreading the scene update across cores
+	JobSystem* g_JobSystem = nullptr;
+
+	// shader files of the scene program - the instanced shaders
+	// read the model matrix, color and material of every object
+	// from the instance buffer
+	const char* const SCENE_VERTEX_SHADER = "shaders/instancedVertexShader.glsl";
+	const char* const SCENE_FRAGMENT_SHADER = "shaders/instancedFragmentShader.glsl";
+
+	// file the profile statistics are written to on exit
+	const char* const PROFILE_CSV_FILENAME = "profile.csv";
+
+	// settings read from the command line
+	BENCHMARK_SETTINGS g_Settings;
+	// size of the transform benchmark
+	const int TRANSFORM_BENCHMARK_OBJECTS = 10000;
+	const int TRANSFORM_BENCHMARK_ITERATIONS = 200;
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW(bool bHeadless);
+bool InitializeGLEW();
+void RenderFrame();
+void RunInteractive();
+bool RunBenchmark();
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	// with no arguments the scene is shown in a window as usual
+	if (Benchmark::ParseCommandLine(argc, argv, g_Settings) == false)
+	{
+		Benchmark::PrintUsage(argv[0]);
+		return(EXIT_FAILURE);
+	}
+
+	// the transform benchmark runs on the CPU only
+	if (g_Settings.bTransformBenchmark == true)
+	{
+		Benchmark::RunTransformBenchmark(TRANSFORM_BENCHMARK_OBJECTS, TRANSFORM_BENCHMARK_ITERATIONS);
+		return(EXIT_SUCCESS);
+	}
+
+	// scene files are compiled on the CPU only
+	if (g_Settings.compileFilename.empty() == false)
+	{
+		std::string binaryFilename = SceneFile::GetBinaryPath(g_Settings.compileFilename.c_str());
+		if (SceneFile::Compile(g_Settings.compileFilename.c_str(), binaryFilename.c_str()) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		std::cout << "INFO: Scene compiled to " << binaryFilename << std::endl;
+		return(EXIT_SUCCESS);
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	if (InitializeGLFW(g_Settings.bHeadless) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager);
+
+	// try to create the main display window, or a hidden one
+	// that only provides the OpenGL context when headless
+	if (g_Settings.bHeadless == true)
+	{
+		g_Window = g_ViewManager->CreateOffscreenWindow(WINDOW_TITLE);
+	}
+	else
+	{
+		g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	}
+	if (NULL == g_Window)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// headless frames are rendered into a framebuffer object
+	if ((g_Settings.bHeadless == true) &&
+		(g_ViewManager->CreateOffscreenTarget() == false))
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// compiling every shader from source can be forced for timing
+	// a cold start
+	if (g_Settings.bNoShaderCache == true)
+	{
+		ShaderCache::SetEnabled(false);
+	}
+
+	// try to create a new profiler object - it needs the OpenGL
+	// context for its timer queries
+	g_Profiler = new Profiler();
+
+	// try to create a new job system object with a worker per core
+	g_JobSystem = new JobSystem();
+	g_JobSystem->Start();
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager->SetProfiler(g_Profiler);
+	g_SceneManager->SetJobSystem(g_JobSystem);
+	if (g_Settings.sceneFilename.empty() == false)
+	{
+		g_SceneManager->SetSceneFile(g_Settings.sceneFilename.c_str());
+	}
+	// load the shader code from the external GLSL files, or the
+	// program binary the driver built from them on an earlier run
+	{
+		ProfileScope scope(g_Profiler, "LoadShaders");
+		if (g_SceneManager->LoadSceneShaders(SCENE_VERTEX_SHADER, SCENE_FRAGMENT_SHADER) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+	}
+	{
+		ProfileScope scope(g_Profiler, "PrepareScene");
+		g_SceneManager->PrepareScene();
+	}
+
+	// report how many programs skipped compiling
+	const SHADER_CACHE_STATS& shaderCacheStats = ShaderCache::GetStats();
+	std::cout << "INFO: Shader cache: " << shaderCacheStats.hits << " programs loaded from binaries, "
+		<< shaderCacheStats.misses << " compiled from source, rejected: " << shaderCacheStats.rejected << std::endl;
+
+	// small colored point lights for stressing the clustered lighting
+	for (int i = 0; i < g_Settings.extraLights; i++)
+	{
+		glm::vec3 position;
+		glm::vec3 color;
+		float radius = 0.0f;
+		Benchmark::GetExtraLight(i, position, radius, color);
+		g_SceneManager->AddPointLight(position, radius, color * 0.05f, color, color * 0.5f);
+	}
+
+	// loop until the window is closed, or until the benchmark
+	// camera path has been rendered
+	bool bPassed = true;
+	if (g_Settings.bHeadless == true)
+	{
+		bPassed = RunBenchmark();
+	}
+	else
+	{
+		RunInteractive();
+	}
+
+	// report where the frame time went and export it for comparison
+	if (NULL != g_Profiler)
+	{
+		g_Profiler->PrintReport();
+		g_Profiler->WriteCSV(PROFILE_CSV_FILENAME);
+	}
+
+	// report how much of the input only reached the camera through
+	// the late latch
+	const INPUT_STATS& inputStats = g_ViewManager->GetInputStats();
+	std::cout << "INFO: Input events applied: " << inputStats.eventsApplied
+		<< ", by the late latch: " << inputStats.lateEvents
+		<< ", dropped: " << inputStats.eventsDropped << std::endl;
+
+	// report how many uniform uploads were skipped as redundant
+	UNIFORM_UPLOAD_STATS uniformStats = g_SceneManager->GetUniformStats();
+	std::cout << "INFO: Uniform uploads issued: " << uniformStats.uploadsIssued
+		<< ", skipped: " << uniformStats.uploadsSkipped << std::endl;
+
+	// report how much of the scene the last frame culled
+	std::cout << "INFO: Culling tested: " << g_SceneManager->GetCullStats().objectsTested
+		<< " objects, " << g_SceneManager->GetCullStats().nodesTested
+		<< " nodes, culled: " << g_SceneManager->GetCullStats().objectsCulled
+		<< ", drawn: " << g_SceneManager->GetCullStats().objectsDrawn << std::endl;
+
+	// report how many state changes the sorted draw order saved
+	const RENDER_STATS& renderStats = g_SceneManager->GetRenderStats();
+	std::cout << "INFO: Render queue: " << renderStats.objects << " objects in "
+		<< renderStats.draws << " draws, " << renderStats.submissions << " calls, "
+		<< renderStats.triangles << " triangles"
+		<< ", state changes sorted/recorded - shaders: " << renderStats.sorted.shaders
+		<< "/" << renderStats.recorded.shaders
+		<< ", textures: " << renderStats.sorted.textures << "/" << renderStats.recorded.textures
+		<< ", materials: " << renderStats.sorted.materials << "/" << renderStats.recorded.materials
+		<< ", meshes: " << renderStats.sorted.meshes << "/" << renderStats.recorded.meshes << std::endl;
+
+	// report how often the CPU had to wait for the GPU to release frame data
+	const RING_BUFFER_STATS& frameBufferStats = g_SceneManager->GetFrameBufferStats();
+	std::cout << "INFO: Frame buffer sections used: " << frameBufferStats.sectionsUsed
+		<< ", fence waits: " << frameBufferStats.blockedWaits
+		<< ", waited: " << frameBufferStats.waitMilliseconds << " ms" << std::endl;
+
+	// report how often the cached shadow maps had to be rendered again
+	const SHADOW_STATS& shadowStats = g_SceneManager->GetShadowStats();
+	std::cout << "INFO: Shadow maps rendered: " << shadowStats.staticRenders
+		<< ", overlays: " << shadowStats.overlayRenders
+		<< ", casters drawn: " << shadowStats.castersDrawn << std::endl;
+
+	// report how much frame scratch memory was needed
+	const FRAME_ARENA_STATS& arenaStats = g_SceneManager->GetFrameArenaStats();
+	std::cout << "INFO: Frame arena peak: " << arenaStats.peakBytes << " of " << arenaStats.capacity
+		<< " bytes, grown: " << arenaStats.overflows << " times" << std::endl;
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_JobSystem)
+	{
+		delete g_JobSystem;
+		g_JobSystem = NULL;
+	}
+	if (NULL != g_Profiler)
+	{
+		delete g_Profiler;
+		g_Profiler = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+
+	// a benchmark that found allocations in its frames fails
+	if (bPassed == false)
+	{
+		exit(EXIT_FAILURE);
+	}
+
+	// Terminates the program successfully
+	exit(EXIT_SUCCESS); 
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to render one frame of the scene
+ *  into the current framebuffer.
+ ***********************************************************/
+void RenderFrame()
+{
+	// Enable z-depth
+	glEnable(GL_DEPTH_TEST);
+
+	// Clear the frame and z buffers
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// convert from 3D object space to 2D view
+	{
+		ProfileScope scope(g_Profiler, "PrepareSceneView");
+		g_ViewManager->PrepareSceneView();
+	}
+
+	// objects outside of the camera view are culled before drawing
+	g_SceneManager->SetViewProjection(
+		g_ViewManager->GetViewMatrix(),
+		g_ViewManager->GetProjectionMatrix(),
+		g_ViewManager->GetViewportSize());
+
+	// refresh the 3D scene - the camera is moved again by the
+	// newest input right before the scene draws are issued
+	{
+		ProfileScope scope(g_Profiler, "RenderScene");
+		g_SceneManager->UpdateScene();
+		{
+			ProfileScope latchScope(g_Profiler, "Late latch", false);
+			g_ViewManager->LatchSceneView();
+		}
+		g_SceneManager->DrawScene();
+	}
+	g_ViewManager->FinishSceneView();
+
+	// the input latency is measured from the oldest input the
+	// frame shows
+	std::chrono::steady_clock::time_point inputTime;
+	if ((NULL != g_Profiler) && (g_ViewManager->GetInputTime(inputTime) == true))
+	{
+		g_Profiler->SetInputTime(inputTime);
+	}
+}
+
+/***********************************************************
+ *	RunInteractive()
+ *
+ *  This function is used to render frames to the display
+ *  window until the application is closed.  Scene and shader
+ *  files edited in the meantime are picked up before each
+ *  frame.
+ ***********************************************************/
+void RunInteractive()
+{
+	// the scene file and shaders can be edited while the scene
+	// is shown, and are picked up without restarting
+	g_SceneManager->EnableHotReload();
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!glfwWindowShouldClose(g_Window))
+	{
+		// the whole frame is timed as the "Frame" scope
+		g_Profiler->BeginFrame();
+
+		{
+			ProfileScope scope(g_Profiler, "Hot reload", false);
+			g_SceneManager->ReloadChangedFiles();
+		}
+		RenderFrame();
+
+		// Flips the the back buffer with the front buffer every frame.
+		{
+			ProfileScope scope(g_Profiler, "SwapBuffers", false);
+			glfwSwapBuffers(g_Window);
+		}
+
+		// query the latest GLFW events
+		glfwPollEvents();
+
+		g_Profiler->EndFrame();
+	}
+}
+
+/***********************************************************
+ *	RunBenchmark()
+ *
+ *  This function is used to render the benchmark camera path
+ *  offscreen and report the frame times.  Warmup frames run
+ *  until every texture has streamed in, so each measured
+ *  frame draws the same pixels on every run.  Each frame
+ *  waits for the GPU to finish, since there is no buffer
+ *  swap to pace the frames.  The heap allocations of the
+ *  measured frames are counted, and when they are checked
+ *  any allocation fails the run, returning false.
+ ***********************************************************/
+bool RunBenchmark()
+{
+	Benchmark benchmark;
+	glm::vec3 position;
+	glm::vec3 front;
+
+	int warmupFrames = 0;
+	while ((warmupFrames < g_Settings.warmupFrames) ||
+		(g_SceneManager->GetPendingTextureCount() > 0))
+	{
+		g_Profiler->BeginFrame();
+
+		Benchmark::GetCameraPose(0, position, front);
+		g_ViewManager->SetCameraPose(position, front);
+		RenderFrame();
+
+		{
+			ProfileScope scope(g_Profiler, "Finish", false);
+			glFinish();
+		}
+
+		g_Profiler->EndFrame();
+		warmupFrames++;
+	}
+
+	for (int frame = 0; frame < g_Settings.frames; frame++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		g_Profiler->BeginFrame();
+
+		Benchmark::GetCameraPose(frame, position, front);
+		g_ViewManager->SetCameraPose(position, front);
+
+		// everything from preparing the view up to the end of the
+		// frame must run without touching the heap
+		AllocationTracker::Begin();
+		RenderFrame();
+
+		{
+			ProfileScope scope(g_Profiler, "Finish", false);
+			glFinish();
+		}
+		AllocationTracker::End();
+
+		g_Profiler->EndFrame();
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		benchmark.AddFrameTime(elapsed.count());
+	}
+
+	BENCHMARK_STATS stats;
+	benchmark.ComputeStats(stats);
+	std::cout << "INFO: Benchmark rendered " << stats.frames << " frames after "
+		<< warmupFrames << " warmup frames on " << glGetString(GL_RENDERER) << std::endl;
+	std::cout << "INFO: Frame time ms - mean: " << stats.mean
+		<< ", p50: " << stats.p50
+		<< ", p95: " << stats.p95
+		<< ", p99: " << stats.p99
+		<< ", max: " << stats.maximum << std::endl;
+
+	ALLOCATION_STATS allocations = AllocationTracker::GetStats();
+	std::cout << "INFO: Frame allocations: " << allocations.allocations
+		<< " (" << allocations.bytes << " bytes) over " << stats.frames << " frames" << std::endl;
+
+	benchmark.WriteJSON(g_Settings.statsFilename.c_str(), warmupFrames, allocations.allocations);
+
+	if ((g_Settings.bCheckAllocations == true) && (allocations.allocations > 0))
+	{
+		std::cout << "ERROR: The measured frames allocated heap memory" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.
+ *  Headless runs use the GLFW null platform where it is
+ *  available, so no display server is needed.  The renderer
+ *  needs OpenGL 4.3 or newer, which macOS does not provide.
+ ***********************************************************/
+bool InitializeGLFW(bool bHeadless)
+{
+#ifdef __APPLE__
+	// macOS stops at OpenGL 4.1, without the shader storage buffers,
+	// multi-draw indirect and compute shaders the renderer is built on
+	std::cout << "ERROR: macOS is not supported, the renderer needs OpenGL 4.3 or newer" << std::endl;
+	return(false);
+#endif
+
+	// GLFW: initialize and configure library
+	// --------------------------------------
+#ifdef GLFW_PLATFORM_NULL
+	if (bHeadless == true)
+	{
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+	}
+#endif
+	if (glfwInit() == GLFW_FALSE)
+	{
+		std::cout << "Failed to initialize GLFW" << std::endl;
+		return(false);
+	}
+
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW()
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
 }
\ No newline at end of file
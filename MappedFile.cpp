@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+// mappedfile.cpp
+// ============
+// read-only memory mapping of a whole file
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/***********************************************************
+ *  MappedFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MappedFile::MappedFile()
+{
+	m_pData = NULL;
+	m_size = 0;
+#ifdef _WIN32
+	m_fileHandle = NULL;
+	m_mappingHandle = NULL;
+#endif
+}
+
+/***********************************************************
+ *  ~MappedFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for mapping a whole file into memory
+ *  for reading.  Empty files are treated as an error, since
+ *  they cannot be mapped.
+ ***********************************************************/
+bool MappedFile::Open(const char* filename)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return(false);
+	}
+
+	LARGE_INTEGER fileSize;
+	if ((GetFileSizeEx(file, &fileSize) == FALSE) || (fileSize.QuadPart == 0))
+	{
+		CloseHandle(file);
+		return(false);
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return(false);
+	}
+
+	void* pData = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (pData == NULL)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return(false);
+	}
+
+	m_fileHandle = file;
+	m_mappingHandle = mapping;
+	m_pData = (const unsigned char*)pData;
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	int file = open(filename, O_RDONLY);
+	if (file < 0)
+	{
+		return(false);
+	}
+
+	struct stat fileInfo;
+	if ((fstat(file, &fileInfo) != 0) || (fileInfo.st_size == 0))
+	{
+		close(file);
+		return(false);
+	}
+
+	void* pData = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	// the mapping stays valid after the file is closed
+	close(file);
+	if (pData == MAP_FAILED)
+	{
+		return(false);
+	}
+
+	m_pData = (const unsigned char*)pData;
+	m_size = (size_t)fileInfo.st_size;
+#endif
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the file.
+ ***********************************************************/
+void MappedFile::Close()
+{
+	if (m_pData == NULL)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_pData);
+	CloseHandle((HANDLE)m_mappingHandle);
+	CloseHandle((HANDLE)m_fileHandle);
+	m_fileHandle = NULL;
+	m_mappingHandle = NULL;
+#else
+	munmap((void*)m_pData, m_size);
+#endif
+
+	m_pData = NULL;
+	m_size = 0;
+}
+
+/***********************************************************
+ *  GetData()
+ *
+ *  This method is used for getting the mapped file contents.
+ ***********************************************************/
+const unsigned char* MappedFile::GetData() const
+{
+	return(m_pData);
+}
+
+/***********************************************************
+ *  GetSize()
+ *
+ *  This method is used for getting the size of the mapped
+ *  file in bytes.
+ ***********************************************************/
+size_t MappedFile::GetSize() const
+{
+	return(m_size);
+}
@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////////////////
+// mappedfile.h
+// ============
+// read-only memory mapping of a whole file
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+
+/***********************************************************
+ *  MappedFile
+ *
+ *  This class maps a whole file into memory for reading, so
+ *  the file contents can be used in place without copying
+ *  them into an allocated buffer first.
+ ***********************************************************/
+class MappedFile
+{
+public:
+	// constructor
+	MappedFile();
+	// destructor
+	~MappedFile();
+
+	// map the passed in file, returns false if it cannot be mapped
+	bool Open(const char* filename);
+	// unmap the file
+	void Close();
+
+	// get the mapped file contents and their size
+	const unsigned char* GetData() const;
+	size_t GetSize() const;
+
+private:
+	// first byte of the mapped file
+	const unsigned char* m_pData;
+	// size of the mapped file in bytes
+	size_t m_size;
+#ifdef _WIN32
+	// file and mapping handles
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#endif
+};
@@ -0,0 +1,667 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshlibrary.cpp
+// ============
+// generate the basic 3D shape meshes and draw them with hardware instancing
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshLibrary.h"
+
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	const float g_PI = 3.14159265358979f;
+
+	// number of floats per vertex - position, normal, texture coordinate
+	const int g_FloatsPerVertex = 8;
+
+	// tessellation of the curved shapes at each level of detail
+	const int g_CurveSlices[MESH_LOD_COUNT] = { 36, 16, 8 };
+	const int g_SphereStacks[MESH_LOD_COUNT] = { 18, 8, 4 };
+	const int g_TorusTubeSlices[MESH_LOD_COUNT] = { 18, 8, 4 };
+	const float g_TorusTubeRadius = 0.2f;
+}
+
+/***********************************************************
+ *  MeshLibrary()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshLibrary::MeshLibrary()
+{
+	for (int i = 0; i < MESH_COUNT; i++)
+	{
+		for (int lod = 0; lod < MESH_LOD_COUNT; lod++)
+		{
+			m_meshes[i][lod].firstIndex = 0;
+			m_meshes[i][lod].indexCount = 0;
+			m_meshes[i][lod].baseVertex = 0;
+			m_meshes[i][lod].boundsMin = glm::vec3(0.0f);
+			m_meshes[i][lod].boundsMax = glm::vec3(0.0f);
+		}
+	}
+	m_vao = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_storageAlignment = 256;
+	m_instanceOffset = 0;
+	m_instanceSize = 0;
+	m_commandOffset = 0;
+}
+
+/***********************************************************
+ *  ~MeshLibrary()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshLibrary::~MeshLibrary()
+{
+	if (m_vao != 0)
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		glDeleteBuffers(1, &m_vertexBuffer);
+		glDeleteBuffers(1, &m_indexBuffer);
+	}
+}
+
+/***********************************************************
+ *  LoadMeshes()
+ *
+ *  This method is used for generating all of the basic shape
+ *  meshes into the shared vertex and index buffers.  The
+ *  curved shapes are generated once per level of detail,
+ *  while every level of the flat shapes shares one mesh.
+ ***********************************************************/
+void MeshLibrary::LoadMeshes()
+{
+	std::vector<GLfloat> vertices;
+	std::vector<GLuint> indices;
+	std::vector<GLfloat> sharedVertices;
+	std::vector<GLuint> sharedIndices;
+
+	BuildPlane(vertices, indices);
+	AppendMesh(m_meshes[MESH_PLANE][0], vertices, indices, sharedVertices, sharedIndices);
+
+	BuildBox(vertices, indices);
+	AppendMesh(m_meshes[MESH_BOX][0], vertices, indices, sharedVertices, sharedIndices);
+
+	for (int lod = 1; lod < MESH_LOD_COUNT; lod++)
+	{
+		m_meshes[MESH_PLANE][lod] = m_meshes[MESH_PLANE][0];
+		m_meshes[MESH_BOX][lod] = m_meshes[MESH_BOX][0];
+	}
+
+	for (int lod = 0; lod < MESH_LOD_COUNT; lod++)
+	{
+		BuildCylinder(vertices, indices, lod);
+		AppendMesh(m_meshes[MESH_CYLINDER][lod], vertices, indices, sharedVertices, sharedIndices);
+
+		BuildCone(vertices, indices, lod);
+		AppendMesh(m_meshes[MESH_CONE][lod], vertices, indices, sharedVertices, sharedIndices);
+
+		BuildSphere(vertices, indices, lod);
+		AppendMesh(m_meshes[MESH_SPHERE][lod], vertices, indices, sharedVertices, sharedIndices);
+
+		BuildTorus(vertices, indices, lod);
+		AppendMesh(m_meshes[MESH_TORUS][lod], vertices, indices, sharedVertices, sharedIndices);
+	}
+
+	CreateBuffers(sharedVertices, sharedIndices);
+
+	// the frame buffer is created by the first upload, once its
+	// size is known
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &m_storageAlignment);
+}
+
+/***********************************************************
+ *  AddVertex()
+ *
+ *  This method is used for appending one interleaved vertex
+ *  to the vertex data.
+ ***********************************************************/
+void MeshLibrary::AddVertex(
+	std::vector<GLfloat>& vertices,
+	glm::vec3 position,
+	glm::vec3 normal,
+	glm::vec2 uv)
+{
+	vertices.push_back(position.x);
+	vertices.push_back(position.y);
+	vertices.push_back(position.z);
+	vertices.push_back(normal.x);
+	vertices.push_back(normal.y);
+	vertices.push_back(normal.z);
+	vertices.push_back(uv.x);
+	vertices.push_back(uv.y);
+}
+
+/***********************************************************
+ *  BuildPlane()
+ *
+ *  This method is used for generating a flat plane from -1
+ *  to 1 on the X and Z axes, facing up the Y axis.
+ ***********************************************************/
+void MeshLibrary::BuildPlane(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	glm::vec3 normal(0.0f, 1.0f, 0.0f);
+	AddVertex(vertices, glm::vec3(-1.0f, 0.0f, -1.0f), normal, glm::vec2(0.0f, 1.0f));
+	AddVertex(vertices, glm::vec3(-1.0f, 0.0f, 1.0f), normal, glm::vec2(0.0f, 0.0f));
+	AddVertex(vertices, glm::vec3(1.0f, 0.0f, 1.0f), normal, glm::vec2(1.0f, 0.0f));
+	AddVertex(vertices, glm::vec3(1.0f, 0.0f, -1.0f), normal, glm::vec2(1.0f, 1.0f));
+
+	GLuint planeIndices[] = { 0, 1, 2, 0, 2, 3 };
+	indices.assign(planeIndices, planeIndices + 6);
+}
+
+/***********************************************************
+ *  BuildBox()
+ *
+ *  This method is used for generating a unit box centered
+ *  on the origin, with separate vertices for every face so
+ *  the normals and texture coordinates stay flat.
+ ***********************************************************/
+void MeshLibrary::BuildBox(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	// normal, then the two axes spanning each face
+	const glm::vec3 faces[6][3] =
+	{
+		{ glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f) },
+		{ glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) }
+	};
+
+	for (int face = 0; face < 6; face++)
+	{
+		glm::vec3 normal = faces[face][0];
+		glm::vec3 right = faces[face][1] * 0.5f;
+		glm::vec3 up = faces[face][2] * 0.5f;
+		glm::vec3 center = normal * 0.5f;
+		GLuint first = (GLuint)(vertices.size() / g_FloatsPerVertex);
+
+		AddVertex(vertices, center - right - up, normal, glm::vec2(0.0f, 0.0f));
+		AddVertex(vertices, center + right - up, normal, glm::vec2(1.0f, 0.0f));
+		AddVertex(vertices, center + right + up, normal, glm::vec2(1.0f, 1.0f));
+		AddVertex(vertices, center - right + up, normal, glm::vec2(0.0f, 1.0f));
+
+		indices.push_back(first);
+		indices.push_back(first + 1);
+		indices.push_back(first + 2);
+		indices.push_back(first);
+		indices.push_back(first + 2);
+		indices.push_back(first + 3);
+	}
+}
+
+/***********************************************************
+ *  BuildCylinder()
+ *
+ *  This method is used for generating a cylinder with a
+ *  radius of 1 that rises from 0 to 1 on the Y axis, with
+ *  the top and bottom closed, at a tessellation level.
+ ***********************************************************/
+void MeshLibrary::BuildCylinder(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod)
+{
+	vertices.clear();
+	indices.clear();
+
+	// side wall - a bottom and top vertex for every slice
+	for (int i = 0; i <= g_CurveSlices[lod]; i++)
+	{
+		float s = (float)i / g_CurveSlices[lod];
+		float angle = s * 2.0f * g_PI;
+		glm::vec3 normal(cos(angle), 0.0f, sin(angle));
+
+		AddVertex(vertices, glm::vec3(normal.x, 0.0f, normal.z), normal, glm::vec2(s, 0.0f));
+		AddVertex(vertices, glm::vec3(normal.x, 1.0f, normal.z), normal, glm::vec2(s, 1.0f));
+	}
+	for (int i = 0; i < g_CurveSlices[lod]; i++)
+	{
+		GLuint bottom = i * 2;
+		indices.push_back(bottom);
+		indices.push_back(bottom + 1);
+		indices.push_back(bottom + 3);
+		indices.push_back(bottom);
+		indices.push_back(bottom + 3);
+		indices.push_back(bottom + 2);
+	}
+
+	// bottom and top caps as triangle fans around a center vertex
+	for (int cap = 0; cap < 2; cap++)
+	{
+		float height = (float)cap;
+		glm::vec3 normal(0.0f, (cap == 0) ? -1.0f : 1.0f, 0.0f);
+		GLuint center = (GLuint)(vertices.size() / g_FloatsPerVertex);
+
+		AddVertex(vertices, glm::vec3(0.0f, height, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+		for (int i = 0; i <= g_CurveSlices[lod]; i++)
+		{
+			float angle = (float)i / g_CurveSlices[lod] * 2.0f * g_PI;
+			AddVertex(vertices,
+				glm::vec3(cos(angle), height, sin(angle)),
+				normal,
+				glm::vec2(0.5f + 0.5f * cos(angle), 0.5f + 0.5f * sin(angle)));
+		}
+		for (int i = 0; i < g_CurveSlices[lod]; i++)
+		{
+			indices.push_back(center);
+			indices.push_back(center + 1 + i);
+			indices.push_back(center + 2 + i);
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildCone()
+ *
+ *  This method is used for generating a cone with a base
+ *  radius of 1 at 0 on the Y axis and its tip at 1, at a
+ *  tessellation level.
+ ***********************************************************/
+void MeshLibrary::BuildCone(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod)
+{
+	vertices.clear();
+	indices.clear();
+
+	// side wall - a base vertex and a tip vertex for every slice
+	// so each slice keeps its own sloped normal
+	for (int i = 0; i <= g_CurveSlices[lod]; i++)
+	{
+		float s = (float)i / g_CurveSlices[lod];
+		float angle = s * 2.0f * g_PI;
+		glm::vec3 normal = glm::normalize(glm::vec3(cos(angle), 1.0f, sin(angle)));
+
+		AddVertex(vertices, glm::vec3(cos(angle), 0.0f, sin(angle)), normal, glm::vec2(s, 0.0f));
+		AddVertex(vertices, glm::vec3(0.0f, 1.0f, 0.0f), normal, glm::vec2(s, 1.0f));
+	}
+	for (int i = 0; i < g_CurveSlices[lod]; i++)
+	{
+		GLuint base = i * 2;
+		indices.push_back(base);
+		indices.push_back(base + 1);
+		indices.push_back(base + 2);
+	}
+
+	// base cap as a triangle fan around a center vertex
+	glm::vec3 normal(0.0f, -1.0f, 0.0f);
+	GLuint center = (GLuint)(vertices.size() / g_FloatsPerVertex);
+
+	AddVertex(vertices, glm::vec3(0.0f, 0.0f, 0.0f), normal, glm::vec2(0.5f, 0.5f));
+	for (int i = 0; i <= g_CurveSlices[lod]; i++)
+	{
+		float angle = (float)i / g_CurveSlices[lod] * 2.0f * g_PI;
+		AddVertex(vertices,
+			glm::vec3(cos(angle), 0.0f, sin(angle)),
+			normal,
+			glm::vec2(0.5f + 0.5f * cos(angle), 0.5f + 0.5f * sin(angle)));
+	}
+	for (int i = 0; i < g_CurveSlices[lod]; i++)
+	{
+		indices.push_back(center);
+		indices.push_back(center + 1 + i);
+		indices.push_back(center + 2 + i);
+	}
+}
+
+/***********************************************************
+ *  BuildSphere()
+ *
+ *  This method is used for generating a sphere with a radius
+ *  of 1 centered on the origin, at a tessellation level.
+ ***********************************************************/
+void MeshLibrary::BuildSphere(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod)
+{
+	vertices.clear();
+	indices.clear();
+
+	for (int stack = 0; stack <= g_SphereStacks[lod]; stack++)
+	{
+		float t = (float)stack / g_SphereStacks[lod];
+		float phi = t * g_PI;
+
+		for (int slice = 0; slice <= g_CurveSlices[lod]; slice++)
+		{
+			float s = (float)slice / g_CurveSlices[lod];
+			float theta = s * 2.0f * g_PI;
+			glm::vec3 position(
+				sin(phi) * cos(theta),
+				cos(phi),
+				sin(phi) * sin(theta));
+
+			AddVertex(vertices, position, position, glm::vec2(s, 1.0f - t));
+		}
+	}
+
+	int ringVertices = g_CurveSlices[lod] + 1;
+	for (int stack = 0; stack < g_SphereStacks[lod]; stack++)
+	{
+		for (int slice = 0; slice < g_CurveSlices[lod]; slice++)
+		{
+			GLuint current = stack * ringVertices + slice;
+			GLuint below = current + ringVertices;
+
+			indices.push_back(current);
+			indices.push_back(current + 1);
+			indices.push_back(below);
+			indices.push_back(current + 1);
+			indices.push_back(below + 1);
+			indices.push_back(below);
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildTorus()
+ *
+ *  This method is used for generating a torus in the XY
+ *  plane with a main radius of 1 around the Z axis, at a
+ *  tessellation level.
+ ***********************************************************/
+void MeshLibrary::BuildTorus(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod)
+{
+	vertices.clear();
+	indices.clear();
+
+	for (int ring = 0; ring <= g_CurveSlices[lod]; ring++)
+	{
+		float s = (float)ring / g_CurveSlices[lod];
+		float u = s * 2.0f * g_PI;
+
+		for (int tube = 0; tube <= g_TorusTubeSlices[lod]; tube++)
+		{
+			float t = (float)tube / g_TorusTubeSlices[lod];
+			float v = t * 2.0f * g_PI;
+			glm::vec3 normal(
+				cos(v) * cos(u),
+				cos(v) * sin(u),
+				sin(v));
+			glm::vec3 position(
+				(1.0f + g_TorusTubeRadius * cos(v)) * cos(u),
+				(1.0f + g_TorusTubeRadius * cos(v)) * sin(u),
+				g_TorusTubeRadius * sin(v));
+
+			AddVertex(vertices, position, normal, glm::vec2(s, t));
+		}
+	}
+
+	int tubeVertices = g_TorusTubeSlices[lod] + 1;
+	for (int ring = 0; ring < g_CurveSlices[lod]; ring++)
+	{
+		for (int tube = 0; tube < g_TorusTubeSlices[lod]; tube++)
+		{
+			GLuint current = ring * tubeVertices + tube;
+			GLuint next = current + tubeVertices;
+
+			indices.push_back(current);
+			indices.push_back(next);
+			indices.push_back(current + 1);
+			indices.push_back(current + 1);
+			indices.push_back(next);
+			indices.push_back(next + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  AppendMesh()
+ *
+ *  This method is used for appending the generated vertex
+ *  and index data of one mesh to the shared data, and
+ *  keeping where it landed.  The indices stay relative to
+ *  the mesh, and each draw adds the base vertex instead.
+ *  The bounding box of the vertex positions is kept for
+ *  culling.
+ ***********************************************************/
+void MeshLibrary::AppendMesh(
+	MESH_RANGE& mesh,
+	const std::vector<GLfloat>& vertices,
+	const std::vector<GLuint>& indices,
+	std::vector<GLfloat>& sharedVertices,
+	std::vector<GLuint>& sharedIndices)
+{
+	mesh.firstIndex = (GLuint)sharedIndices.size();
+	mesh.indexCount = (GLuint)indices.size();
+	mesh.baseVertex = (GLint)(sharedVertices.size() / g_FloatsPerVertex);
+
+	mesh.boundsMin = glm::vec3(vertices[0], vertices[1], vertices[2]);
+	mesh.boundsMax = mesh.boundsMin;
+	for (int i = 0; i < vertices.size(); i += g_FloatsPerVertex)
+	{
+		glm::vec3 position = glm::vec3(vertices[i], vertices[i + 1], vertices[i + 2]);
+		mesh.boundsMin = glm::min(mesh.boundsMin, position);
+		mesh.boundsMax = glm::max(mesh.boundsMax, position);
+	}
+
+	sharedVertices.insert(sharedVertices.end(), vertices.begin(), vertices.end());
+	sharedIndices.insert(sharedIndices.end(), indices.begin(), indices.end());
+}
+
+/***********************************************************
+ *  CreateBuffers()
+ *
+ *  This method is used for uploading the shared vertex and
+ *  index data into OpenGL buffers and recording the vertex
+ *  layout in the vertex array object every draw uses.
+ ***********************************************************/
+void MeshLibrary::CreateBuffers(
+	const std::vector<GLfloat>& vertices,
+	const std::vector<GLuint>& indices)
+{
+	GLsizei stride = sizeof(GLfloat) * g_FloatsPerVertex;
+
+	glGenVertexArrays(1, &m_vao);
+	glBindVertexArray(m_vao);
+
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * indices.size(), indices.data(), GL_STATIC_DRAW);
+
+	// position, normal and texture coordinate
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * 3));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(sizeof(GLfloat) * 6));
+	glEnableVertexAttribArray(2);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for moving on to the next frame's
+ *  section of the frame buffer.  The section was last read
+ *  by the draws of a frame a whole ring ago, which the GPU
+ *  has normally finished long before.
+ ***********************************************************/
+void MeshLibrary::BeginFrame()
+{
+	m_frameBuffer.BeginSection();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for fencing the draws that read the
+ *  current frame's section, so it is not written again until
+ *  the GPU is done with them.
+ ***********************************************************/
+void MeshLibrary::EndFrame()
+{
+	m_frameBuffer.EndSection();
+}
+
+/***********************************************************
+ *  UploadFrameData()
+ *
+ *  This method is used for writing the per-instance values
+ *  and the draws into the current section.  The indirect
+ *  commands are written straight into the mapped memory in
+ *  order, without a staging copy.  Each
+ *  command starts at the mesh range in the shared buffers,
+ *  and its base instance points the shader at the first
+ *  instance of the draw.  The frame buffer is only created
+ *  again when a section is too small, with room to grow.
+ ***********************************************************/
+void MeshLibrary::UploadFrameData(const MESH_INSTANCE* instances, int instanceCount, const MESH_DRAW* draws, int drawCount)
+{
+	if ((instanceCount <= 0) || (drawCount <= 0))
+	{
+		return;
+	}
+
+	// instances, then the commands, starting on an aligned offset
+	GLsizeiptr alignment = m_storageAlignment;
+	m_instanceOffset = 0;
+	m_instanceSize = sizeof(MESH_INSTANCE) * instanceCount;
+	m_commandOffset = (m_instanceOffset + m_instanceSize + alignment - 1) / alignment * alignment;
+	GLsizeiptr sectionSize = m_commandOffset + sizeof(DRAW_ELEMENTS_COMMAND) * drawCount;
+
+	if (sectionSize > m_frameBuffer.GetSectionSize())
+	{
+		if (m_frameBuffer.Create(sectionSize * 2) == false)
+		{
+			return;
+		}
+	}
+
+	unsigned char* section = m_frameBuffer.GetSectionData();
+	memcpy(section + m_instanceOffset, instances, m_instanceSize);
+
+	DRAW_ELEMENTS_COMMAND* commands = (DRAW_ELEMENTS_COMMAND*)(section + m_commandOffset);
+	for (int i = 0; i < drawCount; i++)
+	{
+		MakeDrawCommand(draws[i].mesh, draws[i].lod, draws[i].firstInstance, draws[i].instanceCount, commands[i]);
+	}
+}
+
+/***********************************************************
+ *  GetFrameSectionCount()
+ *
+ *  This method is used for getting the number of frames that
+ *  each keep their own section of the frame buffer.
+ ***********************************************************/
+int MeshLibrary::GetFrameSectionCount() const
+{
+	return(RING_BUFFER_SECTIONS);
+}
+
+/***********************************************************
+ *  GetFrameBufferStats()
+ *
+ *  This method is used for getting the counters of the waits
+ *  for the GPU to release a section of the frame buffer.
+ ***********************************************************/
+const RING_BUFFER_STATS& MeshLibrary::GetFrameBufferStats() const
+{
+	return(m_frameBuffer.GetStats());
+}
+
+/***********************************************************
+ *  DrawIndirect()
+ *
+ *  This method is used for submitting a run of the uploaded
+ *  draws with a single multi-draw indirect call, starting at
+ *  the command of the first draw of the run.
+ ***********************************************************/
+void MeshLibrary::DrawIndirect(int firstDraw, int drawCount)
+{
+	if ((drawCount <= 0) || (m_frameBuffer.IsCreated() == false))
+	{
+		return;
+	}
+
+	GLuint buffer = m_frameBuffer.GetBuffer();
+	GLintptr sectionOffset = m_frameBuffer.GetSectionOffset();
+	glBindBufferRange(GL_SHADER_STORAGE_BUFFER, INSTANCE_BUFFER_BINDING, buffer,
+		sectionOffset + m_instanceOffset, m_instanceSize);
+
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+		(void*)(sectionOffset + m_commandOffset + sizeof(DRAW_ELEMENTS_COMMAND) * firstDraw), drawCount, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  MakeDrawCommand()
+ *
+ *  This method is used for filling in the indirect command
+ *  of a run of instances of a shape mesh at a tessellation
+ *  level.  The base instance points the shader of the pass
+ *  at the run's first instance.
+ ***********************************************************/
+void MeshLibrary::MakeDrawCommand(MESH_TYPE mesh, int lod, int firstInstance, int instanceCount, DRAW_ELEMENTS_COMMAND& command) const
+{
+	const MESH_RANGE& range = m_meshes[mesh][lod];
+
+	command.count = range.indexCount;
+	command.instanceCount = (GLuint)instanceCount;
+	command.firstIndex = range.firstIndex;
+	command.baseVertex = range.baseVertex;
+	command.baseInstance = (GLuint)firstInstance;
+}
+
+/***********************************************************
+ *  DrawCommands()
+ *
+ *  This method is used for submitting the indirect commands
+ *  at the start of another buffer with a single multi-draw
+ *  call.  The pass binds its own program and instances.
+ ***********************************************************/
+void MeshLibrary::DrawCommands(GLuint commandBuffer, int drawCount) const
+{
+	if ((drawCount <= 0) || (m_vao == 0))
+	{
+		return;
+	}
+
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, drawCount, 0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the object-space bounding
+ *  box of a shape mesh.  The box is empty until the meshes
+ *  have been loaded.  The finest level holds the others.
+ ***********************************************************/
+void MeshLibrary::GetMeshBounds(MESH_TYPE mesh, glm::vec3& boundsMin, glm::vec3& boundsMax) const
+{
+	boundsMin = m_meshes[mesh][0].boundsMin;
+	boundsMax = m_meshes[mesh][0].boundsMax;
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method is used for getting the number of triangles
+ *  drawn for one instance of a shape mesh at a tessellation
+ *  level.
+ ***********************************************************/
+int MeshLibrary::GetTriangleCount(MESH_TYPE mesh, int lod) const
+{
+	return((int)m_meshes[mesh][lod].indexCount / 3);
+}
@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshlibrary.h
+// ============
+// generate the basic 3D shape meshes and draw them with hardware instancing
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "RingBuffer.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// basic mesh shapes that can be drawn by the mesh library
+enum MESH_TYPE
+{
+	MESH_PLANE = 0,
+	MESH_BOX,
+	MESH_CYLINDER,
+	MESH_CONE,
+	MESH_SPHERE,
+	MESH_TORUS,
+	MESH_COUNT
+};
+
+// tessellation levels generated for every shape mesh, from the
+// finest at 0 to the coarsest - flat shapes look the same at
+// every level
+const int MESH_LOD_COUNT = 3;
+
+// shader storage binding point of the instance buffer read by
+// the instanced vertex shader - this must match the shader
+const GLuint INSTANCE_BUFFER_BINDING = 0;
+
+/***********************************************************
+ *  MeshLibrary
+ *
+ *  This class generates the same basic shapes as ShapeMeshes
+ *  (plane, box, cylinder, cone, sphere, torus) into one
+ *  shared vertex buffer and one shared index buffer, so any
+ *  number of draws of any of the shapes can be submitted
+ *  with a single multi-draw indirect call.  The curved shapes
+ *  are generated at several tessellation levels, so small
+ *  objects can be drawn with fewer vertices.  The per-instance
+ *  and per-draw values are read by the vertex shader from
+ *  shader storage buffers.
+ ***********************************************************/
+class MeshLibrary
+{
+public:
+	// constructor
+	MeshLibrary();
+	// destructor
+	~MeshLibrary();
+
+	// per-instance values read by the instanced vertex shader,
+	// std430 layout of one entry in the instance buffer
+	struct MESH_INSTANCE
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec4 params;		// xy = texture UV scale, z = material index, w = texture layer
+	};
+
+	// one draw of a run of instances of a shape mesh
+	struct MESH_DRAW
+	{
+		MESH_TYPE mesh;
+		int lod;				// tessellation level of the mesh
+		int firstInstance;
+		int instanceCount;
+	};
+
+	// layout of one command in an indirect buffer
+	struct DRAW_ELEMENTS_COMMAND
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// generate all of the basic shape meshes
+	void LoadMeshes();
+
+	// move on to the next frame's section of the frame buffer,
+	// waiting when the GPU is still reading it
+	void BeginFrame();
+	// fence the draws that read the current frame's section
+	void EndFrame();
+	// write the per-instance values and the indirect commands of
+	// a list of draws into the current section
+	void UploadFrameData(const MESH_INSTANCE* instances, int instanceCount, const MESH_DRAW* draws, int drawCount);
+	// get the number of frames that each keep their own section,
+	// unchanged data must be uploaded once for each of them
+	int GetFrameSectionCount() const;
+	// get the counters of the waits for the GPU to release a section
+	const RING_BUFFER_STATS& GetFrameBufferStats() const;
+
+	// submit a run of the uploaded draws with one multi-draw call
+	void DrawIndirect(int firstDraw, int drawCount);
+	// fill in the indirect command drawing a run of instances of
+	// a shape mesh, for passes that keep their own instances
+	void MakeDrawCommand(MESH_TYPE mesh, int lod, int firstInstance, int instanceCount, DRAW_ELEMENTS_COMMAND& command) const;
+	// submit the indirect commands of another buffer with one
+	// multi-draw call over the shared vertex layout
+	void DrawCommands(GLuint commandBuffer, int drawCount) const;
+
+	// get the object-space bounding box of a shape mesh
+	void GetMeshBounds(MESH_TYPE mesh, glm::vec3& boundsMin, glm::vec3& boundsMax) const;
+	// get the number of triangles of a shape mesh at a tessellation level
+	int GetTriangleCount(MESH_TYPE mesh, int lod) const;
+
+private:
+	// where a shape mesh lives in the shared buffers
+	struct MESH_RANGE
+	{
+		GLuint firstIndex;
+		GLuint indexCount;
+		GLint baseVertex;
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+	};
+
+	// generated shape meshes at every tessellation level
+	MESH_RANGE m_meshes[MESH_COUNT][MESH_LOD_COUNT];
+	// vertex layout and the shared vertex and index buffers
+	GLuint m_vao;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	// ring of per-frame sections holding the per-instance values
+	// and indirect commands
+	RingBuffer m_frameBuffer;
+	// offset alignment of shader storage buffer ranges
+	GLint m_storageAlignment;
+	// where the values of the last upload live in every section
+	GLintptr m_instanceOffset;
+	GLsizeiptr m_instanceSize;
+	GLintptr m_commandOffset;
+
+	// helpers for generating the shape vertex data
+	void AddVertex(
+		std::vector<GLfloat>& vertices,
+		glm::vec3 position,
+		glm::vec3 normal,
+		glm::vec2 uv);
+	void BuildPlane(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+	void BuildBox(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices);
+	void BuildCylinder(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod);
+	void BuildCone(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod);
+	void BuildSphere(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod);
+	void BuildTorus(std::vector<GLfloat>& vertices, std::vector<GLuint>& indices, int lod);
+
+	// append generated data to the shared vertex and index data
+	void AppendMesh(
+		MESH_RANGE& mesh,
+		const std::vector<GLfloat>& vertices,
+		const std::vector<GLuint>& indices,
+		std::vector<GLfloat>& sharedVertices,
+		std::vector<GLuint>& sharedIndices);
+	// upload the shared data and record the vertex layout
+	void CreateBuffers(
+		const std::vector<GLfloat>& vertices,
+		const std::vector<GLuint>& indices);
+};
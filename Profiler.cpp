@@ -0,0 +1,516 @@
+///////////////////////////////////////////////////////////////////////////////
+// profiler.cpp
+// ============
+// CPU and GPU timing of named scopes in the frame loop
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// number of queries created at a time when a frame runs out
+	const int g_QueryAllocationSize = 64;
+}
+
+/***********************************************************
+ *  Profiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+Profiler::Profiler()
+{
+	for (int i = 0; i < QUERY_FRAMES; i++)
+	{
+		m_queryFrames[i].usedQueries = 0;
+		m_queryFrames[i].inputQuery = -1;
+	}
+	m_frameCount = 0;
+	m_droppedGpuFrames = 0;
+	m_frameStart = std::chrono::steady_clock::now();
+	m_bInputShown = false;
+	m_gpuClockOffset = 0;
+	m_bGpuClockCalibrated = false;
+	m_inputLatency.next = 0;
+	m_inputLatency.count = 0;
+}
+
+/***********************************************************
+ *  ~Profiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+Profiler::~Profiler()
+{
+	for (int i = 0; i < QUERY_FRAMES; i++)
+	{
+		if (m_queryFrames[i].queries.size() > 0)
+		{
+			glDeleteQueries((GLsizei)m_queryFrames[i].queries.size(), m_queryFrames[i].queries.data());
+		}
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a frame of samples.  The
+ *  query frame about to be reused was issued two frames ago,
+ *  so its results are read back first.
+ ***********************************************************/
+void Profiler::BeginFrame()
+{
+	m_frameStart = std::chrono::steady_clock::now();
+	QUERY_FRAME& frame = m_queryFrames[m_frameCount % QUERY_FRAMES];
+	ResolveQueryFrame(frame);
+	frame.usedQueries = 0;
+	frame.timers.clear();
+	frame.inputQuery = -1;
+	m_bInputShown = false;
+
+	m_frameCount++;
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for finishing a frame of samples by
+ *  adding the CPU totals of every scope that ran, including
+ *  the whole frame as the "Frame" scope.  Scopes timed
+ *  before the first frame count towards that frame.  A frame
+ *  that shows new input records a timestamp after its last
+ *  commands, which tells when the GPU finished it.
+ ***********************************************************/
+void Profiler::EndFrame()
+{
+	std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - m_frameStart;
+	AddCpuTime(FindScope("Frame"), frameTime.count());
+
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		if (m_scopes[i].bCpuSampled == true)
+		{
+			AddSample(m_scopes[i].cpuHistory, (float)m_scopes[i].cpuFrameTotal);
+			m_scopes[i].cpuFrameTotal = 0.0;
+			m_scopes[i].bCpuSampled = false;
+		}
+	}
+
+	if (m_bInputShown == true)
+	{
+		if (m_bGpuClockCalibrated == false)
+		{
+			CalibrateGpuClock();
+		}
+
+		QUERY_FRAME& frame = m_queryFrames[(m_frameCount + QUERY_FRAMES - 1) % QUERY_FRAMES];
+		frame.inputQuery = AllocateQuery();
+		frame.inputTime = m_inputTime;
+		glQueryCounter(frame.queries[frame.inputQuery], GL_TIMESTAMP);
+		m_bInputShown = false;
+	}
+}
+
+/***********************************************************
+ *  FindScope()
+ *
+ *  This method is used for getting the index of a named
+ *  scope, adding the scope the first time it is seen.
+ ***********************************************************/
+int Profiler::FindScope(const char* name)
+{
+	int scopeIndex = m_scopeTags.Find(HashTag(name));
+	if (scopeIndex >= 0)
+	{
+		return(scopeIndex);
+	}
+
+	PROFILE_SCOPE scope;
+	scope.name = name;
+	scope.cpuFrameTotal = 0.0;
+	scope.bCpuSampled = false;
+	scope.cpuHistory.next = 0;
+	scope.cpuHistory.count = 0;
+	scope.gpuHistory.next = 0;
+	scope.gpuHistory.count = 0;
+	m_scopes.push_back(scope);
+
+	scopeIndex = (int)m_scopes.size() - 1;
+	m_scopeTags.Register(name, scopeIndex);
+
+	return(scopeIndex);
+}
+
+/***********************************************************
+ *  AddCpuTime()
+ *
+ *  This method is used for adding CPU time spent in a scope
+ *  to the total of the current frame.
+ ***********************************************************/
+void Profiler::AddCpuTime(int scopeIndex, double milliseconds)
+{
+	m_scopes[scopeIndex].cpuFrameTotal += milliseconds;
+	m_scopes[scopeIndex].bCpuSampled = true;
+}
+
+/***********************************************************
+ *  AllocateQuery()
+ *
+ *  This method is used for getting an unused query of the
+ *  current query frame, creating more queries when needed.
+ ***********************************************************/
+int Profiler::AllocateQuery()
+{
+	QUERY_FRAME& frame = m_queryFrames[(m_frameCount + QUERY_FRAMES - 1) % QUERY_FRAMES];
+
+	if (frame.usedQueries == frame.queries.size())
+	{
+		int first = (int)frame.queries.size();
+		frame.queries.resize(first + g_QueryAllocationSize);
+		glGenQueries(g_QueryAllocationSize, frame.queries.data() + first);
+	}
+
+	return(frame.usedQueries++);
+}
+
+/***********************************************************
+ *  BeginGpuTimer()
+ *
+ *  This method is used for recording a GPU timestamp at the
+ *  start of a scope.  Timestamps are used rather than
+ *  GL_TIME_ELAPSED queries, which cannot be nested.
+ ***********************************************************/
+int Profiler::BeginGpuTimer(int scopeIndex)
+{
+	QUERY_FRAME& frame = m_queryFrames[(m_frameCount + QUERY_FRAMES - 1) % QUERY_FRAMES];
+
+	GPU_TIMER timer;
+	timer.scopeIndex = scopeIndex;
+	timer.startQuery = AllocateQuery();
+	timer.endQuery = -1;
+	glQueryCounter(frame.queries[timer.startQuery], GL_TIMESTAMP);
+	frame.timers.push_back(timer);
+
+	return((int)frame.timers.size() - 1);
+}
+
+/***********************************************************
+ *  EndGpuTimer()
+ *
+ *  This method is used for recording a GPU timestamp at the
+ *  end of a scope.
+ ***********************************************************/
+void Profiler::EndGpuTimer(int timerIndex)
+{
+	QUERY_FRAME& frame = m_queryFrames[(m_frameCount + QUERY_FRAMES - 1) % QUERY_FRAMES];
+
+	if ((timerIndex < 0) || (timerIndex >= frame.timers.size()))
+	{
+		return;
+	}
+
+	int endQuery = AllocateQuery();
+	glQueryCounter(frame.queries[endQuery], GL_TIMESTAMP);
+	frame.timers[timerIndex].endQuery = endQuery;
+}
+
+/***********************************************************
+ *  SetInputTime()
+ *
+ *  This method is used for recording the time the oldest
+ *  input shown by the current frame was received, so the
+ *  frame's input latency is measured when it ends.
+ ***********************************************************/
+void Profiler::SetInputTime(std::chrono::steady_clock::time_point inputTime)
+{
+	m_inputTime = inputTime;
+	m_bInputShown = true;
+}
+
+/***********************************************************
+ *  CalibrateGpuClock()
+ *
+ *  This method is used for measuring the offset from the CPU
+ *  clock the input is timed with to the GPU clock of the
+ *  timestamp queries.  Both clocks run at a steady rate, so
+ *  this is only done once.
+ ***********************************************************/
+void Profiler::CalibrateGpuClock()
+{
+	GLint64 gpuTime = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+	std::chrono::nanoseconds cpuTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch());
+
+	m_gpuClockOffset = (long long)gpuTime - (long long)cpuTime.count();
+	m_bGpuClockCalibrated = true;
+}
+
+/***********************************************************
+ *  ResolveQueryFrame()
+ *
+ *  This method is used for reading back the GPU timers of a
+ *  query frame.  The last query is checked first; when it is
+ *  not available yet the whole frame is dropped instead of
+ *  waiting for it.
+ ***********************************************************/
+void Profiler::ResolveQueryFrame(QUERY_FRAME& frame)
+{
+	if (frame.usedQueries == 0)
+	{
+		return;
+	}
+
+	GLint available = GL_FALSE;
+	glGetQueryObjectiv(frame.queries[frame.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available == GL_FALSE)
+	{
+		m_droppedGpuFrames++;
+		return;
+	}
+
+	m_gpuFrameTotals.assign(m_scopes.size(), 0.0);
+	m_gpuSampled.assign(m_scopes.size(), 0);
+
+	for (int i = 0; i < frame.timers.size(); i++)
+	{
+		const GPU_TIMER& timer = frame.timers[i];
+		if (timer.endQuery < 0)
+		{
+			continue;
+		}
+
+		GLuint64 start = 0;
+		GLuint64 end = 0;
+		glGetQueryObjectui64v(frame.queries[timer.startQuery], GL_QUERY_RESULT, &start);
+		glGetQueryObjectui64v(frame.queries[timer.endQuery], GL_QUERY_RESULT, &end);
+		m_gpuFrameTotals[timer.scopeIndex] += (double)(end - start) / 1000000.0;
+		m_gpuSampled[timer.scopeIndex] = 1;
+	}
+
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		if (m_gpuSampled[i] != 0)
+		{
+			AddSample(m_scopes[i].gpuHistory, (float)m_gpuFrameTotals[i]);
+		}
+	}
+
+	// the time the input was received is moved onto the GPU clock
+	if (frame.inputQuery >= 0)
+	{
+		GLuint64 frameFinished = 0;
+		glGetQueryObjectui64v(frame.queries[frame.inputQuery], GL_QUERY_RESULT, &frameFinished);
+		std::chrono::nanoseconds inputTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			frame.inputTime.time_since_epoch());
+		long long latency = (long long)frameFinished - (inputTime.count() + m_gpuClockOffset);
+		AddSample(m_inputLatency, (float)((double)latency / 1000000.0));
+	}
+}
+
+/***********************************************************
+ *  AddSample()
+ *
+ *  This method is used for adding a sample to a rolling
+ *  window, replacing the oldest sample when it is full.
+ ***********************************************************/
+void Profiler::AddSample(SAMPLE_HISTORY& history, float sample)
+{
+	history.samples[history.next] = sample;
+	history.next = (history.next + 1) % HISTORY_LENGTH;
+	history.count = std::min(history.count + 1, (int)HISTORY_LENGTH);
+}
+
+/***********************************************************
+ *  ComputeStats()
+ *
+ *  This method is used for computing the minimum, average and
+ *  99th percentile of the samples in a rolling window.
+ ***********************************************************/
+void Profiler::ComputeStats(const SAMPLE_HISTORY& history, TIMING_STATS& stats)
+{
+	stats.minimum = 0.0f;
+	stats.average = 0.0f;
+	stats.p99 = 0.0f;
+	stats.samples = history.count;
+
+	if (history.count == 0)
+	{
+		return;
+	}
+
+	float sorted[HISTORY_LENGTH];
+	float total = 0.0f;
+	for (int i = 0; i < history.count; i++)
+	{
+		sorted[i] = history.samples[i];
+		total += sorted[i];
+	}
+
+	int p99Index = (history.count - 1) * 99 / 100;
+	std::nth_element(sorted, sorted + p99Index, sorted + history.count);
+
+	stats.minimum = *std::min_element(sorted, sorted + history.count);
+	stats.average = total / history.count;
+	stats.p99 = sorted[p99Index];
+}
+
+/***********************************************************
+ *  GetScopeStats()
+ *
+ *  This method is used for getting the rolling CPU and GPU
+ *  statistics of a scope.
+ ***********************************************************/
+bool Profiler::GetScopeStats(int scopeIndex, TIMING_STATS& cpuStats, TIMING_STATS& gpuStats) const
+{
+	if ((scopeIndex < 0) || (scopeIndex >= m_scopes.size()))
+	{
+		return(false);
+	}
+
+	ComputeStats(m_scopes[scopeIndex].cpuHistory, cpuStats);
+	ComputeStats(m_scopes[scopeIndex].gpuHistory, gpuStats);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetInputLatencyStats()
+ *
+ *  This method is used for getting the rolling statistics
+ *  of the input latency of the frames that showed input.
+ ***********************************************************/
+void Profiler::GetInputLatencyStats(TIMING_STATS& stats) const
+{
+	ComputeStats(m_inputLatency, stats);
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method is used for getting the number of frames that
+ *  have been profiled.
+ ***********************************************************/
+int Profiler::GetFrameCount() const
+{
+	return(m_frameCount);
+}
+
+/***********************************************************
+ *  PrintReport()
+ *
+ *  This method is used for printing the rolling statistics
+ *  of every scope, and of the input latency, to the console.
+ ***********************************************************/
+void Profiler::PrintReport() const
+{
+	std::cout << "INFO: Profile of the last " << std::min(m_frameCount, (int)HISTORY_LENGTH)
+		<< " frames (ms), GPU frames dropped: " << m_droppedGpuFrames << std::endl;
+	std::cout << std::left << std::setw(24) << "scope"
+		<< std::right << std::setw(10) << "cpu min" << std::setw(10) << "cpu avg" << std::setw(10) << "cpu p99"
+		<< std::setw(10) << "gpu min" << std::setw(10) << "gpu avg" << std::setw(10) << "gpu p99" << std::endl;
+
+	std::cout << std::fixed << std::setprecision(3);
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		TIMING_STATS cpuStats;
+		TIMING_STATS gpuStats;
+		GetScopeStats(i, cpuStats, gpuStats);
+
+		std::cout << std::left << std::setw(24) << m_scopes[i].name
+			<< std::right << std::setw(10) << cpuStats.minimum << std::setw(10) << cpuStats.average << std::setw(10) << cpuStats.p99
+			<< std::setw(10) << gpuStats.minimum << std::setw(10) << gpuStats.average << std::setw(10) << gpuStats.p99 << std::endl;
+	}
+
+	// only frames that showed new input are measured
+	if (m_inputLatency.count > 0)
+	{
+		TIMING_STATS latencyStats;
+		GetInputLatencyStats(latencyStats);
+		std::cout << "INFO: Input latency, received to finished on the GPU (ms) - min: " << latencyStats.minimum
+			<< ", avg: " << latencyStats.average
+			<< ", p99: " << latencyStats.p99
+			<< " over " << latencyStats.samples << " frames" << std::endl;
+	}
+	std::cout.unsetf(std::ios::floatfield);
+	std::cout << std::setprecision(6);
+}
+
+/***********************************************************
+ *  WriteCSV()
+ *
+ *  This method is used for writing the rolling statistics of
+ *  every scope to a CSV file, one row per scope.
+ ***********************************************************/
+bool Profiler::WriteCSV(const char* filename) const
+{
+	FILE* file = fopen(filename, "w");
+	if (file == NULL)
+	{
+		std::cout << "Could not write profile:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "scope,cpu_samples,cpu_min_ms,cpu_avg_ms,cpu_p99_ms,gpu_samples,gpu_min_ms,gpu_avg_ms,gpu_p99_ms\n");
+	for (int i = 0; i < m_scopes.size(); i++)
+	{
+		TIMING_STATS cpuStats;
+		TIMING_STATS gpuStats;
+		GetScopeStats(i, cpuStats, gpuStats);
+
+		fprintf(file, "%s,%d,%.4f,%.4f,%.4f,%d,%.4f,%.4f,%.4f\n",
+			m_scopes[i].name.c_str(),
+			cpuStats.samples, cpuStats.minimum, cpuStats.average, cpuStats.p99,
+			gpuStats.samples, gpuStats.minimum, gpuStats.average, gpuStats.p99);
+	}
+
+	return(fclose(file) == 0);
+}
+
+/***********************************************************
+ *  ProfileScope()
+ *
+ *  The constructor for the class - starts timing the scope
+ ***********************************************************/
+ProfileScope::ProfileScope(Profiler* pProfiler, const char* name, bool bGpu)
+{
+	m_pProfiler = pProfiler;
+	m_scopeIndex = -1;
+	m_gpuTimer = -1;
+
+	if (NULL != m_pProfiler)
+	{
+		m_scopeIndex = m_pProfiler->FindScope(name);
+		if (bGpu == true)
+		{
+			m_gpuTimer = m_pProfiler->BeginGpuTimer(m_scopeIndex);
+		}
+		m_start = std::chrono::steady_clock::now();
+	}
+}
+
+/***********************************************************
+ *  ~ProfileScope()
+ *
+ *  The destructor for the class - stops timing the scope
+ ***********************************************************/
+ProfileScope::~ProfileScope()
+{
+	if (NULL != m_pProfiler)
+	{
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_start;
+		m_pProfiler->AddCpuTime(m_scopeIndex, elapsed.count());
+		if (m_gpuTimer >= 0)
+		{
+			m_pProfiler->EndGpuTimer(m_gpuTimer);
+		}
+	}
+}
@@ -0,0 +1,185 @@
+///////////////////////////////////////////////////////////////////////////////
+// profiler.h
+// ============
+// CPU and GPU timing of named scopes in the frame loop
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TagRegistry.h"
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// rolling statistics of one timer, in milliseconds
+struct TIMING_STATS
+{
+	float minimum;
+	float average;
+	float p99;
+	int samples;
+};
+
+/***********************************************************
+ *  Profiler
+ *
+ *  This class collects CPU and GPU times of named scopes and
+ *  keeps the per-frame totals of the last frames for each
+ *  scope.  A scope that runs several times in one frame is
+ *  added up into one sample for the frame.
+ *
+ *  GPU times come from timestamp queries.  The queries of a
+ *  frame are only read back two frames later, and only when
+ *  the results are already available, so reading them never
+ *  stalls the pipeline.
+ *
+ *  A frame that shows new input also records a timestamp
+ *  after its last commands.  Read back the same way, it
+ *  gives the input latency: the time from the input being
+ *  received to the GPU finishing the frame that shows it.
+ ***********************************************************/
+class Profiler
+{
+public:
+	// constructor
+	Profiler();
+	// destructor
+	~Profiler();
+
+	// start and finish one frame of samples
+	void BeginFrame();
+	void EndFrame();
+
+	// find the index of a named scope, adding it when it is new
+	int FindScope(const char* name);
+	// add CPU time spent in a scope during the current frame
+	void AddCpuTime(int scopeIndex, double milliseconds);
+	// record a GPU timestamp at the start of a scope,
+	// returns the timer to pass to EndGpuTimer()
+	int BeginGpuTimer(int scopeIndex);
+	// record a GPU timestamp at the end of a scope
+	void EndGpuTimer(int timerIndex);
+	// record the time the oldest input shown by the current frame
+	// was received
+	void SetInputTime(std::chrono::steady_clock::time_point inputTime);
+
+	// get the rolling statistics of a scope
+	bool GetScopeStats(int scopeIndex, TIMING_STATS& cpuStats, TIMING_STATS& gpuStats) const;
+	// get the rolling statistics of the input latency
+	void GetInputLatencyStats(TIMING_STATS& stats) const;
+	// get the number of frames profiled
+	int GetFrameCount() const;
+	// print the statistics of every scope
+	void PrintReport() const;
+	// write the statistics of every scope to a CSV file
+	bool WriteCSV(const char* filename) const;
+
+private:
+	// samples kept per scope for the rolling statistics
+	static const int HISTORY_LENGTH = 256;
+	// frames of GPU queries in flight
+	static const int QUERY_FRAMES = 2;
+
+	// rolling window of per-frame samples
+	struct SAMPLE_HISTORY
+	{
+		float samples[HISTORY_LENGTH];
+		int next;
+		int count;
+	};
+
+	struct PROFILE_SCOPE
+	{
+		std::string name;
+		// totals of the current frame
+		double cpuFrameTotal;
+		bool bCpuSampled;
+		SAMPLE_HISTORY cpuHistory;
+		SAMPLE_HISTORY gpuHistory;
+	};
+
+	// one pair of timestamp queries
+	struct GPU_TIMER
+	{
+		int scopeIndex;
+		int startQuery;
+		int endQuery;
+	};
+
+	// queries and timers of one frame in flight
+	struct QUERY_FRAME
+	{
+		std::vector<GLuint> queries;
+		int usedQueries;
+		std::vector<GPU_TIMER> timers;
+		// timestamp after the last commands of a frame showing new
+		// input, -1 when there was none, and when the input came
+		int inputQuery;
+		std::chrono::steady_clock::time_point inputTime;
+	};
+
+	// every scope seen so far
+	std::vector<PROFILE_SCOPE> m_scopes;
+	// scope names interned to scope indices
+	TagRegistry m_scopeTags;
+	// query frames used round robin
+	QUERY_FRAME m_queryFrames[QUERY_FRAMES];
+	// per-scope GPU totals used while reading back a frame
+	std::vector<double> m_gpuFrameTotals;
+	std::vector<unsigned char> m_gpuSampled;
+	// number of frames begun
+	int m_frameCount;
+	// GPU frames dropped because their results were late
+	int m_droppedGpuFrames;
+	// CPU time the current frame began
+	std::chrono::steady_clock::time_point m_frameStart;
+	// time the oldest input shown by the current frame was received
+	std::chrono::steady_clock::time_point m_inputTime;
+	bool m_bInputShown;
+	// GPU timestamp clock minus the CPU clock in nanoseconds, and
+	// whether it has been measured yet
+	long long m_gpuClockOffset;
+	bool m_bGpuClockCalibrated;
+	// time from input being received to the GPU finishing the frame
+	// that shows it
+	SAMPLE_HISTORY m_inputLatency;
+
+	// get an unused query from the current query frame
+	int AllocateQuery();
+	// read back the timers of a query frame if they are ready
+	void ResolveQueryFrame(QUERY_FRAME& frame);
+	// measure the offset from the CPU clock to the GPU clock
+	void CalibrateGpuClock();
+	// add one sample to a rolling window
+	static void AddSample(SAMPLE_HISTORY& history, float sample);
+	// compute the statistics of a rolling window
+	static void ComputeStats(const SAMPLE_HISTORY& history, TIMING_STATS& stats);
+};
+
+/***********************************************************
+ *  ProfileScope
+ *
+ *  This class times the block of code it is declared in,
+ *  from its construction to the end of the block.  It does
+ *  nothing when no profiler is passed in.
+ ***********************************************************/
+class ProfileScope
+{
+public:
+	// start timing a scope on the CPU, and on the GPU when bGpu is set
+	ProfileScope(Profiler* pProfiler, const char* name, bool bGpu = true);
+	// stop timing the scope
+	~ProfileScope();
+
+private:
+	Profiler* m_pProfiler;
+	int m_scopeIndex;
+	int m_gpuTimer;
+	std::chrono::steady_clock::time_point m_start;
+};
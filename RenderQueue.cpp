@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// per-frame queue of visible objects ordered by packed render state sort keys
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <cstring>
+#include <utility>
+
+// declaration of global variables
+namespace
+{
+	// widths of the key fields
+	const int g_ShaderBits = 4;
+	const int g_MeshBits = 5;
+	const int g_ArrayBits = 10;
+	const int g_MaterialBits = 10;
+	const int g_DepthBits = 24;
+
+	// bits sorted by each radix pass
+	const int g_RadixBits = 8;
+	const int g_RadixSize = 1 << g_RadixBits;
+	const int g_RadixPasses = 64 / g_RadixBits;
+
+	// clamp a value into a key field
+	uint64_t PackField(int value, int bits)
+	{
+		int maximum = (1 << bits) - 1;
+		if (value < 0)
+		{
+			value = 0;
+		}
+		if (value > maximum)
+		{
+			value = maximum;
+		}
+		return((uint64_t)value);
+	}
+
+	// map a float to bits that sort the same way, keeping the
+	// highest bits of the result
+	uint64_t PackDepth(float depth)
+	{
+		uint32_t bits;
+		memcpy(&bits, &depth, sizeof(bits));
+		// negative values sort below positive ones and in reverse
+		bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+		return(bits >> (32 - g_DepthBits));
+	}
+}
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue()
+{
+}
+
+/***********************************************************
+ *  MakeKey()
+ *
+ *  This method is used for packing the render state of an
+ *  object into a sort key.  The highest bit splits the
+ *  opaque objects from the transparent ones.  Opaque keys
+ *  hold the state fields from the costliest change down,
+ *  then the depth, so nearer objects come first within the
+ *  same state.  Transparent keys hold the inverted depth
+ *  above the state fields, so farther objects always come
+ *  first and the state only breaks ties.  The texture array
+ *  comes right after the shader, since every multi-draw call
+ *  samples a single array, and is stored one higher so
+ *  untextured objects, at -1, sort first.
+ ***********************************************************/
+uint64_t RenderQueue::MakeKey(
+	bool bTransparent,
+	int shader,
+	int textureArray,
+	int mesh,
+	int material,
+	float depth)
+{
+	uint64_t state = PackField(shader, g_ShaderBits);
+	state = (state << g_ArrayBits) | PackField(textureArray + 1, g_ArrayBits);
+	state = (state << g_MeshBits) | PackField(mesh, g_MeshBits);
+	state = (state << g_MaterialBits) | PackField(material, g_MaterialBits);
+
+	const int stateBits = g_ShaderBits + g_ArrayBits + g_MeshBits + g_MaterialBits;
+	uint64_t depthBits = PackDepth(depth);
+
+	uint64_t key = 0;
+	if (bTransparent == false)
+	{
+		key = (state << g_DepthBits) | depthBits;
+	}
+	else
+	{
+		uint64_t farFirst = ~depthBits & ((1ull << g_DepthBits) - 1);
+		key = (1ull << 63) | (farFirst << stateBits) | state;
+	}
+
+	return(key);
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of queued
+ *  objects before their items are filled in.
+ ***********************************************************/
+void RenderQueue::Resize(int count)
+{
+	m_items.resize(count);
+}
+
+/***********************************************************
+ *  SetItem()
+ *
+ *  This method is used for setting the key and object of one
+ *  queued item.  Different items may be set from different
+ *  threads at the same time.
+ ***********************************************************/
+void RenderQueue::SetItem(int index, uint64_t key, int object)
+{
+	m_items[index].key = key;
+	m_items[index].object = object;
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for sorting the queued items by key
+ *  with a least significant digit radix sort.  The counts
+ *  for every pass are gathered in one walk over the items,
+ *  and passes where every key has the same digit are
+ *  skipped, which drops most of them since the fields in
+ *  use are usually narrow.  Items with equal keys keep the
+ *  order they were queued in.  The digit counts and the
+ *  items the passes alternate with are frame scratch, taken
+ *  from the arena.
+ ***********************************************************/
+void RenderQueue::Sort(FrameArena& arena)
+{
+	int count = (int)m_items.size();
+	if (count < 2)
+	{
+		return;
+	}
+
+	int* histograms = arena.Allocate<int>(g_RadixPasses * g_RadixSize);
+	memset(histograms, 0, sizeof(int) * g_RadixPasses * g_RadixSize);
+	for (int i = 0; i < count; i++)
+	{
+		uint64_t key = m_items[i].key;
+		for (int pass = 0; pass < g_RadixPasses; pass++)
+		{
+			histograms[pass * g_RadixSize + ((key >> (pass * g_RadixBits)) & (g_RadixSize - 1))]++;
+		}
+	}
+
+	RENDER_ITEM* source = m_items.data();
+	RENDER_ITEM* destination = arena.Allocate<RENDER_ITEM>(count);
+	for (int pass = 0; pass < g_RadixPasses; pass++)
+	{
+		int* histogram = &histograms[pass * g_RadixSize];
+		int shift = pass * g_RadixBits;
+
+		// every key has the same digit, nothing would move
+		if (histogram[(source[0].key >> shift) & (g_RadixSize - 1)] == count)
+		{
+			continue;
+		}
+
+		// turn the counts into the first slot of each digit
+		int offset = 0;
+		for (int digit = 0; digit < g_RadixSize; digit++)
+		{
+			int digitCount = histogram[digit];
+			histogram[digit] = offset;
+			offset += digitCount;
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			int digit = (int)((source[i].key >> shift) & (g_RadixSize - 1));
+			destination[histogram[digit]++] = source[i];
+		}
+		std::swap(source, destination);
+	}
+
+	// an odd number of passes left the result in the scratch items
+	if (source != m_items.data())
+	{
+		memcpy(m_items.data(), source, sizeof(RENDER_ITEM) * count);
+	}
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of queued
+ *  items.
+ ***********************************************************/
+int RenderQueue::GetCount() const
+{
+	return((int)m_items.size());
+}
+
+/***********************************************************
+ *  GetItem()
+ *
+ *  This method is used for getting a queued item.
+ ***********************************************************/
+const RENDER_ITEM& RenderQueue::GetItem(int index) const
+{
+	return(m_items[index]);
+}
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// per-frame queue of visible objects ordered by packed render state sort keys
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameArena.h"
+
+#include <cstdint>
+#include <vector>
+
+// one queued object and the key it is ordered by
+struct RENDER_ITEM
+{
+	uint64_t key;
+	int object;
+};
+
+// render state changes between consecutive objects of a frame
+struct STATE_CHANGES
+{
+	int shaders;				// shader program switches
+	int textures;				// texture array switches
+	int materials;				// material switches
+	int meshes;					// mesh switches
+};
+
+// counters from the last frame's render queue
+struct RENDER_STATS
+{
+	int objects;				// visible objects in the queue
+	int draws;					// instanced draws built from the queue
+	int submissions;			// multi-draw calls issued for the draws
+	int triangles;				// triangles drawn for the visible objects
+	STATE_CHANGES sorted;		// changes in the sorted order
+	STATE_CHANGES recorded;		// changes in the order the objects were recorded
+};
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class orders the visible objects of a frame by a
+ *  64-bit key packing their render state, sorted with a
+ *  radix sort.  Opaque objects come first, grouped by shader,
+ *  texture array, mesh and material,
+ *  and front to back within each group so the depth test
+ *  rejects hidden fragments early.  Transparent objects come
+ *  last and back to front, since blending needs the farthest
+ *  surface drawn first.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// constructor
+	RenderQueue();
+
+	// pack the render state of an object into a sort key, the
+	// depth is any value that grows with the distance to the eye
+	static uint64_t MakeKey(
+		bool bTransparent,
+		int shader,
+		int textureArray,
+		int mesh,
+		int material,
+		float depth);
+
+	// set the number of queued objects, the items are filled in
+	// afterwards and may be set from several threads
+	void Resize(int count);
+	// set the key and object of one queued item
+	void SetItem(int index, uint64_t key, int object);
+	// sort the queued items by key, with scratch memory from
+	// the frame arena
+	void Sort(FrameArena& arena);
+
+	// get the number of queued items
+	int GetCount() const;
+	// get a queued item
+	const RENDER_ITEM& GetItem(int index) const;
+
+private:
+	// queued items
+	std::vector<RENDER_ITEM> m_items;
+};
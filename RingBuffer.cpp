@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////
+// ringbuffer.cpp
+// ============
+// persistently mapped buffer split into fenced per-frame sections
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RingBuffer.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// the largest offset alignment OpenGL allows for buffer range
+	// bindings, so a section can start any kind of range
+	const GLsizeiptr g_SectionAlignment = 256;
+
+	// time given to each wait before checking again
+	const GLuint64 g_FenceTimeout = 1000000;
+}
+
+/***********************************************************
+ *  RingBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RingBuffer::RingBuffer()
+{
+	m_bufferID = 0;
+	m_pMappedData = NULL;
+	m_sectionSize = 0;
+	m_sectionCount = 0;
+	m_currentSection = 0;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/***********************************************************
+ *  ~RingBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RingBuffer::~RingBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the buffer with room for
+ *  the passed in number of sections.  The storage can never
+ *  be resized, so a larger ring means creating a new buffer.
+ *  OpenGL keeps the old buffer alive for any commands still
+ *  reading it.  The wait counters carry over.
+ ***********************************************************/
+bool RingBuffer::Create(GLsizeiptr sectionSize, int sectionCount)
+{
+	Destroy();
+
+	m_sectionSize = (sectionSize + g_SectionAlignment - 1) / g_SectionAlignment * g_SectionAlignment;
+	m_sectionCount = sectionCount;
+	m_currentSection = 0;
+	m_fences.assign(sectionCount, (GLsync)0);
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &m_bufferID);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferID);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, m_sectionSize * m_sectionCount, NULL, flags);
+	m_pMappedData = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, m_sectionSize * m_sectionCount, flags);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	if (NULL == m_pMappedData)
+	{
+		std::cout << "Could not map the ring buffer of size:" << m_sectionSize * m_sectionCount << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for releasing the buffer and the
+ *  fences of its sections.
+ ***********************************************************/
+void RingBuffer::Destroy()
+{
+	for (int i = 0; i < m_fences.size(); i++)
+	{
+		if (m_fences[i] != 0)
+		{
+			glDeleteSync(m_fences[i]);
+		}
+	}
+	m_fences.clear();
+
+	if (m_bufferID != 0)
+	{
+		if (NULL != m_pMappedData)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, m_bufferID);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+	m_pMappedData = NULL;
+	m_sectionSize = 0;
+	m_sectionCount = 0;
+}
+
+/***********************************************************
+ *  IsCreated()
+ *
+ *  This method is used for checking whether the buffer has
+ *  been created.
+ ***********************************************************/
+bool RingBuffer::IsCreated() const
+{
+	return(m_bufferID != 0);
+}
+
+/***********************************************************
+ *  BeginSection()
+ *
+ *  This method is used for moving on to the next section.
+ *  The GPU may still be reading that section for a frame
+ *  from a whole ring ago, in which case this waits on the
+ *  fence of that frame.  The time spent waiting is recorded,
+ *  since waiting here means the CPU is too far ahead.
+ ***********************************************************/
+void RingBuffer::BeginSection()
+{
+	if (m_bufferID == 0)
+	{
+		return;
+	}
+
+	m_currentSection = (m_currentSection + 1) % m_sectionCount;
+	m_stats.sectionsUsed++;
+	m_stats.lastWaitMilliseconds = 0.0;
+
+	GLsync fence = m_fences[m_currentSection];
+	if (fence == 0)
+	{
+		return;
+	}
+
+	// only a fence that has not signaled yet counts as a wait
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		do
+		{
+			result = glClientWaitSync(fence, waitFlags, g_FenceTimeout);
+			waitFlags = 0;
+		} while (result == GL_TIMEOUT_EXPIRED);
+
+		std::chrono::duration<double, std::milli> waitTime = std::chrono::steady_clock::now() - start;
+		m_stats.blockedWaits++;
+		m_stats.lastWaitMilliseconds = waitTime.count();
+		m_stats.waitMilliseconds += waitTime.count();
+	}
+
+	glDeleteSync(fence);
+	m_fences[m_currentSection] = 0;
+}
+
+/***********************************************************
+ *  EndSection()
+ *
+ *  This method is used for fencing the commands that read
+ *  the current section.  It is called once the frame's draw
+ *  calls have been issued.
+ ***********************************************************/
+void RingBuffer::EndSection()
+{
+	if (m_bufferID == 0)
+	{
+		return;
+	}
+
+	if (m_fences[m_currentSection] != 0)
+	{
+		glDeleteSync(m_fences[m_currentSection]);
+	}
+	m_fences[m_currentSection] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/***********************************************************
+ *  GetBuffer()
+ *
+ *  This method is used for getting the buffer object.
+ ***********************************************************/
+GLuint RingBuffer::GetBuffer() const
+{
+	return(m_bufferID);
+}
+
+/***********************************************************
+ *  GetSectionData()
+ *
+ *  This method is used for getting the mapped memory of the
+ *  current section.  The memory is write-combined on most
+ *  drivers, so it should be written in order and never read.
+ ***********************************************************/
+unsigned char* RingBuffer::GetSectionData() const
+{
+	return(m_pMappedData + m_sectionSize * m_currentSection);
+}
+
+/***********************************************************
+ *  GetSectionOffset()
+ *
+ *  This method is used for getting the offset of the current
+ *  section in the buffer.
+ ***********************************************************/
+GLintptr RingBuffer::GetSectionOffset() const
+{
+	return(m_sectionSize * m_currentSection);
+}
+
+/***********************************************************
+ *  GetSectionSize()
+ *
+ *  This method is used for getting the size of each section.
+ ***********************************************************/
+GLsizeiptr RingBuffer::GetSectionSize() const
+{
+	return(m_sectionSize);
+}
+
+/***********************************************************
+ *  GetSectionCount()
+ *
+ *  This method is used for getting the number of sections.
+ ***********************************************************/
+int RingBuffer::GetSectionCount() const
+{
+	return(m_sectionCount);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the fence wait counters.
+ ***********************************************************/
+const RING_BUFFER_STATS& RingBuffer::GetStats() const
+{
+	return(m_stats);
+}
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// ringbuffer.h
+// ============
+// persistently mapped buffer split into fenced per-frame sections
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <vector>
+
+// sections of a ring buffer, one per frame the GPU may be behind
+const int RING_BUFFER_SECTIONS = 3;
+
+// counters of the waits for the GPU to release a section
+struct RING_BUFFER_STATS
+{
+	int sectionsUsed;				// sections begun since the buffer was created
+	int blockedWaits;				// sections the GPU was still reading when begun
+	double lastWaitMilliseconds;	// time spent waiting to begin the current section
+	double waitMilliseconds;		// time spent waiting over all sections
+};
+
+/***********************************************************
+ *  RingBuffer
+ *
+ *  This class wraps one buffer object created with immutable
+ *  storage and mapped once, persistently and coherently, for
+ *  the life of the buffer.  The buffer is split into sections
+ *  used by successive frames in turn.  The CPU writes the
+ *  data of a frame straight into its section, and a fence
+ *  after the frame's commands tells when the GPU is done
+ *  reading it.  Starting a section only waits on its fence
+ *  when the GPU is a whole ring behind, so there are no
+ *  reallocations, driver copies or implicit stalls.
+ ***********************************************************/
+class RingBuffer
+{
+public:
+	// constructor
+	RingBuffer();
+	// destructor
+	~RingBuffer();
+
+	// create the buffer with room for the sections, any previous
+	// buffer is released, returns false on failure
+	bool Create(GLsizeiptr sectionSize, int sectionCount = RING_BUFFER_SECTIONS);
+	// release the buffer
+	void Destroy();
+	// check whether the buffer has been created
+	bool IsCreated() const;
+
+	// move on to the next section, waiting for the GPU when it is
+	// still reading the section from a ring ago
+	void BeginSection();
+	// fence the commands issued so far, which are the last ones
+	// reading the current section
+	void EndSection();
+
+	// get the buffer object
+	GLuint GetBuffer() const;
+	// get the mapped memory of the current section
+	unsigned char* GetSectionData() const;
+	// get the offset of the current section in the buffer
+	GLintptr GetSectionOffset() const;
+	// get the size of each section
+	GLsizeiptr GetSectionSize() const;
+	// get the number of sections
+	int GetSectionCount() const;
+	// get the fence wait counters
+	const RING_BUFFER_STATS& GetStats() const;
+
+private:
+	// OpenGL buffer object
+	GLuint m_bufferID;
+	// start of the mapped buffer
+	unsigned char* m_pMappedData;
+	// size of each section, a multiple of the largest alignment
+	// a buffer range binding may need
+	GLsizeiptr m_sectionSize;
+	// number of sections and the one being written
+	int m_sectionCount;
+	int m_currentSection;
+	// fence after the last commands reading each section, 0 when
+	// the section is free
+	std::vector<GLsync> m_fences;
+	// fence wait counters
+	RING_BUFFER_STATS m_stats;
+};
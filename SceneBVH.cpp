@@ -0,0 +1,398 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.cpp
+// ============
+// bounding volume hierarchy over the scene objects for frustum culling
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBVH.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// the most objects kept in one leaf node
+	const int g_MaxLeafObjects = 4;
+	// the deepest hierarchy the culling traversal expects
+	const int g_MaxTraversalDepth = 64;
+	// fewest objects worth culling on more than one thread
+	const int g_MinParallelCullObjects = 2048;
+	// subtrees queued per thread, so a thread finishing early
+	// can steal the rest
+	const int g_CullRootsPerThread = 4;
+
+	// result of testing a box against the frustum planes
+	enum FRUSTUM_TEST
+	{
+		FRUSTUM_OUTSIDE,
+		FRUSTUM_CROSSING,
+		FRUSTUM_INSIDE
+	};
+
+	// test a box against the six frustum planes
+	FRUSTUM_TEST TestBox(const glm::vec4 planes[6], const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		FRUSTUM_TEST result = FRUSTUM_INSIDE;
+
+		for (int i = 0; i < 6; i++)
+		{
+			const glm::vec4& plane = planes[i];
+
+			// the box corner furthest along the plane normal
+			glm::vec3 positive = glm::vec3(
+				(plane.x >= 0.0f) ? boundsMax.x : boundsMin.x,
+				(plane.y >= 0.0f) ? boundsMax.y : boundsMin.y,
+				(plane.z >= 0.0f) ? boundsMax.z : boundsMin.z);
+			if (plane.x * positive.x + plane.y * positive.y + plane.z * positive.z + plane.w < 0.0f)
+			{
+				return(FRUSTUM_OUTSIDE);
+			}
+
+			// the box corner furthest against the plane normal
+			glm::vec3 negative = glm::vec3(
+				(plane.x >= 0.0f) ? boundsMin.x : boundsMax.x,
+				(plane.y >= 0.0f) ? boundsMin.y : boundsMax.y,
+				(plane.z >= 0.0f) ? boundsMin.z : boundsMax.z);
+			if (plane.x * negative.x + plane.y * negative.y + plane.z * negative.z + plane.w < 0.0f)
+			{
+				result = FRUSTUM_CROSSING;
+			}
+		}
+
+		return(result);
+	}
+}
+
+/***********************************************************
+ *  SceneBVH()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneBVH::SceneBVH()
+{
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the hierarchy top down.
+ *  Each run of objects is split at the median of the box
+ *  centers along the longest axis of the centers.
+ ***********************************************************/
+void SceneBVH::Build(const std::vector<BVH_BOUNDS>& objectBounds)
+{
+	m_nodes.clear();
+	m_leafBounds.clear();
+	m_objectIndices.resize(objectBounds.size());
+	for (int i = 0; i < m_objectIndices.size(); i++)
+	{
+		m_objectIndices[i] = i;
+	}
+
+	if (objectBounds.size() == 0)
+	{
+		return;
+	}
+
+	// a binary tree over n leaves has fewer than 2n nodes
+	m_nodes.reserve(objectBounds.size() * 2);
+	m_nodes.push_back(BVH_NODE());
+	BuildNode(0, 0, (int)objectBounds.size(), objectBounds);
+
+	// keep the object boxes next to each other for the leaf tests
+	m_leafBounds.resize(m_objectIndices.size());
+	for (int i = 0; i < m_objectIndices.size(); i++)
+	{
+		m_leafBounds[i] = objectBounds[m_objectIndices[i]];
+	}
+}
+
+/***********************************************************
+ *  BuildNode()
+ *
+ *  This method is used for computing the box of a node and
+ *  either keeping its objects as a leaf or splitting them
+ *  between two new child nodes.
+ ***********************************************************/
+void SceneBVH::BuildNode(int nodeIndex, int first, int count, const std::vector<BVH_BOUNDS>& objectBounds)
+{
+	glm::vec3 boundsMin = objectBounds[m_objectIndices[first]].boundsMin;
+	glm::vec3 boundsMax = objectBounds[m_objectIndices[first]].boundsMax;
+	glm::vec3 centerMin = (boundsMin + boundsMax) * 0.5f;
+	glm::vec3 centerMax = centerMin;
+
+	for (int i = first; i < first + count; i++)
+	{
+		const BVH_BOUNDS& bounds = objectBounds[m_objectIndices[i]];
+		glm::vec3 center = (bounds.boundsMin + bounds.boundsMax) * 0.5f;
+		boundsMin = glm::min(boundsMin, bounds.boundsMin);
+		boundsMax = glm::max(boundsMax, bounds.boundsMax);
+		centerMin = glm::min(centerMin, center);
+		centerMax = glm::max(centerMax, center);
+	}
+
+	m_nodes[nodeIndex].boundsMin = boundsMin;
+	m_nodes[nodeIndex].boundsMax = boundsMax;
+
+	if (count <= g_MaxLeafObjects)
+	{
+		m_nodes[nodeIndex].first = first;
+		m_nodes[nodeIndex].objectCount = count;
+		return;
+	}
+
+	// split along the axis where the object centers spread the most
+	glm::vec3 spread = centerMax - centerMin;
+	int axis = 0;
+	if (spread.y > spread.x)
+	{
+		axis = 1;
+	}
+	if (spread.z > spread[axis])
+	{
+		axis = 2;
+	}
+
+	int half = count / 2;
+	std::nth_element(
+		m_objectIndices.begin() + first,
+		m_objectIndices.begin() + first + half,
+		m_objectIndices.begin() + first + count,
+		[&objectBounds, axis](int a, int b)
+		{
+			return((objectBounds[a].boundsMin[axis] + objectBounds[a].boundsMax[axis]) <
+				(objectBounds[b].boundsMin[axis] + objectBounds[b].boundsMax[axis]));
+		});
+
+	int leftChild = (int)m_nodes.size();
+	m_nodes.push_back(BVH_NODE());
+	m_nodes.push_back(BVH_NODE());
+	m_nodes[nodeIndex].first = leftChild;
+	m_nodes[nodeIndex].objectCount = 0;
+
+	BuildNode(leftChild, first, half, objectBounds);
+	BuildNode(leftChild + 1, first + half, count - half, objectBounds);
+}
+
+/***********************************************************
+ *  Refit()
+ *
+ *  This method is used for recomputing the node boxes from
+ *  the current object boxes without changing the tree.
+ *  Children always follow their parent, so walking the
+ *  nodes backwards visits every child before its parent.
+ ***********************************************************/
+void SceneBVH::Refit(const std::vector<BVH_BOUNDS>& objectBounds)
+{
+	for (int i = 0; i < m_objectIndices.size(); i++)
+	{
+		m_leafBounds[i] = objectBounds[m_objectIndices[i]];
+	}
+
+	for (int nodeIndex = (int)m_nodes.size() - 1; nodeIndex >= 0; nodeIndex--)
+	{
+		BVH_NODE& node = m_nodes[nodeIndex];
+
+		if (node.objectCount > 0)
+		{
+			node.boundsMin = m_leafBounds[node.first].boundsMin;
+			node.boundsMax = m_leafBounds[node.first].boundsMax;
+			for (int i = node.first + 1; i < node.first + node.objectCount; i++)
+			{
+				node.boundsMin = glm::min(node.boundsMin, m_leafBounds[i].boundsMin);
+				node.boundsMax = glm::max(node.boundsMax, m_leafBounds[i].boundsMax);
+			}
+		}
+		else
+		{
+			node.boundsMin = glm::min(m_nodes[node.first].boundsMin, m_nodes[node.first + 1].boundsMin);
+			node.boundsMax = glm::max(m_nodes[node.first].boundsMax, m_nodes[node.first + 1].boundsMax);
+		}
+	}
+}
+
+/***********************************************************
+ *  GetObjectCount()
+ *
+ *  This method is used for getting the number of objects the
+ *  hierarchy was built over.
+ ***********************************************************/
+int SceneBVH::GetObjectCount() const
+{
+	return((int)m_objectIndices.size());
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for flagging the objects whose boxes
+ *  are inside of or crossing the view frustum.  The frustum
+ *  planes are taken straight from the rows of the combined
+ *  view-projection matrix.
+ *
+ *  Large hierarchies are split into subtrees near the root
+ *  that are culled as separate jobs.  The subtrees own
+ *  separate objects, so the jobs never write the same flag.
+ *  The nodes above the subtrees are not tested, which does
+ *  not change the result since a child box always lies
+ *  inside of its parent box.
+ ***********************************************************/
+void SceneBVH::Cull(const glm::mat4& viewProjection, std::vector<unsigned char>& visible, CULL_STATS& stats,
+	JobSystem* pJobSystem)
+{
+	visible.assign(m_objectIndices.size(), 0);
+	stats.nodesTested = 0;
+	stats.objectsTested = 0;
+	stats.objectsCulled = 0;
+	stats.objectsDrawn = 0;
+
+	if (m_nodes.size() == 0)
+	{
+		return;
+	}
+
+	// rows of the view-projection matrix
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+	{
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	// left, right, bottom, top, near and far planes
+	glm::vec4 planes[6];
+	planes[0] = rows[3] + rows[0];
+	planes[1] = rows[3] - rows[0];
+	planes[2] = rows[3] + rows[1];
+	planes[3] = rows[3] - rows[1];
+	planes[4] = rows[3] + rows[2];
+	planes[5] = rows[3] - rows[2];
+
+	if ((NULL == pJobSystem) || (pJobSystem->GetThreadCount() == 1) ||
+		(m_objectIndices.size() < g_MinParallelCullObjects))
+	{
+		CullSubtree(planes, 0, visible, stats);
+	}
+	else
+	{
+		// split the inner nodes breadth first until there are
+		// enough subtrees to keep every thread busy
+		int targetRoots = pJobSystem->GetThreadCount() * g_CullRootsPerThread;
+		m_cullRoots.assign(1, 0);
+		for (int i = 0; (i < m_cullRoots.size()) && (m_cullRoots.size() < targetRoots); )
+		{
+			const BVH_NODE& node = m_nodes[m_cullRoots[i]];
+			if (node.objectCount > 0)
+			{
+				i++;
+				continue;
+			}
+			m_cullRoots[i] = node.first;
+			m_cullRoots.push_back(node.first + 1);
+		}
+
+		m_cullRootStats.assign(m_cullRoots.size(), stats);
+		pJobSystem->ParallelFor((int)m_cullRoots.size(), 1,
+			[this, &planes, &visible](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					CullSubtree(planes, m_cullRoots[i], visible, m_cullRootStats[i]);
+				}
+			});
+
+		for (int i = 0; i < m_cullRootStats.size(); i++)
+		{
+			stats.nodesTested += m_cullRootStats[i].nodesTested;
+			stats.objectsTested += m_cullRootStats[i].objectsTested;
+		}
+	}
+
+	for (int i = 0; i < visible.size(); i++)
+	{
+		stats.objectsDrawn += visible[i];
+	}
+	stats.objectsCulled = (int)visible.size() - stats.objectsDrawn;
+}
+
+/***********************************************************
+ *  CullSubtree()
+ *
+ *  This method is used for walking the hierarchy below a node
+ *  and flagging the objects inside of the frustum.  Subtrees
+ *  fully outside are skipped and subtrees fully inside are
+ *  accepted without testing their objects.
+ ***********************************************************/
+void SceneBVH::CullSubtree(const glm::vec4 planes[6], int rootIndex, std::vector<unsigned char>& visible,
+	CULL_STATS& stats) const
+{
+	int stack[g_MaxTraversalDepth];
+	int stackSize = 0;
+	stack[stackSize++] = rootIndex;
+
+	while (stackSize > 0)
+	{
+		int nodeIndex = stack[--stackSize];
+		const BVH_NODE& node = m_nodes[nodeIndex];
+
+		stats.nodesTested++;
+		FRUSTUM_TEST result = TestBox(planes, node.boundsMin, node.boundsMax);
+		if (result == FRUSTUM_OUTSIDE)
+		{
+			continue;
+		}
+		if (result == FRUSTUM_INSIDE)
+		{
+			AcceptSubtree(nodeIndex, visible);
+			continue;
+		}
+
+		if (node.objectCount > 0)
+		{
+			// a leaf crossing the frustum tests its objects one by one
+			for (int i = node.first; i < node.first + node.objectCount; i++)
+			{
+				stats.objectsTested++;
+				if (TestBox(planes, m_leafBounds[i].boundsMin, m_leafBounds[i].boundsMax) != FRUSTUM_OUTSIDE)
+				{
+					visible[m_objectIndices[i]] = 1;
+				}
+			}
+		}
+		else if (stackSize + 2 <= g_MaxTraversalDepth)
+		{
+			stack[stackSize++] = node.first + 1;
+			stack[stackSize++] = node.first;
+		}
+		else
+		{
+			// too deep to keep walking, keep the subtree rather than lose it
+			AcceptSubtree(nodeIndex, visible);
+		}
+	}
+}
+
+/***********************************************************
+ *  AcceptSubtree()
+ *
+ *  This method is used for marking every object below a node
+ *  as visible without testing them.
+ ***********************************************************/
+void SceneBVH::AcceptSubtree(int nodeIndex, std::vector<unsigned char>& visible) const
+{
+	const BVH_NODE& node = m_nodes[nodeIndex];
+
+	if (node.objectCount > 0)
+	{
+		for (int i = node.first; i < node.first + node.objectCount; i++)
+		{
+			visible[m_objectIndices[i]] = 1;
+		}
+		return;
+	}
+
+	AcceptSubtree(node.first, visible);
+	AcceptSubtree(node.first + 1, visible);
+}
@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.h
+// ============
+// bounding volume hierarchy over the scene objects for frustum culling
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "JobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// world-space axis-aligned bounding box of one scene object
+struct BVH_BOUNDS
+{
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+};
+
+// counters from the last culling pass
+struct CULL_STATS
+{
+	int nodesTested;			// hierarchy nodes tested against the frustum
+	int objectsTested;			// object boxes tested against the frustum
+	int objectsCulled;			// objects outside of the frustum
+	int objectsDrawn;			// objects inside or crossing the frustum
+};
+
+/***********************************************************
+ *  SceneBVH
+ *
+ *  This class keeps the bounding boxes of the scene objects
+ *  in a binary bounding volume hierarchy.  Culling walks the
+ *  hierarchy from the root, so a whole subtree outside of
+ *  the view frustum is rejected with one test, and a whole
+ *  subtree inside of it is accepted without testing any of
+ *  its objects.  Moving objects only refits the node boxes;
+ *  the hierarchy is rebuilt when objects are added.
+ ***********************************************************/
+class SceneBVH
+{
+public:
+	// constructor
+	SceneBVH();
+
+	// build the hierarchy over the passed in object boxes
+	void Build(const std::vector<BVH_BOUNDS>& objectBounds);
+	// update the node boxes after objects have moved
+	void Refit(const std::vector<BVH_BOUNDS>& objectBounds);
+	// get the number of objects in the hierarchy
+	int GetObjectCount() const;
+
+	// flag the objects inside the frustum of a view-projection matrix,
+	// visible is resized to one flag per object - the subtrees are
+	// culled in parallel when a job system is passed in
+	void Cull(const glm::mat4& viewProjection, std::vector<unsigned char>& visible, CULL_STATS& stats,
+		JobSystem* pJobSystem = NULL);
+
+private:
+	struct BVH_NODE
+	{
+		glm::vec3 boundsMin;
+		glm::vec3 boundsMax;
+		// leaf - first entry in the object index list,
+		// inner node - index of the first of two child nodes
+		int first;
+		// number of objects in a leaf, 0 for an inner node
+		int objectCount;
+	};
+
+	// hierarchy nodes, the root is node 0 and children always
+	// follow their parent
+	std::vector<BVH_NODE> m_nodes;
+	// object indices ordered so every leaf holds a contiguous run
+	std::vector<int> m_objectIndices;
+	// copy of the object boxes in the same order as the indices
+	std::vector<BVH_BOUNDS> m_leafBounds;
+	// subtrees culled as separate jobs and their counters
+	std::vector<int> m_cullRoots;
+	std::vector<CULL_STATS> m_cullRootStats;
+
+	// split a run of objects into a subtree below a node
+	void BuildNode(int nodeIndex, int first, int count, const std::vector<BVH_BOUNDS>& objectBounds);
+	// cull the objects below a node against the frustum planes
+	void CullSubtree(const glm::vec4 planes[6], int rootIndex, std::vector<unsigned char>& visible,
+		CULL_STATS& stats) const;
+	// mark every object below a node as visible
+	void AcceptSubtree(int nodeIndex, std::vector<unsigned char>& visible) const;
+};
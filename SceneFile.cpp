@@ -0,0 +1,506 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// scene layouts described in a text file and compiled to a mapped binary form
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+#include "MeshLibrary.h"
+#include "DataHash.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+// declaration of global variables
+namespace
+{
+	// identifier at the start of every compiled scene file
+	const char g_SceneFileIdentifier[8] = { 'S', 'C', 'E', 'N', 'E', 'B', 'I', 'N' };
+
+	// extensions of the text and compiled forms of a scene
+	const char* g_TextExtension = ".scene";
+	const char* g_BinaryExtension = ".sceneb";
+
+	// name of every mesh type in the text form, in MESH_TYPE order
+	const char* g_MeshNames[MESH_COUNT] = { "plane", "box", "cylinder", "cone", "sphere", "torus" };
+
+	static_assert(sizeof(SCENE_FILE_HEADER) == 32, "scene file header must be 32 bytes");
+	static_assert(sizeof(SCENE_FILE_OBJECT) == 76, "scene file object record must be 76 bytes");
+
+	// check whether a path ends with an extension
+	bool HasExtension(const char* filename, const char* extension)
+	{
+		size_t length = strlen(filename);
+		size_t extensionLength = strlen(extension);
+		return((length >= extensionLength) && (strcmp(filename + length - extensionLength, extension) == 0));
+	}
+
+	// read a number of values that follow a field name
+	bool ReadValues(std::istream& tokens, float* values, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (!(tokens >> values[i]))
+			{
+				return(false);
+			}
+		}
+		return(true);
+	}
+
+	// read a tag name that follows a field name, and get its index
+	// in the string table, adding it the first time it is seen
+	bool ReadTag(std::istream& tokens, std::vector<std::string>& strings,
+		std::unordered_map<std::string, int>& stringIndices, int32_t& index)
+	{
+		std::string tag;
+		if (!(tokens >> tag))
+		{
+			return(false);
+		}
+
+		std::unordered_map<std::string, int>::iterator found = stringIndices.find(tag);
+		if (found == stringIndices.end())
+		{
+			found = stringIndices.insert(std::make_pair(tag, (int)strings.size())).first;
+			strings.push_back(tag);
+		}
+		index = found->second;
+		return(true);
+	}
+}
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pHeader = NULL;
+	m_pObjects = NULL;
+	m_pStringOffsets = NULL;
+	m_pStrings = NULL;
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for opening a scene.  A text scene is
+ *  hashed and its binary file is only used when it was
+ *  compiled from that same text, otherwise the text is
+ *  compiled again first.  Only when the text file is
+ *  missing is the binary file used as it is; an empty text
+ *  file, which cannot be mapped, is a scene without objects.
+ ***********************************************************/
+bool SceneFile::Open(const char* filename)
+{
+	Close();
+
+	if (HasExtension(filename, g_BinaryExtension) == true)
+	{
+		return(Map(filename, 0, true));
+	}
+
+	std::string binaryPath = GetBinaryPath(filename);
+	MappedFile text;
+	const char* source = "";
+	size_t sourceSize = 0;
+	if (text.Open(filename) == true)
+	{
+		source = (const char*)text.GetData();
+		sourceSize = text.GetSize();
+	}
+	else
+	{
+		FILE* file = fopen(filename, "rb");
+		if (file == NULL)
+		{
+			return(Map(binaryPath.c_str(), 0, true));
+		}
+
+		bool bEmpty = (fseek(file, 0, SEEK_END) == 0) && (ftell(file) == 0);
+		fclose(file);
+		if (bEmpty == false)
+		{
+			std::cout << "Could not read scene file:" << filename << std::endl;
+			return(false);
+		}
+	}
+
+	uint64_t sourceHash = HashData((const unsigned char*)source, sourceSize);
+	if (Map(binaryPath.c_str(), sourceHash, false) == true)
+	{
+		return(true);
+	}
+
+	if (CompileText(source, sourceSize, filename, binaryPath.c_str()) == false)
+	{
+		return(false);
+	}
+
+	return(Map(binaryPath.c_str(), sourceHash, false));
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the scene.
+ ***********************************************************/
+void SceneFile::Close()
+{
+	m_file.Close();
+	m_pHeader = NULL;
+	m_pObjects = NULL;
+	m_pStringOffsets = NULL;
+	m_pStrings = NULL;
+}
+
+/***********************************************************
+ *  GetObjectCount()
+ *
+ *  This method is used for getting the number of objects in
+ *  the open scene.
+ ***********************************************************/
+int SceneFile::GetObjectCount() const
+{
+	return((NULL == m_pHeader) ? 0 : (int)m_pHeader->objectCount);
+}
+
+/***********************************************************
+ *  GetObjects()
+ *
+ *  This method is used for getting the object records of
+ *  the open scene, which point into the mapped file.
+ ***********************************************************/
+const SCENE_FILE_OBJECT* SceneFile::GetObjects() const
+{
+	return(m_pObjects);
+}
+
+/***********************************************************
+ *  GetStringCount()
+ *
+ *  This method is used for getting the number of strings in
+ *  the string table.
+ ***********************************************************/
+int SceneFile::GetStringCount() const
+{
+	return((NULL == m_pHeader) ? 0 : (int)m_pHeader->stringCount);
+}
+
+/***********************************************************
+ *  GetString()
+ *
+ *  This method is used for getting a string of the string
+ *  table, which points into the mapped file.
+ ***********************************************************/
+const char* SceneFile::GetString(int index) const
+{
+	return(m_pStrings + m_pStringOffsets[index]);
+}
+
+/***********************************************************
+ *  Compile()
+ *
+ *  This method is used for compiling the text form of a
+ *  scene into a binary file.
+ ***********************************************************/
+bool SceneFile::Compile(const char* textFilename, const char* binaryFilename)
+{
+	MappedFile text;
+	if (text.Open(textFilename) == false)
+	{
+		std::cout << "Could not read scene file:" << textFilename << std::endl;
+		return(false);
+	}
+
+	return(CompileText((const char*)text.GetData(), text.GetSize(), textFilename, binaryFilename));
+}
+
+/***********************************************************
+ *  GetBinaryPath()
+ *
+ *  This method is used for getting the path of the binary
+ *  file the text form of a scene is compiled to, which sits
+ *  next to the text file.
+ ***********************************************************/
+std::string SceneFile::GetBinaryPath(const char* textFilename)
+{
+	if (HasExtension(textFilename, g_TextExtension) == true)
+	{
+		return(std::string(textFilename) + "b");
+	}
+
+	return(std::string(textFilename) + g_BinaryExtension);
+}
+
+/***********************************************************
+ *  Map()
+ *
+ *  This method is used for mapping a binary scene file and
+ *  finding its parts.  The sizes in the header must add up
+ *  to the size of the file, every string must end inside of
+ *  the string table, and every record must name a known
+ *  mesh and strings that exist, so the records can be used
+ *  without any further checks.
+ ***********************************************************/
+bool SceneFile::Map(const char* binaryFilename, uint64_t sourceHash, bool bAnySource)
+{
+	if (m_file.Open(binaryFilename) == false)
+	{
+		return(false);
+	}
+
+	const SCENE_FILE_HEADER* header = (const SCENE_FILE_HEADER*)m_file.GetData();
+	if ((m_file.GetSize() < sizeof(SCENE_FILE_HEADER)) ||
+		(memcmp(header->identifier, g_SceneFileIdentifier, sizeof(g_SceneFileIdentifier)) != 0) ||
+		(header->version != SCENE_FILE_VERSION) ||
+		((bAnySource == false) && (header->sourceHash != sourceHash)))
+	{
+		Close();
+		return(false);
+	}
+
+	uint64_t expectedSize = sizeof(SCENE_FILE_HEADER) +
+		(uint64_t)header->objectCount * sizeof(SCENE_FILE_OBJECT) +
+		(uint64_t)header->stringCount * sizeof(uint32_t) +
+		header->stringBytes;
+	if (expectedSize != m_file.GetSize())
+	{
+		Close();
+		return(false);
+	}
+
+	const unsigned char* data = m_file.GetData() + sizeof(SCENE_FILE_HEADER);
+	const SCENE_FILE_OBJECT* objects = (const SCENE_FILE_OBJECT*)data;
+	data += header->objectCount * sizeof(SCENE_FILE_OBJECT);
+	const uint32_t* stringOffsets = (const uint32_t*)data;
+	data += header->stringCount * sizeof(uint32_t);
+	const char* strings = (const char*)data;
+
+	bool bValid = (header->stringCount == 0) ||
+		((header->stringBytes > 0) && (strings[header->stringBytes - 1] == 0));
+	for (uint32_t i = 0; (i < header->stringCount) && (bValid == true); i++)
+	{
+		bValid = (stringOffsets[i] < header->stringBytes);
+	}
+	int32_t stringCount = (int32_t)header->stringCount;
+	for (uint32_t i = 0; (i < header->objectCount) && (bValid == true); i++)
+	{
+		const SCENE_FILE_OBJECT& object = objects[i];
+		bValid = (object.mesh < MESH_COUNT) &&
+			(object.texture >= -1) && (object.texture < stringCount) &&
+			(object.material >= -1) && (object.material < stringCount);
+	}
+	if (bValid == false)
+	{
+		std::cout << "Scene file is damaged:" << binaryFilename << std::endl;
+		Close();
+		return(false);
+	}
+
+	m_pHeader = header;
+	m_pObjects = objects;
+	m_pStringOffsets = stringOffsets;
+	m_pStrings = strings;
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompileText()
+ *
+ *  This method is used for compiling scene text into a
+ *  binary file.  The file is written under a temporary name
+ *  and renamed when complete, so a partly written file is
+ *  never mapped.
+ ***********************************************************/
+bool SceneFile::CompileText(const char* text, size_t size, const char* textFilename,
+	const char* binaryFilename)
+{
+	std::vector<SCENE_FILE_OBJECT> objects;
+	std::vector<std::string> strings;
+	if (ParseText(text, size, textFilename, objects, strings) == false)
+	{
+		return(false);
+	}
+
+	// each string keeps its null terminator in the table
+	std::vector<uint32_t> stringOffsets(strings.size());
+	uint32_t stringBytes = 0;
+	for (int i = 0; i < strings.size(); i++)
+	{
+		stringOffsets[i] = stringBytes;
+		stringBytes += (uint32_t)strings[i].size() + 1;
+	}
+
+	SCENE_FILE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.identifier, g_SceneFileIdentifier, sizeof(g_SceneFileIdentifier));
+	header.version = SCENE_FILE_VERSION;
+	header.objectCount = (uint32_t)objects.size();
+	header.stringCount = (uint32_t)strings.size();
+	header.stringBytes = stringBytes;
+	header.sourceHash = HashData((const unsigned char*)text, size);
+
+	std::string tempPath = std::string(binaryFilename) + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (file == NULL)
+	{
+		std::cout << "Could not write scene file:" << binaryFilename << std::endl;
+		return(false);
+	}
+
+	bool bWritten = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+		(fwrite(objects.data(), sizeof(SCENE_FILE_OBJECT), objects.size(), file) == objects.size()) &&
+		(fwrite(stringOffsets.data(), sizeof(uint32_t), stringOffsets.size(), file) == stringOffsets.size());
+	for (int i = 0; (i < strings.size()) && (bWritten == true); i++)
+	{
+		bWritten = (fwrite(strings[i].c_str(), 1, strings[i].size() + 1, file) == strings[i].size() + 1);
+	}
+	bWritten = (fclose(file) == 0) && bWritten;
+
+	// replace any older file with the new one
+	remove(binaryFilename);
+	if ((bWritten == false) || (rename(tempPath.c_str(), binaryFilename) != 0))
+	{
+		std::cout << "Could not write scene file:" << binaryFilename << std::endl;
+		remove(tempPath.c_str());
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ParseText()
+ *
+ *  This method is used for turning scene text into object
+ *  records.  Each line holding an object starts with the
+ *  word object and its mesh, followed by any of these
+ *  fields in any order - fields left out keep the value
+ *  shown:
+ *
+ *    object box scale 1 1 1 rotation 0 0 0 position 0 0 0
+ *        color 1 1 1 1 texture wood uv 1 1 material plastic
+ *        dynamic
+ *
+ *  Everything after a # is a comment.  A tag names a
+ *  texture or material loaded by the scene code, and each
+ *  tag is stored once in the string table.
+ ***********************************************************/
+bool SceneFile::ParseText(const char* text, size_t size, const char* textFilename,
+	std::vector<SCENE_FILE_OBJECT>& objects, std::vector<std::string>& strings)
+{
+	std::istringstream lines(std::string(text, size));
+	std::unordered_map<std::string, int> stringIndices;
+	std::string line;
+	int lineNumber = 0;
+
+	while (std::getline(lines, line))
+	{
+		lineNumber++;
+
+		size_t comment = line.find('#');
+		if (comment != std::string::npos)
+		{
+			line.erase(comment);
+		}
+
+		std::istringstream tokens(line);
+		std::string keyword;
+		if (!(tokens >> keyword))
+		{
+			continue;
+		}
+
+		SCENE_FILE_OBJECT object;
+		memset(&object, 0, sizeof(object));
+		object.scale[0] = object.scale[1] = object.scale[2] = 1.0f;
+		object.color[0] = object.color[1] = object.color[2] = object.color[3] = 1.0f;
+		object.uvScale[0] = object.uvScale[1] = 1.0f;
+		object.mesh = MESH_COUNT;
+		object.texture = -1;
+		object.material = -1;
+
+		std::string meshName;
+		bool bValid = (keyword == "object") && (tokens >> meshName);
+		for (int mesh = 0; (mesh < MESH_COUNT) && (bValid == true); mesh++)
+		{
+			if (meshName == g_MeshNames[mesh])
+			{
+				object.mesh = mesh;
+			}
+		}
+		bValid = bValid && (object.mesh < MESH_COUNT);
+
+		std::string field;
+		while ((bValid == true) && (tokens >> field))
+		{
+			if (field == "scale")
+			{
+				bValid = ReadValues(tokens, object.scale, 3);
+			}
+			else if (field == "rotation")
+			{
+				bValid = ReadValues(tokens, object.rotation, 3);
+			}
+			else if (field == "position")
+			{
+				bValid = ReadValues(tokens, object.position, 3);
+			}
+			else if (field == "color")
+			{
+				bValid = ReadValues(tokens, object.color, 4);
+			}
+			else if (field == "uv")
+			{
+				bValid = ReadValues(tokens, object.uvScale, 2);
+			}
+			else if (field == "texture")
+			{
+				bValid = ReadTag(tokens, strings, stringIndices, object.texture);
+			}
+			else if (field == "material")
+			{
+				bValid = ReadTag(tokens, strings, stringIndices, object.material);
+			}
+			else if (field == "dynamic")
+			{
+				object.flags |= SCENE_OBJECT_DYNAMIC;
+			}
+			else
+			{
+				bValid = false;
+			}
+		}
+
+		if (bValid == false)
+		{
+			std::cout << "Scene file error:" << textFilename << " line " << lineNumber
+				<< ": " << line << std::endl;
+			return(false);
+		}
+
+		objects.push_back(object);
+	}
+
+	return(true);
+}
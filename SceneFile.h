@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// scene layouts described in a text file and compiled to a mapped binary form
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// version of the compiled layout, files of any other version are
+// compiled again
+const uint32_t SCENE_FILE_VERSION = 1;
+
+// the object moves every frame and is drawn over the cached shadows
+const uint32_t SCENE_OBJECT_DYNAMIC = 1;
+
+// header at the start of a compiled scene file, followed by the
+// object records, the offset of every string in the string table
+// and the null terminated strings themselves
+struct SCENE_FILE_HEADER
+{
+	char identifier[8];
+	uint32_t version;
+	uint32_t objectCount;
+	uint32_t stringCount;
+	uint32_t stringBytes;
+	uint64_t sourceHash;		// hash of the text the file was compiled from
+};
+
+// fixed-size record of one object in a compiled scene file
+struct SCENE_FILE_OBJECT
+{
+	float scale[3];
+	float rotation[3];			// degrees around the X, Y and Z axes
+	float position[3];
+	float color[4];
+	float uvScale[2];
+	uint32_t mesh;				// a MESH_TYPE
+	int32_t texture;			// string table index of the texture tag, -1 for none
+	int32_t material;			// string table index of the material tag, -1 for none
+	uint32_t flags;				// SCENE_OBJECT_ flags
+};
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class reads the objects of a scene layout.  Scenes
+ *  are written as text, one object per line, and compiled
+ *  into a flat binary file of fixed-size records with every
+ *  tag name kept once in a string table.  The binary file is
+ *  mapped and its records are used in place, so loading a
+ *  scene never parses an object.  The text form is compiled
+ *  again whenever it no longer matches the binary file, and
+ *  a scene can be shipped as the binary file alone.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+	// open a scene from its text form, compiling it first when
+	// needed, or straight from a binary file, returns false if
+	// the scene cannot be read
+	bool Open(const char* filename);
+	// unmap the scene
+	void Close();
+
+	// get the object records of the open scene
+	int GetObjectCount() const;
+	const SCENE_FILE_OBJECT* GetObjects() const;
+	// get the strings of the string table
+	int GetStringCount() const;
+	const char* GetString(int index) const;
+
+	// compile the text form of a scene into a binary file,
+	// returns false if the text has an error
+	static bool Compile(const char* textFilename, const char* binaryFilename);
+	// get the path the text form of a scene is compiled to
+	static std::string GetBinaryPath(const char* textFilename);
+
+private:
+	// the mapped binary file and its parts
+	MappedFile m_file;
+	const SCENE_FILE_HEADER* m_pHeader;
+	const SCENE_FILE_OBJECT* m_pObjects;
+	const uint32_t* m_pStringOffsets;
+	const char* m_pStrings;
+
+	// map a binary file and check its layout, and that it was
+	// compiled from the expected text unless bAnySource is set
+	bool Map(const char* binaryFilename, uint64_t sourceHash, bool bAnySource);
+	// compile scene text that has already been read
+	static bool CompileText(const char* text, size_t size, const char* textFilename,
+		const char* binaryFilename);
+	// turn scene text into object records and a string table,
+	// returns false on the first line with an error
+	static bool ParseText(const char* text, size_t size, const char* textFilename,
+		std::vector<SCENE_FILE_OBJECT>& objects, std::vector<std::string>& strings);
+};
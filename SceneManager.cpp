@@ -1,649 +1,1792 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.cpp
-// ============
-// manage the preparing and rendering of 3D scenes - textures, materials, lighting
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-	m_loadedTextures = 0;
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationZ * rotationY * rotationX * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -5;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-		}
-	}
-}
-
-//loading textures for the scene
-void SceneManager::LoadSceneTextures()
-{
-	//loads image wood for wooden texture on desk
-	CreateGLTexture("Textures/wood.jpg", "wood");
-	//loads image wood for wooden texture on desk
-	CreateGLTexture("Textures/keyboard.jpg", "keyboard");
-	//loads image wood for wooden texture on desk
-	CreateGLTexture("Textures/notebook.jpg", "notebook");
-	//loads image wood for wooden texture on desk
-	CreateGLTexture("Textures/mug.jpg", "mug");
-	
-
-	// Bind the loaded textures to texture units
-	BindGLTextures();
-}
-
-
-
-
-
-void SceneManager::DefineObjectMaterials()
-{
-	// Glass material 
-	OBJECT_MATERIAL glass;
-	glass.tag = "glass";
-	glass.diffuseColor = glm::vec3(0.10f, 0.10f, 0.10f); 
-	glass.specularColor = glm::vec3(0.90f, 0.90f, 0.90f); 
-	glass.shininess = 128.0f;                        
-	glass.ambientColor = glm::vec3(0.60f, 0.60f, 0.60f); 
-	glass.ambientStrength = 40.0f;
-	m_objectMaterials.push_back(glass);
-	//plastic material
-	OBJECT_MATERIAL plastic;
-	plastic.tag = "plastic";
-	plastic.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);   
-	plastic.specularColor = glm::vec3(0.5f, 0.5f, 0.5f);   
-	plastic.shininess = 80.0f;                      
-	plastic.ambientColor = glm::vec3(0.15f, 0.15f, 0.15f);
-	plastic.ambientStrength = 1.0f;
-	m_objectMaterials.push_back(plastic);
-
-	
-}
-
-void SceneManager::SetupSceneLights()
-{
-	m_pShaderManager->setBoolValue("bUseLighting", true);
-	
-
-	// put the point light around the top left of the keyboard/monitor to try and simulate sunlight
-	m_pShaderManager->setBoolValue("pointLights[2].bActive", true);
-	m_pShaderManager->setVec3Value("pointLights[2].position", glm::vec3(-1.20f, 1.00f, -1.20f)); 
-	m_pShaderManager->setVec3Value("pointLights[2].ambient", glm::vec3(0.32f, 0.30f, 0.22f));
-	m_pShaderManager->setVec3Value("pointLights[2].diffuse", glm::vec3(3.00f, 2.80f, 2.50f));
-	m_pShaderManager->setVec3Value("pointLights[2].specular", glm::vec3(3.50f, 3.40f, 3.10f));
-
-	
-
-
-}
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-	//defining texture and object materials
-	DefineObjectMaterials();
-	LoadSceneTextures();
-
-	m_basicMeshes->LoadPlaneMesh();//desk
-	m_basicMeshes->LoadCylinderMesh(); // desk stand/mug
-	m_basicMeshes->LoadBoxMesh();//notebooks
-	m_basicMeshes->LoadConeMesh();//pencil tips/ hump for mouse
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadTorusMesh();//handle for mug
-
-	
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-
-	//setting up lights in the scene
-	SetupSceneLights();
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(0.96f, 0.87f, 0.70f, 1.0f);//setting the desk to white
-	SetShaderTexture("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	/****************************************************************/
-	
-
-	
-	
-	// Base disk for computer
-	scaleXYZ = glm::vec3(0.70f, 0.05f, 0.70f);
-	positionXYZ = glm::vec3(0.0f, 0.025f, -1.0f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderColor(1.0f, 1.0f, 1.0f, 1.0f);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// Stand for computer
-	scaleXYZ = glm::vec3(0.10f, 0.25f, 0.10f);
-	positionXYZ = glm::vec3(0.0f, 0.175f, -1.0f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderColor(1.0f, 1.0f, 1.0f, 1.0f);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// edges of the computer
-	scaleXYZ = glm::vec3(1.80f, 0.50f, 0.06f); 
-	positionXYZ = glm::vec3(0.0f, 0.55f, -1.0f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderColor(0.02f, 0.02f, 0.03f, 1.0f);
-	SetShaderMaterial("glass");
-	m_basicMeshes->DrawBoxMesh();
-
-	// Screen of the computer
-	scaleXYZ = glm::vec3(1.74f, 0.45f, 0.03f);
-	positionXYZ = glm::vec3(0.0f, 0.550f, -0.98f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderColor(1.0f, 1.0f, 1.0f, 1.0f);
-	SetShaderMaterial("glass");
-	m_basicMeshes->DrawBoxMesh();
-
-	//keyboard	
-	scaleXYZ = glm::vec3(1.6f, 0.05f, 0.45f);
-	positionXYZ = glm::vec3(0.0f, 0.025f, 0.30f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderTexture("keyboard");
-	m_basicMeshes->DrawBoxMesh();
-
-	// Base of the mouse
-	scaleXYZ = glm::vec3(0.22f, 0.05f, 0.30f);
-	positionXYZ = glm::vec3(1.05f, 0.025f, 0.35f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderColor(1.0f, 1.0f, 1.0f, 1.0f);
-	SetShaderMaterial("plastic");
-	m_basicMeshes->DrawBoxMesh();
-
-	// Hump simulating the arch of a mouse
-	scaleXYZ = glm::vec3(0.15f, 0.10f, 0.15f);
-	positionXYZ = glm::vec3(1.05f, 0.100f, 0.35f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderMaterial("plastic");
-	m_basicMeshes->DrawConeMesh();
-
-	
-	// Mug body 
-	scaleXYZ = glm::vec3(0.20f, 0.35f, 0.20f);
-	positionXYZ = glm::vec3(1.8f, 0.175f, -0.6f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f); 
-	m_basicMeshes->DrawCylinderMesh();
-
-	// Rim of the mug
-	scaleXYZ = glm::vec3(0.215f, 0.015f, 0.215f);
-	positionXYZ = glm::vec3(1.80f, 0.3575f, -0.6f);
-	SetTransformations(scaleXYZ,0, 0, 0, positionXYZ);
-	SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// Handle of the mug
-	scaleXYZ = glm::vec3(0.13f, 0.035f, 0.13f);
-	XrotationDegrees = 180.0f; YrotationDegrees = 0.0f; ZrotationDegrees = 0.0f;
-	positionXYZ = glm::vec3(2.02f, 0.355f, -0.60f);
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
-	SetShaderColor(0.5f, 0.5f, 0.5f, 1.0f);
-	m_basicMeshes->DrawTorusMesh();
-
-	
-	// Pencil 1 
-	scaleXYZ = glm::vec3(0.03f, 0.5f, 0.03f);
-	positionXYZ = glm::vec3(1.77f, 0.18f, -0.62f);
-	SetTransformations(scaleXYZ, 0, 10.0f, 0, positionXYZ);
-	SetShaderColor(0.0f, 0.0f, 0.0f, 1.0f);
-	m_basicMeshes->DrawCylinderMesh();
-	// Tip of pencil 1
-	scaleXYZ = glm::vec3(0.03f, 0.4f, 0.03f);
-	positionXYZ = glm::vec3(1.77f, 0.42f, -0.62f);
-	SetTransformations(scaleXYZ, 0, 10.0f, 0, positionXYZ);
-	SetShaderColor(0.30f, 0.20f, 0.15f, 1.0f);
-	m_basicMeshes->DrawConeMesh();
-
-	// Pencil 2
-	scaleXYZ = glm::vec3(0.03f, 0.5f, 0.03f);
-	positionXYZ = glm::vec3(1.835f, 0.175f, -0.585f);
-	SetTransformations(scaleXYZ, 0, -8.0f, 0, positionXYZ);
-	SetShaderColor(0.0f, 0.0f, 0.0f, 1.0f);
-	m_basicMeshes->DrawCylinderMesh();
-	//tip of pencil 2
-	scaleXYZ = glm::vec3(0.03f, 0.4f, 0.03f);
-	positionXYZ = glm::vec3(1.83f, 0.425f, -0.585f);
-	SetTransformations(scaleXYZ, 0, -8.0f, 0, positionXYZ);
-	SetShaderColor(0.30f, 0.20f, 0.15f, 1.0f);
-	m_basicMeshes->DrawConeMesh();
-
-	// Pencil 3
-	scaleXYZ = glm::vec3(0.03f, 0.4f, 0.03f);
-	positionXYZ = glm::vec3(1.75f, 0.178f, -0.555f);
-	SetTransformations(scaleXYZ, 0, 4.0f, 0, positionXYZ);
-	SetShaderColor(0.0f, 0.0f, 0.0f, 1.0f);
-	m_basicMeshes->DrawCylinderMesh();
-	//tip of pencil 3
-	scaleXYZ = glm::vec3(0.03f, 0.5f, 0.03f);
-	positionXYZ = glm::vec3(1.75f, 0.428f, -0.555f);
-	SetTransformations(scaleXYZ, 0, 4.0f, 0, positionXYZ);
-	SetShaderColor(0.30f, 0.20f, 0.15f, 1.0f);
-	m_basicMeshes->DrawConeMesh();
-
-	
-	// Book 1 
-	scaleXYZ = glm::vec3(0.40f, 0.07f, 0.60f);
-	positionXYZ = glm::vec3(-2.60f, 0.035f, -0.20f);
-	SetTransformations(scaleXYZ, 0, 0, 0, positionXYZ);
-	SetShaderColor(0.85f, 0.85f, 0.85f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Book 2
-	scaleXYZ = glm::vec3(0.42f, 0.08f, 0.58f);
-	positionXYZ = glm::vec3(-2.10f, 0.04f, -0.18f);
-	SetTransformations(scaleXYZ, 0, 2.5f, 0, positionXYZ);
-	SetShaderColor(0.85f, 0.85f, 0.85f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Book 3
-	scaleXYZ = glm::vec3(0.38f, 0.06f, 0.62f);
-	positionXYZ = glm::vec3(-1.7f, 0.03f, -0.22f);
-	SetTransformations(scaleXYZ, 0, -6.0f, 0, positionXYZ);
-	SetShaderColor(0.85f, 0.85f, 0.85f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-}
-	
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.cpp
+// ============
+// manage the preparing and rendering of 3D scenes - textures, materials, lighting
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+#include "SceneFile.h"
+#include "DataHash.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+// declaration of global variables
+namespace
+{
+	const char* g_TextureSamplerName = "objectTexture";
+	const char* g_LightClusterShaderName = "shaders/lightClusterComputeShader.glsl";
+	const char* g_ShadowVertexShaderName = "shaders/shadowVertexShader.glsl";
+	const char* g_ShadowFragmentShaderName = "shaders/shadowFragmentShader.glsl";
+	const char* g_DefaultSceneFilename = "scenes/desk.scene";
+
+	// reach of the shadows of lights that light the whole scene
+	const float g_UnlimitedShadowReach = 30.0f;
+
+	// time each frame may spend uploading newly decoded textures
+	const double g_TextureUploadBudget = 2.0;
+	// color drawn on textured objects until their texture arrives
+	const glm::vec4 g_PlaceholderColor = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
+	// objects handled by one job of the parallel scene update
+	const int g_ObjectsPerJob = 256;
+	// scratch memory set aside for each frame, it grows to fit a
+	// frame that needs more
+	const size_t g_FrameArenaSize = 256 * 1024;
+	// defines the scene shaders are built with for each feature
+	const char* g_ShaderFeatureDefines[] = { "#define USE_TEXTURE\n", "#define USE_LIGHTING\n" };
+
+	// projected size in pixels below which an object moves from
+	// one level of detail to the next coarser one, and the share
+	// of that size an object must pass it by before switching, so
+	// objects near a threshold do not flip between levels
+	const float g_LodScreenSizes[MESH_LOD_COUNT - 1] = { 150.0f, 50.0f };
+	const float g_LodHysteresis = 0.15f;
+
+	// pick the level of detail for a projected size, starting at
+	// the level the object was drawn with - flat shapes are the same
+	// mesh at every level, so they stay at the finest and are not
+	// split into a draw per level
+	int SelectLod(MESH_TYPE mesh, int currentLod, float screenSize)
+	{
+		if ((mesh == MESH_PLANE) || (mesh == MESH_BOX))
+		{
+			return(0);
+		}
+
+		int lod = currentLod;
+		while ((lod > 0) && (screenSize > g_LodScreenSizes[lod - 1] * (1.0f + g_LodHysteresis)))
+		{
+			lod--;
+		}
+		while ((lod < MESH_LOD_COUNT - 1) && (screenSize < g_LodScreenSizes[lod] * (1.0f - g_LodHysteresis)))
+		{
+			lod++;
+		}
+		return(lod);
+	}
+
+	// copy a scene file record with its tags resolved to texture
+	// and material indices, so records of different versions of
+	// a file can be compared
+	SCENE_FILE_OBJECT ResolveRecord(
+		const SCENE_FILE_OBJECT& record,
+		const std::vector<int>& textureIndices,
+		const std::vector<int>& materialIndices)
+	{
+		SCENE_FILE_OBJECT resolved = record;
+		resolved.texture = (record.texture >= 0) ? textureIndices[record.texture] : -1;
+		resolved.material = (record.material >= 0) ? materialIndices[record.material] : -1;
+		return(resolved);
+	}
+
+	// loaded scene file records found by the hash of their contents
+	typedef std::unordered_multimap<uint64_t, int>::iterator RECORD_MAP_ITERATOR;
+
+	// hash a resolved scene file record, which has no padding
+	uint64_t HashRecord(const SCENE_FILE_OBJECT& record)
+	{
+		return(HashData((const unsigned char*)&record, sizeof(record)));
+	}
+
+	// run a loop over the job system, or straight through on
+	// this thread when there is none
+	void RunParallel(JobSystem* pJobSystem, int count, int grainSize, const JobSystem::RANGE_FUNCTION& function)
+	{
+		if (NULL == pJobSystem)
+		{
+			function(0, count);
+		}
+		else
+		{
+			pJobSystem->ParallelFor(count, grainSize, function);
+		}
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager *pShaderManager)
+{
+	m_pShaderManager = pShaderManager;
+	m_pProfiler = NULL;
+	m_pJobSystem = NULL;
+	m_sceneFilename = g_DefaultSceneFilename;
+	for (int i = 0; i < SHADER_VARIANT_COUNT; i++)
+	{
+		m_textureUnitLocations[i] = -1;
+		m_textureUnitValues[i] = -1;
+	}
+	m_basicMeshes = new MeshLibrary();
+	m_pTextureManager = new TextureManager();
+	m_bInstancesDirty = true;
+	m_bBoundsDirty = true;
+	m_bLightsDirty = true;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_viewportSize = glm::vec2(1.0f);
+	m_viewProjection = glm::mat4(1.0f);
+	m_bCullingEnabled = false;
+	m_bQueueDirty = true;
+	m_pendingFrameUploads = 0;
+	memset(&m_cullStats, 0, sizeof(m_cullStats));
+	memset(&m_renderStats, 0, sizeof(m_renderStats));
+	memset(&m_textureUnitStats, 0, sizeof(m_textureUnitStats));
+	m_frameArena.Reserve(g_FrameArenaSize);
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pShaderManager = NULL;
+	DestroyGLTextures();
+	delete m_pTextureManager;
+	m_pTextureManager = NULL;
+	delete m_basicMeshes;
+	m_basicMeshes = NULL;
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for queuing textures from image files
+ *  to be decoded in the background by the texture manager,
+ *  which packs them into texture arrays.  There is no fixed
+ *  limit on the number of textures.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, const char* tag)
+{
+	return(m_pTextureManager->LoadTexture(filename, tag) >= 0);
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for allocating the texture arrays for
+ *  the loaded textures and binding them to texture units.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	m_pTextureManager->BuildTextureArrays();
+	m_pTextureManager->BindTextureArrays();
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory of all the
+ *  texture arrays.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	m_pTextureManager->DestroyTextures();
+}
+
+/***********************************************************
+ *  FindTextureIndex()
+ *
+ *  This method is used for getting the index of the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureIndex(TAG_ID tag)
+{
+	return(m_pTextureManager->FindTexture(tag));
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of a previously
+ *  defined material that is associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(TAG_ID tag)
+{
+	return(m_materialTags.Find(tag));
+}
+
+/***********************************************************
+ *  AddSceneObject()
+ *
+ *  This method is used for recording an object into the
+ *  retained draw list.  The returned index is used for any
+ *  later changes to the recorded object.
+ ***********************************************************/
+int SceneManager::AddSceneObject(
+	MESH_TYPE mesh,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	SCENE_OBJECT object;
+
+	object.mesh = mesh;
+	object.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	object.textureIndex = -1;
+	object.UVscale = glm::vec2(1.0f, 1.0f);
+	object.materialIndex = -1;
+	object.bounds.boundsMin = positionXYZ;
+	object.bounds.boundsMax = positionXYZ;
+	object.lod = 0;
+	object.shaderVariant = 0;
+
+	SHADOW_CASTER caster;
+	caster.model = glm::mat4(1.0f);
+	caster.bounds = object.bounds;
+	caster.mesh = mesh;
+	caster.bDynamic = false;
+
+	m_sceneObjects.push_back(object);
+	m_shadowCasters.push_back(caster);
+	m_transforms.Add(scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
+	m_bInstancesDirty = true;
+
+	return((int)m_sceneObjects.size() - 1);
+}
+
+/***********************************************************
+ *  SetObjectTransformations()
+ *
+ *  This method is used for changing the transformation values
+ *  of a recorded object.  The object is marked dirty so its
+ *  model matrix is recomputed before the next draw.
+ ***********************************************************/
+void SceneManager::SetObjectTransformations(
+	int index,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	if ((index < 0) || (index >= m_sceneObjects.size()))
+	{
+		return;
+	}
+
+	m_transforms.Set(index, scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
+	m_bInstancesDirty = true;
+}
+
+/***********************************************************
+ *  SetObjectColor()
+ *
+ *  This method is used for changing the color of a recorded
+ *  object.  Setting a color turns off texturing, the same as
+ *  SetShaderColor() does.
+ ***********************************************************/
+void SceneManager::SetObjectColor(
+	int index,
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	if ((index < 0) || (index >= m_sceneObjects.size()))
+	{
+		return;
+	}
+
+	m_sceneObjects[index].color = glm::vec4(
+		redColorValue,
+		greenColorValue,
+		blueColorValue,
+		alphaValue);
+	m_sceneObjects[index].textureIndex = -1;
+	m_bInstancesDirty = true;
+}
+
+/***********************************************************
+ *  SetObjectTexture()
+ *
+ *  This method is used for changing the texture of a recorded
+ *  object.  The tag ID is resolved to a texture index once
+ *  here instead of on every draw.
+ ***********************************************************/
+void SceneManager::SetObjectTexture(
+	int index,
+	TAG_ID textureTag)
+{
+	if ((index < 0) || (index >= m_sceneObjects.size()))
+	{
+		return;
+	}
+
+	m_sceneObjects[index].textureIndex = FindTextureIndex(textureTag);
+	m_bInstancesDirty = true;
+}
+
+/***********************************************************
+ *  SetObjectUVScale()
+ *
+ *  This method is used for changing the texture UV scale of
+ *  a recorded object.
+ ***********************************************************/
+void SceneManager::SetObjectUVScale(int index, float u, float v)
+{
+	if ((index < 0) || (index >= m_sceneObjects.size()))
+	{
+		return;
+	}
+
+	m_sceneObjects[index].UVscale = glm::vec2(u, v);
+	m_bInstancesDirty = true;
+}
+
+/***********************************************************
+ *  SetObjectMaterial()
+ *
+ *  This method is used for changing the material of a recorded
+ *  object.  The tag ID is resolved to a material index once
+ *  here instead of on every draw.
+ ***********************************************************/
+void SceneManager::SetObjectMaterial(
+	int index,
+	TAG_ID materialTag)
+{
+	if ((index < 0) || (index >= m_sceneObjects.size()))
+	{
+		return;
+	}
+
+	m_sceneObjects[index].materialIndex = FindMaterialIndex(materialTag);
+	m_bInstancesDirty = true;
+}
+
+/***********************************************************
+ *  SetObjectDynamic()
+ *
+ *  This method is used for marking a recorded object as one
+ *  that moves every frame.  A dynamic object is left out of
+ *  the cached shadow maps and drawn over them each frame, so
+ *  moving it never renders the cache again.
+ ***********************************************************/
+void SceneManager::SetObjectDynamic(
+	int index,
+	bool bDynamic)
+{
+	if ((index < 0) || (index >= m_sceneObjects.size()) ||
+		(m_shadowCasters[index].bDynamic == bDynamic))
+	{
+		return;
+	}
+
+	// the cache gains or loses the object's shadow
+	m_shadowMaps.InvalidateBounds(m_shadowCasters[index].bounds);
+	m_shadowCasters[index].bDynamic = bDynamic;
+
+	// the list is checked rather than trusted to match the flags,
+	// which a reload that drops objects may have left apart
+	std::vector<int>::iterator found = std::find(m_dynamicObjects.begin(), m_dynamicObjects.end(), index);
+	if ((bDynamic == true) && (found == m_dynamicObjects.end()))
+	{
+		m_dynamicObjects.push_back(index);
+	}
+	else if ((bDynamic == false) && (found != m_dynamicObjects.end()))
+	{
+		m_dynamicObjects.erase(found);
+	}
+}
+
+/***********************************************************
+ *  UpdateSceneObjects()
+ *
+ *  This method is used for recomputing the model matrices and
+ *  world-space bounding boxes of the recorded objects whose
+ *  transformations have changed.
+ ***********************************************************/
+void SceneManager::UpdateSceneObjects()
+{
+	if (m_transforms.Update(m_pJobSystem) == 0)
+	{
+		return;
+	}
+
+	const std::vector<int>& updated = m_transforms.GetUpdated();
+	RunParallel(m_pJobSystem, (int)updated.size(), g_ObjectsPerJob,
+		[this, &updated](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				UpdateObjectBounds(updated[i]);
+			}
+		});
+	m_bBoundsDirty = true;
+
+	for (int i = 0; i < updated.size(); i++)
+	{
+		UpdateShadowCaster(updated[i]);
+	}
+}
+
+/***********************************************************
+ *  UpdateObjectBounds()
+ *
+ *  This method is used for recomputing the world-space box
+ *  of one object from its model matrix and the box of its
+ *  mesh.
+ ***********************************************************/
+void SceneManager::UpdateObjectBounds(int index)
+{
+	SCENE_OBJECT& object = m_sceneObjects[index];
+	const glm::mat4& model = m_transforms.GetMatrix(index);
+
+	// transform the center of the mesh box, and grow the half
+	// size by the absolute rotation and scale so the world box
+	// still holds the whole rotated mesh box
+	glm::vec3 meshMin;
+	glm::vec3 meshMax;
+	m_basicMeshes->GetMeshBounds(object.mesh, meshMin, meshMax);
+	glm::vec3 center = (meshMin + meshMax) * 0.5f;
+	glm::vec3 halfSize = (meshMax - meshMin) * 0.5f;
+	glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+	glm::vec3 worldHalfSize = glm::vec3(0.0f);
+	for (int column = 0; column < 3; column++)
+	{
+		for (int row = 0; row < 3; row++)
+		{
+			worldHalfSize[row] += fabsf(model[column][row]) * halfSize[column];
+		}
+	}
+	object.bounds.boundsMin = worldCenter - worldHalfSize;
+	object.bounds.boundsMax = worldCenter + worldHalfSize;
+}
+
+/***********************************************************
+ *  UpdateShadowCaster()
+ *
+ *  This method is used for passing the new placement of a
+ *  moved object on to the shadow maps.  A static caster
+ *  makes the cached maps that reach either its old or new
+ *  box out of date.
+ ***********************************************************/
+void SceneManager::UpdateShadowCaster(int index)
+{
+	SHADOW_CASTER& caster = m_shadowCasters[index];
+
+	if (caster.bDynamic == false)
+	{
+		m_shadowMaps.InvalidateBounds(caster.bounds);
+	}
+
+	caster.model = m_transforms.GetMatrix(index);
+	caster.bounds = m_sceneObjects[index].bounds;
+
+	if (caster.bDynamic == false)
+	{
+		m_shadowMaps.InvalidateBounds(caster.bounds);
+	}
+}
+
+/***********************************************************
+ *  BuildInstanceData()
+ *
+ *  This method is used for filling the per-instance values
+ *  of every recorded object, and for picking the variant of
+ *  the scene program each object is drawn with.  It only
+ *  runs when the draw list has changed; which of the
+ *  instances are uploaded, and in which order, is decided
+ *  by the culling and the render queue afterwards.
+ ***********************************************************/
+void SceneManager::BuildInstanceData()
+{
+	m_instanceData.resize(m_sceneObjects.size());
+
+	// every instance is filled independently, so the objects are
+	// split between the threads
+	RunParallel(m_pJobSystem, (int)m_sceneObjects.size(), g_ObjectsPerJob,
+		[this](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				SCENE_OBJECT& object = m_sceneObjects[i];
+				MeshLibrary::MESH_INSTANCE& instance = m_instanceData[i];
+
+				// the material values live in the material block and the
+				// texture is a layer of the batch texture array, so each
+				// instance only carries the two indices
+				instance.model = m_transforms.GetMatrix(i);
+				instance.color = object.color;
+				instance.params = glm::vec4(
+					object.UVscale.x,
+					object.UVscale.y,
+					(float)object.materialIndex,
+					(float)m_pTextureManager->GetTextureLayer(object.textureIndex));
+
+				// a texture still being loaded is drawn as a placeholder color
+				bool bTextured = (object.textureIndex >= 0);
+				if ((bTextured == true) &&
+					(m_pTextureManager->IsTextureResident(object.textureIndex) == false))
+				{
+					instance.color = g_PlaceholderColor;
+					instance.params.w = -1.0f;
+					bTextured = false;
+				}
+
+				object.shaderVariant = 0;
+				if (bTextured == true)
+				{
+					object.shaderVariant |= SHADER_FEATURE_TEXTURE;
+				}
+				if (object.materialIndex >= 0)
+				{
+					object.shaderVariant |= SHADER_FEATURE_LIGHTING;
+				}
+			}
+		});
+
+	m_bInstancesDirty = false;
+	m_bQueueDirty = true;
+}
+
+/***********************************************************
+ *  CullSceneObjects()
+ *
+ *  This method is used for finding the objects inside of the
+ *  view frustum.  The bounding volume hierarchy is rebuilt
+ *  when objects were added and refit when objects moved.
+ *  The instances only need to be uploaded again when the
+ *  set of visible objects has changed.
+ ***********************************************************/
+void SceneManager::CullSceneObjects()
+{
+	if (m_bBoundsDirty == true)
+	{
+		m_objectBounds.resize(m_sceneObjects.size());
+		for (int i = 0; i < m_sceneObjects.size(); i++)
+		{
+			m_objectBounds[i] = m_sceneObjects[i].bounds;
+		}
+
+		if (m_sceneBVH.GetObjectCount() != m_objectBounds.size())
+		{
+			m_sceneBVH.Build(m_objectBounds);
+		}
+		else
+		{
+			m_sceneBVH.Refit(m_objectBounds);
+		}
+		m_bBoundsDirty = false;
+	}
+
+	// without a view every object is drawn
+	if (m_bCullingEnabled == false)
+	{
+		m_culledVisibility.assign(m_sceneObjects.size(), 1);
+		m_cullStats.nodesTested = 0;
+		m_cullStats.objectsTested = 0;
+		m_cullStats.objectsCulled = 0;
+		m_cullStats.objectsDrawn = (int)m_sceneObjects.size();
+	}
+	else
+	{
+		m_sceneBVH.Cull(m_viewProjection, m_culledVisibility, m_cullStats, m_pJobSystem);
+	}
+
+	if (m_culledVisibility != m_visibleObjects)
+	{
+		m_visibleObjects.swap(m_culledVisibility);
+		m_bQueueDirty = true;
+	}
+}
+
+/***********************************************************
+ *  SortVisibleObjects()
+ *
+ *  This method is used for queueing the visible objects with
+ *  a sort key each and sorting them into draw order.  The
+ *  depth of an object is the clip-space depth of the center
+ *  of its box, which grows with the distance to the eye for
+ *  both perspective and orthographic projections.  An object
+ *  is transparent when its color is.  The level of detail of
+ *  an object is picked from the size its box projects to on
+ *  the screen, which only changes along with the view or the
+ *  object, and each level sorts as a mesh of its own.  The
+ *  shader variant is the costliest state to change, so the
+ *  objects are grouped by it first.
+ ***********************************************************/
+void SceneManager::SortVisibleObjects()
+{
+	m_visibleObjectIndices.clear();
+	for (int i = 0; i < m_visibleObjects.size(); i++)
+	{
+		if (m_visibleObjects[i] != 0)
+		{
+			m_visibleObjectIndices.push_back(i);
+		}
+	}
+
+	// the keys are made independently, so the objects are split
+	// between the threads
+	glm::vec4 depthRow = glm::vec4(
+		m_viewProjection[0][2], m_viewProjection[1][2], m_viewProjection[2][2], m_viewProjection[3][2]);
+	glm::vec4 clipWRow = glm::vec4(
+		m_viewProjection[0][3], m_viewProjection[1][3], m_viewProjection[2][3], m_viewProjection[3][3]);
+
+	// a clip-space size of 2 covers the height of the viewport
+	float pixelScale = m_projectionMatrix[1][1] * m_viewportSize.y * 0.5f;
+
+	m_renderQueue.Resize((int)m_visibleObjectIndices.size());
+	RunParallel(m_pJobSystem, (int)m_visibleObjectIndices.size(), g_ObjectsPerJob,
+		[this, &depthRow, &clipWRow, pixelScale](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				int objectIndex = m_visibleObjectIndices[i];
+				SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+				int textureArray = GetDrawnTextureArray(object);
+				glm::vec3 center = (object.bounds.boundsMin + object.bounds.boundsMax) * 0.5f;
+
+				// without a view every object is drawn at its finest
+				if (m_bCullingEnabled == false)
+				{
+					object.lod = 0;
+				}
+				else
+				{
+					float clipW = glm::dot(clipWRow, glm::vec4(center, 1.0f));
+					float screenSize = glm::length(object.bounds.boundsMax - object.bounds.boundsMin) * pixelScale /
+						std::max(clipW, 0.0001f);
+					object.lod = SelectLod(object.mesh, object.lod, screenSize);
+				}
+
+				uint64_t key = RenderQueue::MakeKey(
+					object.color.a < 1.0f,
+					object.shaderVariant,
+					textureArray,
+					object.mesh * MESH_LOD_COUNT + object.lod,
+					object.materialIndex,
+					glm::dot(depthRow, glm::vec4(center, 1.0f)));
+				m_renderQueue.SetItem(i, key, objectIndex);
+			}
+		});
+
+	m_renderQueue.Sort(m_frameArena);
+}
+
+/***********************************************************
+ *  CountStateChanges()
+ *
+ *  This method is used for counting how often the shader,
+ *  texture array, material and mesh change between
+ *  consecutive objects of a draw order.
+ ***********************************************************/
+void SceneManager::CountStateChanges(const std::vector<int>& objects, STATE_CHANGES& changes) const
+{
+	memset(&changes, 0, sizeof(changes));
+
+	for (int i = 1; i < objects.size(); i++)
+	{
+		const SCENE_OBJECT& previous = m_sceneObjects[objects[i - 1]];
+		const SCENE_OBJECT& object = m_sceneObjects[objects[i]];
+
+		if (previous.shaderVariant != object.shaderVariant)
+		{
+			changes.shaders++;
+		}
+		if (GetDrawnTextureArray(previous) != GetDrawnTextureArray(object))
+		{
+			changes.textures++;
+		}
+		if (previous.materialIndex != object.materialIndex)
+		{
+			changes.materials++;
+		}
+		if (previous.mesh != object.mesh)
+		{
+			changes.meshes++;
+		}
+	}
+}
+
+/***********************************************************
+ *  GetDrawnTextureArray()
+ *
+ *  This method is used for getting the texture array an
+ *  object is drawn with.  Objects drawn with a variant that
+ *  does not sample textures, such as the placeholders of
+ *  textures still loading, need none and can share draws
+ *  with the untextured objects.
+ ***********************************************************/
+int SceneManager::GetDrawnTextureArray(const SCENE_OBJECT& object) const
+{
+	if ((object.shaderVariant & SHADER_FEATURE_TEXTURE) == 0)
+	{
+		return(-1);
+	}
+
+	return(m_pTextureManager->GetTextureArray(object.textureIndex));
+}
+
+/***********************************************************
+ *  PackVisibleInstances()
+ *
+ *  This method is used for packing the per-instance values
+ *  of the visible objects in the order of the render queue,
+ *  and splitting them into one draw per run of the same
+ *  shader variant, mesh, level of detail and texture array.
+ *  The draws are then grouped into one multi-draw call per
+ *  run of the same variant and texture array, since the
+ *  shader samples a single array for the whole call.
+ ***********************************************************/
+void SceneManager::PackVisibleInstances()
+{
+	m_visibleOrder.clear();
+	m_drawBatches.clear();
+
+	for (int i = 0; i < m_renderQueue.GetCount(); i++)
+	{
+		int objectIndex = m_renderQueue.GetItem(i).object;
+		const SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+		int textureArray = GetDrawnTextureArray(object);
+
+		// start a new draw whenever the variant, mesh or texture
+		// array changes
+		if ((m_drawBatches.size() == 0) ||
+			(m_drawBatches.back().shaderVariant != object.shaderVariant) ||
+			(m_drawBatches.back().mesh != object.mesh) ||
+			(m_drawBatches.back().lod != object.lod) ||
+			(m_drawBatches.back().textureArray != textureArray))
+		{
+			DRAW_BATCH batch;
+			batch.shaderVariant = object.shaderVariant;
+			batch.mesh = object.mesh;
+			batch.lod = object.lod;
+			batch.textureArray = textureArray;
+			batch.firstInstance = (int)m_visibleOrder.size();
+			batch.instanceCount = 0;
+			m_drawBatches.push_back(batch);
+		}
+		m_drawBatches.back().instanceCount++;
+		m_visibleOrder.push_back(objectIndex);
+	}
+
+	// copying the instance values is the costly part, and every
+	// visible instance already knows where it goes
+	m_visibleInstances.resize(m_visibleOrder.size());
+	RunParallel(m_pJobSystem, (int)m_visibleOrder.size(), g_ObjectsPerJob,
+		[this](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				m_visibleInstances[i] = m_instanceData[m_visibleOrder[i]];
+			}
+		});
+
+	m_meshDraws.resize(m_drawBatches.size());
+	m_drawSubmissions.clear();
+	m_renderStats.triangles = 0;
+	for (int i = 0; i < m_drawBatches.size(); i++)
+	{
+		const DRAW_BATCH& batch = m_drawBatches[i];
+
+		m_meshDraws[i].mesh = batch.mesh;
+		m_meshDraws[i].lod = batch.lod;
+		m_renderStats.triangles += m_basicMeshes->GetTriangleCount(batch.mesh, batch.lod) * batch.instanceCount;
+		m_meshDraws[i].firstInstance = batch.firstInstance;
+		m_meshDraws[i].instanceCount = batch.instanceCount;
+
+		// start a new call when the variant or the texture array
+		// changes, untextured draws fit in with any array
+		if ((m_drawSubmissions.size() == 0) ||
+			(m_drawSubmissions.back().shaderVariant != batch.shaderVariant) ||
+			((batch.textureArray >= 0) && (m_drawSubmissions.back().textureArray >= 0) &&
+			(m_drawSubmissions.back().textureArray != batch.textureArray)))
+		{
+			DRAW_SUBMISSION submission;
+			submission.shaderVariant = batch.shaderVariant;
+			submission.textureArray = batch.textureArray;
+			submission.firstDraw = i;
+			submission.drawCount = 0;
+			m_drawSubmissions.push_back(submission);
+		}
+		if (m_drawSubmissions.back().textureArray < 0)
+		{
+			m_drawSubmissions.back().textureArray = batch.textureArray;
+		}
+		m_drawSubmissions.back().drawCount++;
+	}
+
+	// every frame section of the mesh library needs the new values
+	m_pendingFrameUploads = m_basicMeshes->GetFrameSectionCount();
+
+	// compare the state changes of the sorted order against the
+	// order the objects were recorded in
+	m_renderStats.objects = (int)m_visibleOrder.size();
+	m_renderStats.draws = (int)m_drawBatches.size();
+	m_renderStats.submissions = (int)m_drawSubmissions.size();
+	CountStateChanges(m_visibleOrder, m_renderStats.sorted);
+	CountStateChanges(m_visibleObjectIndices, m_renderStats.recorded);
+
+	m_bQueueDirty = false;
+}
+
+/***********************************************************
+ *  SetViewProjection()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices from the view manager, which the scene objects
+ *  are culled against before drawing.  The viewport size is
+ *  passed in rather than read back from OpenGL, which would
+ *  wait on the driver every frame.
+ ***********************************************************/
+void SceneManager::SetViewProjection(const glm::mat4& view, const glm::mat4& projection, const glm::vec2& viewportSize)
+{
+	glm::mat4 viewProjection = projection * view;
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+
+	// the depth order and screen size of the objects change with
+	// the view
+	if ((m_bCullingEnabled == false) || (viewProjection != m_viewProjection) ||
+		(viewportSize != m_viewportSize))
+	{
+		m_bQueueDirty = true;
+	}
+
+	m_viewProjection = viewProjection;
+	m_viewportSize = viewportSize;
+	m_bCullingEnabled = true;
+}
+
+/***********************************************************
+ *  GetCullStats()
+ *
+ *  This method is used for getting the counters from the
+ *  last culling pass.
+ ***********************************************************/
+const CULL_STATS& SceneManager::GetCullStats() const
+{
+	return(m_cullStats);
+}
+
+/***********************************************************
+ *  GetRenderStats()
+ *
+ *  This method is used for getting the draw and state change
+ *  counters from the last time the render queue was sorted.
+ ***********************************************************/
+const RENDER_STATS& SceneManager::GetRenderStats() const
+{
+	return(m_renderStats);
+}
+
+/***********************************************************
+ *  GetFrameBufferStats()
+ *
+ *  This method is used for getting the counters of the waits
+ *  for the GPU to release a section of the frame buffer that
+ *  the instances and draws are written into.
+ ***********************************************************/
+const RING_BUFFER_STATS& SceneManager::GetFrameBufferStats() const
+{
+	return(m_basicMeshes->GetFrameBufferStats());
+}
+
+/***********************************************************
+ *  GetShadowStats()
+ *
+ *  This method is used for getting the counters of how often
+ *  the cached shadow maps were rendered, and how often the
+ *  dynamic objects were drawn over them.
+ ***********************************************************/
+const SHADOW_STATS& SceneManager::GetShadowStats() const
+{
+	return(m_shadowMaps.GetStats());
+}
+
+/***********************************************************
+ *  GetFrameArenaStats()
+ *
+ *  This method is used for getting the counters of the
+ *  scratch memory the frames were rendered with.
+ ***********************************************************/
+const FRAME_ARENA_STATS& SceneManager::GetFrameArenaStats() const
+{
+	return(m_frameArena.GetStats());
+}
+
+/***********************************************************
+ *  GetUniformStats()
+ *
+ *  This method is used for getting the counters of the
+ *  uploads made to the material and light blocks and to the
+ *  texture sampler uniform, and of the ones skipped because
+ *  the value had not changed.
+ ***********************************************************/
+UNIFORM_UPLOAD_STATS SceneManager::GetUniformStats() const
+{
+	UNIFORM_UPLOAD_STATS stats;
+	stats.uploadsIssued = m_materialBuffer.GetStats().uploadsIssued +
+		m_lightBuffer.GetStats().uploadsIssued + m_textureUnitStats.uploadsIssued;
+	stats.uploadsSkipped = m_materialBuffer.GetStats().uploadsSkipped +
+		m_lightBuffer.GetStats().uploadsSkipped + m_textureUnitStats.uploadsSkipped;
+
+	return(stats);
+}
+
+/***********************************************************
+ *  GetPendingTextureCount()
+ *
+ *  This method is used for getting the number of textures
+ *  that are still drawn with the placeholder.
+ ***********************************************************/
+int SceneManager::GetPendingTextureCount() const
+{
+	if (NULL == m_pTextureManager)
+	{
+		return(0);
+	}
+
+	return(m_pTextureManager->GetPendingCount());
+}
+
+//loading textures for the scene - the images are decoded in the
+//background and the objects show a placeholder until they arrive
+void SceneManager::LoadSceneTextures()
+{
+	//loads image wood for wooden texture on desk
+	CreateGLTexture("Textures/wood.jpg", "wood");
+	//loads image wood for wooden texture on desk
+	CreateGLTexture("Textures/keyboard.jpg", "keyboard");
+	//loads image wood for wooden texture on desk
+	CreateGLTexture("Textures/notebook.jpg", "notebook");
+	//loads image wood for wooden texture on desk
+	CreateGLTexture("Textures/mug.jpg", "mug");
+	
+
+	// allocate the texture arrays and bind them to texture units
+	BindGLTextures();
+}
+
+
+
+
+
+void SceneManager::DefineObjectMaterials()
+{
+	// Glass material 
+	OBJECT_MATERIAL glass;
+	glass.tag = "glass";
+	glass.diffuseColor = glm::vec3(0.10f, 0.10f, 0.10f); 
+	glass.specularColor = glm::vec3(0.90f, 0.90f, 0.90f); 
+	glass.shininess = 128.0f;                        
+	glass.ambientColor = glm::vec3(0.60f, 0.60f, 0.60f); 
+	glass.ambientStrength = 40.0f;
+	m_objectMaterials.push_back(glass);
+	//plastic material
+	OBJECT_MATERIAL plastic;
+	plastic.tag = "plastic";
+	plastic.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f);   
+	plastic.specularColor = glm::vec3(0.5f, 0.5f, 0.5f);   
+	plastic.shininess = 80.0f;                      
+	plastic.ambientColor = glm::vec3(0.15f, 0.15f, 0.15f);
+	plastic.ambientStrength = 1.0f;
+	m_objectMaterials.push_back(plastic);
+
+	
+}
+
+/***********************************************************
+ *  UploadObjectMaterials()
+ *
+ *  This method is used for copying every defined material
+ *  into the material uniform block and interning its tag.
+ *  Draws select their material by its index in this block.
+ ***********************************************************/
+void SceneManager::UploadObjectMaterials()
+{
+	MATERIAL_BLOCK block;
+
+	m_materialTags.Clear();
+	for (int i = 0; i < m_objectMaterials.size(); i++)
+	{
+		m_materialTags.Register(m_objectMaterials[i].tag.c_str(), i);
+	}
+
+	if (m_objectMaterials.size() > MAX_BLOCK_MATERIALS)
+	{
+		std::cout << "Too many object materials for the material block:" << m_objectMaterials.size() << std::endl;
+	}
+
+	memset(&block, 0, sizeof(block));
+	for (int i = 0; (i < m_objectMaterials.size()) && (i < MAX_BLOCK_MATERIALS); i++)
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[i];
+		block.materials[i].ambient = glm::vec4(material.ambientColor, material.ambientStrength);
+		block.materials[i].diffuse = glm::vec4(material.diffuseColor, material.shininess);
+		block.materials[i].specular = glm::vec4(material.specularColor, 0.0f);
+	}
+
+	m_materialBuffer.Update(&block, sizeof(block));
+}
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is used for defining the scene lights.  The
+ *  lights are uploaded to the light buffer before the next
+ *  frame is drawn.  The desk light casts shadows.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	m_pointLights.clear();
+
+	// put the point light around the top left of the keyboard/monitor to try and simulate sunlight
+	int index = AddPointLight(
+		glm::vec3(-1.20f, 1.00f, -1.20f),
+		0.0f,
+		glm::vec3(0.32f, 0.30f, 0.22f),
+		glm::vec3(3.00f, 2.80f, 2.50f),
+		glm::vec3(3.50f, 3.40f, 3.10f));
+	EnablePointLightShadows(index);
+}
+
+/***********************************************************
+ *  AddPointLight()
+ *
+ *  This method is used for adding a point light to the
+ *  scene.  A light with a radius fades out smoothly to
+ *  nothing at that distance, and is only evaluated for the
+ *  fragments of the clusters it reaches.  A radius of 0
+ *  reaches everything without fading.
+ ***********************************************************/
+int SceneManager::AddPointLight(
+	glm::vec3 positionXYZ,
+	float radius,
+	glm::vec3 ambientColor,
+	glm::vec3 diffuseColor,
+	glm::vec3 specularColor)
+{
+	POINT_LIGHT light;
+	light.position = glm::vec4(positionXYZ, std::max(radius, 0.0f));
+	light.ambient = glm::vec4(ambientColor, 0.0f);
+	light.diffuse = glm::vec4(diffuseColor, 0.0f);
+	light.specular = glm::vec4(specularColor, 0.0f);
+	light.shadow = glm::vec4(-1.0f, 0.0f, 0.0f, 0.0f);
+
+	m_pointLights.push_back(light);
+	m_bLightsDirty = true;
+
+	return((int)m_pointLights.size() - 1);
+}
+
+/***********************************************************
+ *  GetPointLightCount()
+ *
+ *  This method is used for getting the number of point
+ *  lights in the scene.
+ ***********************************************************/
+int SceneManager::GetPointLightCount() const
+{
+	return((int)m_pointLights.size());
+}
+
+/***********************************************************
+ *  EnablePointLightShadows()
+ *
+ *  This method is used for giving a point light a cube
+ *  shadow map.  The shadows reach as far as the light does,
+ *  or across the whole scene for a light without a radius.
+ ***********************************************************/
+bool SceneManager::EnablePointLightShadows(int index)
+{
+	if ((index < 0) || (index >= m_pointLights.size()))
+	{
+		return(false);
+	}
+
+	POINT_LIGHT& light = m_pointLights[index];
+	if (light.shadow.x >= 0.0f)
+	{
+		return(true);
+	}
+
+	int shadowIndex = m_shadowMaps.AddLight();
+	if (shadowIndex < 0)
+	{
+		return(false);
+	}
+
+	float reach = (light.position.w > 0.0f) ? light.position.w : g_UnlimitedShadowReach;
+	light.shadow = glm::vec4((float)shadowIndex, reach, 0.0f, 0.0f);
+	m_bLightsDirty = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  UpdateSceneLights()
+ *
+ *  This method is used for uploading changed lights and for
+ *  assigning the lights to the clusters of the current view.
+ *  The compute pass leaves its own program current, which
+ *  is fine since every draw group makes its variant current.
+ ***********************************************************/
+void SceneManager::UpdateSceneLights()
+{
+	if (m_bLightsDirty == true)
+	{
+		m_lightClusters.SetLights(m_pointLights);
+		m_bLightsDirty = false;
+
+		// a shadow map is only rendered again when its light moved
+		for (int i = 0; i < m_pointLights.size(); i++)
+		{
+			const POINT_LIGHT& light = m_pointLights[i];
+			if (light.shadow.x >= 0.0f)
+			{
+				m_shadowMaps.SetLight((int)light.shadow.x, glm::vec3(light.position), light.shadow.y);
+			}
+		}
+	}
+
+	m_lightClusters.Update(m_viewMatrix, m_projectionMatrix);
+
+	LIGHT_BLOCK lights;
+	memset(&lights, 0, sizeof(lights));
+	lights.settings.x = 1;	// use lighting
+	lights.settings.y = m_lightClusters.GetLightCount();
+	lights.clusterMapping = m_lightClusters.GetClusterMapping();
+	// fragments are looked up in the clusters with the view they
+	// were built for, not the late-latched view of the frame
+	lights.clusterView = m_lightClusters.GetView();
+	lights.clusterProjection = m_lightClusters.GetProjection();
+
+	// the block is only uploaded when the clusters were built for
+	// another view
+	m_lightBuffer.Update(&lights, sizeof(lights));
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+	// create the material and light blocks
+	m_materialBuffer.Create(MATERIAL_BLOCK_BINDING, sizeof(MATERIAL_BLOCK));
+	m_lightBuffer.Create(LIGHT_BLOCK_BINDING, sizeof(LIGHT_BLOCK));
+	m_lightClusters.Create(g_LightClusterShaderName);
+	m_shadowMaps.Create(g_ShadowVertexShaderName, g_ShadowFragmentShaderName);
+
+	//defining texture and object materials
+	DefineObjectMaterials();
+	UploadObjectMaterials();
+	LoadSceneTextures();
+
+	// plane for the desk, cylinders for the stand/mug, boxes for
+	// the notebooks, cones for the pencil tips and mouse hump,
+	// and a torus for the mug handle
+	m_basicMeshes->LoadMeshes();
+
+	//setting up lights in the scene - the light block keeps
+	//these values between frames so they only need to be set once
+	{
+		ProfileScope scope(m_pProfiler, "SetupSceneLights");
+		SetupSceneLights();
+	}
+
+	// record every object of the scene into the draw list once
+	BuildSceneObjects();
+}
+
+/***********************************************************
+ *  BuildSceneObjects()
+ *
+ *  This method is used for recording the objects of the 3D
+ *  scene into the retained draw list.  The layout of the
+ *  scene lives in the scene file, so changing it needs no
+ *  rebuild.  Every object carries its own color, texture and
+ *  material so nothing depends on the shader state left
+ *  behind by the previous draw.
+ ***********************************************************/
+void SceneManager::BuildSceneObjects()
+{
+	m_sceneObjects.clear();
+	m_shadowCasters.clear();
+	m_dynamicObjects.clear();
+	m_transforms.Clear();
+	m_sceneRecords.clear();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (LoadSceneFile(m_sceneFilename.c_str()) < 0)
+	{
+		std::cout << "Could not load the scene file:" << m_sceneFilename << std::endl;
+		return;
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << "INFO: Scene file: " << m_sceneObjects.size() << " objects loaded from "
+		<< m_sceneFilename << " in " << elapsed.count() << " ms" << std::endl;
+}
+
+/***********************************************************
+ *  LoadSceneFile()
+ *
+ *  This method is used for recording every object of a scene
+ *  file into the retained draw list.  The records are read
+ *  straight from the mapped file, and each tag in the string
+ *  table is resolved to its texture or material once rather
+ *  than once per object.  When a scene is already loaded,
+ *  the objects are matched to the records of the file by
+ *  their contents rather than their line, so adding or
+ *  removing a line leaves the objects on the other lines
+ *  alone.  Changed and added records take over the objects
+ *  no longer in the file, and go on the end once those run
+ *  out.  Objects left over are removed by moving the last
+ *  objects into their places, so only the end of the list
+ *  is cut off.  An object that kept its mesh and placement
+ *  keeps its model matrix and cached shadows.
+ ***********************************************************/
+int SceneManager::LoadSceneFile(const char* filename)
+{
+	SceneFile scene;
+	if (scene.Open(filename) == false)
+	{
+		return(-1);
+	}
+
+	std::vector<int> textureIndices;
+	std::vector<int> materialIndices;
+	ResolveSceneTags(scene, textureIndices, materialIndices);
+
+	int objectCount = scene.GetObjectCount();
+	const SCENE_FILE_OBJECT* objects = scene.GetObjects();
+	std::vector<SCENE_FILE_OBJECT> records(objectCount);
+	for (int i = 0; i < objectCount; i++)
+	{
+		records[i] = ResolveRecord(objects[i], textureIndices, materialIndices);
+	}
+
+	// every loaded object is found by the hash of its record, and
+	// each one can only be matched by one record of the file
+	int loadedCount = (int)m_sceneRecords.size();
+	std::unordered_multimap<uint64_t, int> loadedObjects;
+	loadedObjects.reserve(loadedCount);
+	for (int i = 0; i < loadedCount; i++)
+	{
+		loadedObjects.insert(std::make_pair(HashRecord(m_sceneRecords[i]), i));
+	}
+
+	std::vector<unsigned char> bKept(loadedCount, 0);
+	std::vector<int> unmatchedRecords;
+	for (int i = 0; i < objectCount; i++)
+	{
+		bool bMatched = false;
+		std::pair<RECORD_MAP_ITERATOR, RECORD_MAP_ITERATOR> matches =
+			loadedObjects.equal_range(HashRecord(records[i]));
+		for (RECORD_MAP_ITERATOR match = matches.first; match != matches.second; ++match)
+		{
+			if (memcmp(&records[i], &m_sceneRecords[match->second], sizeof(SCENE_FILE_OBJECT)) == 0)
+			{
+				bKept[match->second] = 1;
+				loadedObjects.erase(match);
+				bMatched = true;
+				break;
+			}
+		}
+		if (bMatched == false)
+		{
+			unmatchedRecords.push_back(i);
+		}
+	}
+
+	// changed and added records take over the objects that are no
+	// longer in the file first
+	int changedCount = 0;
+	int freeObject = 0;
+	m_sceneObjects.reserve(objectCount);
+	m_shadowCasters.reserve(objectCount);
+	m_transforms.Reserve(objectCount);
+	m_sceneRecords.reserve(objectCount);
+	for (int i = 0; i < unmatchedRecords.size(); i++)
+	{
+		const SCENE_FILE_OBJECT& record = records[unmatchedRecords[i]];
+		while ((freeObject < loadedCount) && (bKept[freeObject] != 0))
+		{
+			freeObject++;
+		}
+
+		if (freeObject < loadedCount)
+		{
+			AssignSceneRecord(freeObject, record);
+			bKept[freeObject] = 1;
+		}
+		else
+		{
+			AddSceneObject((MESH_TYPE)record.mesh,
+				glm::vec3(record.scale[0], record.scale[1], record.scale[2]),
+				record.rotation[0], record.rotation[1], record.rotation[2],
+				glm::vec3(record.position[0], record.position[1], record.position[2]));
+			m_sceneRecords.push_back(record);
+			ApplySceneRecord((int)m_sceneRecords.size() - 1, record);
+		}
+		changedCount++;
+	}
+
+	// the objects left over are removed, the last kept object
+	// moving into each of their places
+	int keptCount = loadedCount;
+	for (int i = 0; i < keptCount; i++)
+	{
+		if (bKept[i] != 0)
+		{
+			continue;
+		}
+
+		changedCount++;
+		while ((keptCount - 1 > i) && (bKept[keptCount - 1] == 0))
+		{
+			keptCount--;
+			changedCount++;
+		}
+		if (keptCount - 1 > i)
+		{
+			AssignSceneRecord(i, m_sceneRecords[keptCount - 1]);
+			changedCount++;
+		}
+		keptCount--;
+	}
+	if (keptCount < loadedCount)
+	{
+		TruncateSceneObjects(keptCount);
+	}
+
+	return(changedCount);
+}
+
+/***********************************************************
+ *  ResolveSceneTags()
+ *
+ *  This method is used for looking up the texture and the
+ *  material named by every tag in the string table of a
+ *  scene file.  A tag may name a texture, a material or
+ *  both.
+ ***********************************************************/
+void SceneManager::ResolveSceneTags(
+	const SceneFile& scene,
+	std::vector<int>& textureIndices,
+	std::vector<int>& materialIndices)
+{
+	int stringCount = scene.GetStringCount();
+	textureIndices.resize(stringCount);
+	materialIndices.resize(stringCount);
+	for (int i = 0; i < stringCount; i++)
+	{
+		TAG_ID tag = HashTag(scene.GetString(i));
+		textureIndices[i] = FindTextureIndex(tag);
+		materialIndices[i] = FindMaterialIndex(tag);
+	}
+}
+
+/***********************************************************
+ *  AssignSceneRecord()
+ *
+ *  This method is used for setting a recorded object from
+ *  a resolved scene file record that replaces its current
+ *  one.  The model matrix and shadows are only updated when
+ *  the mesh or placement changed.
+ ***********************************************************/
+void SceneManager::AssignSceneRecord(int index, const SCENE_FILE_OBJECT& record)
+{
+	const SCENE_FILE_OBJECT& loaded = m_sceneRecords[index];
+	if ((record.mesh != loaded.mesh) ||
+		(memcmp(record.scale, loaded.scale, sizeof(record.scale)) != 0) ||
+		(memcmp(record.rotation, loaded.rotation, sizeof(record.rotation)) != 0) ||
+		(memcmp(record.position, loaded.position, sizeof(record.position)) != 0))
+	{
+		SetObjectTransformations(index,
+			glm::vec3(record.scale[0], record.scale[1], record.scale[2]),
+			record.rotation[0], record.rotation[1], record.rotation[2],
+			glm::vec3(record.position[0], record.position[1], record.position[2]));
+	}
+
+	m_sceneRecords[index] = record;
+	ApplySceneRecord(index, record);
+}
+
+/***********************************************************
+ *  ApplySceneRecord()
+ *
+ *  This method is used for setting the mesh, color, texture,
+ *  material and flags of a recorded object from a resolved
+ *  scene file record.  The placement is set by the caller.
+ ***********************************************************/
+void SceneManager::ApplySceneRecord(int index, const SCENE_FILE_OBJECT& record)
+{
+	SCENE_OBJECT& object = m_sceneObjects[index];
+	object.mesh = (MESH_TYPE)record.mesh;
+	object.color = glm::vec4(record.color[0], record.color[1], record.color[2], record.color[3]);
+	object.UVscale = glm::vec2(record.uvScale[0], record.uvScale[1]);
+	object.textureIndex = record.texture;
+	object.materialIndex = record.material;
+	m_shadowCasters[index].mesh = object.mesh;
+	m_bInstancesDirty = true;
+
+	SetObjectDynamic(index, (record.flags & SCENE_OBJECT_DYNAMIC) != 0);
+}
+
+/***********************************************************
+ *  TruncateSceneObjects()
+ *
+ *  This method is used for removing the recorded objects
+ *  from the passed in index on.  The cached shadow maps lose
+ *  the shadows of the removed static objects, and the
+ *  hierarchy is rebuilt for the shorter list.
+ ***********************************************************/
+void SceneManager::TruncateSceneObjects(int count)
+{
+	for (int i = count; i < m_sceneObjects.size(); i++)
+	{
+		if (m_shadowCasters[i].bDynamic == false)
+		{
+			m_shadowMaps.InvalidateBounds(m_shadowCasters[i].bounds);
+		}
+	}
+	m_dynamicObjects.erase(
+		std::remove_if(m_dynamicObjects.begin(), m_dynamicObjects.end(),
+			[count](int index) { return(index >= count); }),
+		m_dynamicObjects.end());
+
+	m_sceneObjects.resize(count);
+	m_shadowCasters.resize(count);
+	m_sceneRecords.resize(count);
+	m_transforms.Truncate(count);
+	m_bInstancesDirty = true;
+	m_bBoundsDirty = true;
+}
+
+/***********************************************************
+ *  UpdateScene()
+ *
+ *  This method is used for bringing the 3D scene up to date
+ *  for the frame, up to the point of drawing it: the changed
+ *  objects, textures, lights and shadow maps, and the draws
+ *  of the objects inside of the view frustum.  The camera
+ *  may still be moved between this and DrawScene(), since
+ *  only the scene draws read the frame block.
+ ***********************************************************/
+void SceneManager::UpdateScene()
+{
+	// the section of the frame buffer written this frame must no
+	// longer be in use by the GPU
+	{
+		ProfileScope scope(m_pProfiler, "Fence wait", false);
+		m_basicMeshes->BeginFrame();
+	}
+
+	// the scratch memory of the last frame is taken back
+	m_frameArena.Reset();
+
+	// only objects whose transformations changed are recomputed
+	UpdateSceneObjects();
+
+	// textures finished by the loader replace their placeholders
+	{
+		ProfileScope scope(m_pProfiler, "Texture uploads");
+		if (m_pTextureManager->FinalizeUploads(g_TextureUploadBudget) > 0)
+		{
+			m_bInstancesDirty = true;
+		}
+	}
+
+	// the lights are only assigned to the clusters again when
+	// they or the view changed
+	{
+		ProfileScope scope(m_pProfiler, "Light clusters");
+		UpdateSceneLights();
+	}
+
+	// the cached shadow maps are only rendered again when a light
+	// or a static object in its reach changed, the dynamic objects
+	// are drawn over them
+	{
+		ProfileScope scope(m_pProfiler, "Shadow maps");
+		m_shadowMaps.Render(m_basicMeshes, m_frameArena, m_shadowCasters, m_dynamicObjects);
+	}
+
+	// the instance values are only rebuilt when the list changed
+	if (m_bInstancesDirty == true)
+	{
+		BuildInstanceData();
+	}
+
+	// the instance buffer is only sorted and refilled again when
+	// the visible set or the view changed
+	{
+		ProfileScope scope(m_pProfiler, "Culling", false);
+		CullSceneObjects();
+	}
+	if (m_bQueueDirty == true)
+	{
+		{
+			ProfileScope scope(m_pProfiler, "Sort", false);
+			SortVisibleObjects();
+		}
+		PackVisibleInstances();
+	}
+
+	// the frame's section only needs writing until every section
+	// holds the packed values
+	if (m_pendingFrameUploads > 0)
+	{
+		m_basicMeshes->UploadFrameData(
+			m_visibleInstances.data(), (int)m_visibleInstances.size(),
+			m_meshDraws.data(), (int)m_meshDraws.size());
+		m_pendingFrameUploads--;
+	}
+}
+
+/***********************************************************
+ *  DrawScene()
+ *
+ *  This method is used for rendering the 3D scene by drawing
+ *  the retained draw list that was recorded in PrepareScene()
+ *  with one instanced draw per mesh and texture array,
+ *  submitted through one multi-draw indirect call for each
+ *  shader variant and texture array in use.  Only objects inside of the view
+ *  frustum are drawn.  UpdateScene() must have been called
+ *  for the frame first.
+ ***********************************************************/
+void SceneManager::DrawScene()
+{
+	// one multi-draw call per shader variant and texture array,
+	// the passes before left their own programs current
+	ProfileScope scope(m_pProfiler, "Draw scene");
+	int currentVariant = -1;
+	for (int i = 0; i < m_drawSubmissions.size(); i++)
+	{
+		const DRAW_SUBMISSION& submission = m_drawSubmissions[i];
+		if (submission.shaderVariant != currentVariant)
+		{
+			currentVariant = submission.shaderVariant;
+			glUseProgram(m_sceneVariants[currentVariant].GetProgram());
+		}
+		// a program keeps its uniform values, so the texture unit
+		// is only uploaded when it differs from the last one
+		if (submission.textureArray >= 0)
+		{
+			int unit = m_pTextureManager->SelectTextureArray(submission.textureArray);
+			if (m_textureUnitValues[currentVariant] != unit)
+			{
+				glUniform1i(m_textureUnitLocations[currentVariant], unit);
+				m_textureUnitValues[currentVariant] = unit;
+				m_textureUnitStats.uploadsIssued++;
+			}
+			else
+			{
+				m_textureUnitStats.uploadsSkipped++;
+			}
+		}
+		m_basicMeshes->DrawIndirect(submission.firstDraw, submission.drawCount);
+	}
+
+	// nothing after this reads the frame's section
+	m_basicMeshes->EndFrame();
+}
+
+/***********************************************************
+ *  SetProfiler()
+ *
+ *  This method is used for setting the profiler that times
+ *  the lighting setup, texture uploads, culling and draw
+ *  groups.  Passing NULL turns the timing off.
+ ***********************************************************/
+void SceneManager::SetProfiler(Profiler* pProfiler)
+{
+	m_pProfiler = pProfiler;
+}
+
+/***********************************************************
+ *  SetJobSystem()
+ *
+ *  This method is used for setting the job system that the
+ *  transform update, bounding boxes, culling and instance
+ *  packing are spread over.  The draw calls are always
+ *  issued from the rendering thread.  Passing NULL does all
+ *  of the work on the rendering thread.
+ ***********************************************************/
+void SceneManager::SetJobSystem(JobSystem* pJobSystem)
+{
+	m_pJobSystem = pJobSystem;
+}
+
+/***********************************************************
+ *  SetSceneFile()
+ *
+ *  This method is used for choosing the scene file that
+ *  PrepareScene() loads the objects of the scene from.
+ ***********************************************************/
+void SceneManager::SetSceneFile(const char* filename)
+{
+	m_sceneFilename = filename;
+}
+
+/***********************************************************
+ *  LoadSceneShaders()
+ *
+ *  This method is used for building every variant of the
+ *  shader program the scene is drawn with, rather than
+ *  through the shader manager, so the variants go through
+ *  the binary cache and can be reloaded.  Each variant is
+ *  the same files built with the defines of its features.
+ *  Every build is started before any is waited for, so the
+ *  driver can compile them side by side.  The uniform blocks
+ *  and samplers name their binding points in the shaders, so
+ *  only the first draw uniform is looked up.
+ ***********************************************************/
+bool SceneManager::LoadSceneShaders(const char* vertexShaderFilename, const char* fragmentShaderFilename)
+{
+	for (int i = 0; i < SHADER_VARIANT_COUNT; i++)
+	{
+		std::string defines;
+		for (int feature = 0; (1 << feature) < SHADER_VARIANT_COUNT; feature++)
+		{
+			if ((i & (1 << feature)) != 0)
+			{
+				defines += g_ShaderFeatureDefines[feature];
+			}
+		}
+
+		m_sceneVariants[i].SetDefines(defines.c_str());
+		if (m_sceneVariants[i].BeginLoadShaders(vertexShaderFilename, fragmentShaderFilename) == false)
+		{
+			return(false);
+		}
+	}
+
+	bool bLoaded = true;
+	for (int i = 0; i < SHADER_VARIANT_COUNT; i++)
+	{
+		if (m_sceneVariants[i].FinishPendingLoad() == false)
+		{
+			bLoaded = false;
+		}
+		m_textureUnitLocations[i] = m_sceneVariants[i].GetUniformLocation(g_TextureSamplerName);
+		m_textureUnitValues[i] = -1;
+	}
+
+	return(bLoaded);
+}
+
+/***********************************************************
+ *  EnableHotReload()
+ *
+ *  This method is used for starting to watch the scene file,
+ *  the scene shaders and the shaders of the shadow and light
+ *  cluster passes, so they can be edited while the scene is
+ *  shown.
+ ***********************************************************/
+void SceneManager::EnableHotReload()
+{
+	// every variant is built from the same files
+	m_fileWatcher.AddFile(m_sceneFilename.c_str());
+	for (int i = 0; i < m_sceneVariants[0].GetFileCount(); i++)
+	{
+		m_fileWatcher.AddFile(m_sceneVariants[0].GetFilename(i));
+	}
+	m_fileWatcher.AddFile(g_ShadowVertexShaderName);
+	m_fileWatcher.AddFile(g_ShadowFragmentShaderName);
+	m_fileWatcher.AddFile(g_LightClusterShaderName);
+}
+
+/***********************************************************
+ *  ReloadChangedFiles()
+ *
+ *  This method is used for bringing the scene up to date with
+ *  the watched files, once per frame before it is rendered.
+ *  A changed shader starts building in the background while
+ *  the current program keeps drawing, and the new program
+ *  only takes over once it has built without errors, so a
+ *  typo never leaves the scene without shaders.  A changed
+ *  scene file only rebuilds the objects whose lines changed,
+ *  and a file with an error leaves the scene as it is.
+ ***********************************************************/
+void SceneManager::ReloadChangedFiles()
+{
+	for (int i = 0; i < SHADER_VARIANT_COUNT; i++)
+	{
+		if (m_sceneVariants[i].UpdatePendingLoad() == true)
+		{
+			m_textureUnitLocations[i] = m_sceneVariants[i].GetUniformLocation(g_TextureSamplerName);
+			m_textureUnitValues[i] = -1;
+			std::cout << "INFO: Hot reload: scene shader variant " << i << " swapped in" << std::endl;
+		}
+	}
+	if (m_shadowMaps.SwapReloadedShaders() == true)
+	{
+		std::cout << "INFO: Hot reload: shadow shaders swapped in" << std::endl;
+	}
+	if (m_lightClusters.SwapReloadedShaders() == true)
+	{
+		std::cout << "INFO: Hot reload: light cluster shader swapped in" << std::endl;
+	}
+
+	if (m_fileWatcher.Poll(m_changedFiles) == 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < m_changedFiles.size(); i++)
+	{
+		const std::string& filename = m_changedFiles[i];
+
+		if (filename == m_sceneFilename)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			int changedCount = LoadSceneFile(m_sceneFilename.c_str());
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+			if (changedCount < 0)
+			{
+				std::cout << "Could not reload the scene file, the scene is kept as it was:" << filename << std::endl;
+			}
+			else
+			{
+				std::cout << "INFO: Hot reload: " << changedCount << " of " << m_sceneObjects.size()
+					<< " objects rebuilt from " << filename << " in " << elapsed.count() << " ms" << std::endl;
+			}
+		}
+
+		for (int j = 0; j < SHADER_VARIANT_COUNT; j++)
+		{
+			if (m_sceneVariants[j].UsesFile(filename.c_str()) == true)
+			{
+				m_sceneVariants[j].BeginReload();
+			}
+		}
+		m_shadowMaps.ReloadShaders(filename.c_str());
+		m_lightClusters.ReloadShaders(filename.c_str());
+	}
+}
@@ -1,114 +1,340 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.h
-// ============
-// manage the preparing and rendering of 3D scenes - textures, materials, lighting
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		glm::vec3 ambientColor;
-		float ambientStrength;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-	// lighting/material 
-	void DefineObjectMaterials();
-	void SetupSceneLights();
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	// loads textures for the 3D scene im creating
-	void PrepareScene();
-	void RenderScene();
-	void LoadSceneTextures();
-	
-
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.h
+// ============
+// manage the preparing and rendering of 3D scenes - textures, materials, lighting
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "UniformBuffer.h"
+#include "MeshLibrary.h"
+#include "TagRegistry.h"
+#include "TextureManager.h"
+#include "SceneBVH.h"
+#include "TransformSystem.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include "RenderQueue.h"
+#include "LightClusters.h"
+#include "ShadowMaps.h"
+#include "FrameArena.h"
+#include "FileWatcher.h"
+#include "SceneFile.h"
+
+#include <string>
+#include <vector>
+
+// features the scene shaders are built with or without - every
+// combination is a variant of the scene program, so untextured
+// objects never sample a texture and objects without a material
+// never walk the lights
+const int SHADER_FEATURE_TEXTURE = 1;
+const int SHADER_FEATURE_LIGHTING = 2;
+const int SHADER_VARIANT_COUNT = 4;
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager);
+	// destructor
+	~SceneManager();
+
+	struct OBJECT_MATERIAL
+	{
+		glm::vec3 ambientColor;
+		float ambientStrength;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	// one recorded object in the retained draw list - the
+	// transformation values live in the transform system
+	// under the same index
+	struct SCENE_OBJECT
+	{
+		MESH_TYPE mesh;
+		glm::vec4 color;
+		int textureIndex;
+		glm::vec2 UVscale;
+		int materialIndex;
+		// world-space bounding box used for culling
+		BVH_BOUNDS bounds;
+		// tessellation level the object was last drawn with
+		int lod;
+		// variant of the scene program the object is drawn with
+		int shaderVariant;
+	};
+
+	// run of instances sharing one shader variant, mesh and texture
+	// array
+	struct DRAW_BATCH
+	{
+		int shaderVariant;
+		MESH_TYPE mesh;
+		int lod;
+		int textureArray;
+		int firstInstance;
+		int instanceCount;
+	};
+
+	// run of draw batches submitted with one multi-draw call, they
+	// share a shader variant and a texture array, -1 when untextured
+	struct DRAW_SUBMISSION
+	{
+		int shaderVariant;
+		int textureArray;
+		int firstDraw;
+		int drawCount;
+	};
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to the frame profiler, NULL when not profiling
+	Profiler* m_pProfiler;
+	// pointer to the job system, NULL to do all work on this thread
+	JobSystem* m_pJobSystem;
+	// scene file the objects of the scene are loaded from, and its
+	// records as loaded with the tags resolved to indices, which
+	// a changed file is compared against
+	std::string m_sceneFilename;
+	std::vector<SCENE_FILE_OBJECT> m_sceneRecords;
+	// variants of the scene program, indexed by their features, and
+	// the location of the sampler of a submission's texture array in
+	// each of them, with the texture unit last uploaded to it, -1
+	// until one has been
+	ShaderProgram m_sceneVariants[SHADER_VARIANT_COUNT];
+	GLint m_textureUnitLocations[SHADER_VARIANT_COUNT];
+	GLint m_textureUnitValues[SHADER_VARIANT_COUNT];
+	// counters of the texture unit uploads made and skipped
+	UNIFORM_UPLOAD_STATS m_textureUnitStats;
+	// watch on the scene file and the shader files, and the files
+	// found to have changed
+	FileWatcher m_fileWatcher;
+	std::vector<std::string> m_changedFiles;
+	// pointer to basic shapes object
+	MeshLibrary* m_basicMeshes;
+	// pointer to the texture arrays object
+	TextureManager* m_pTextureManager;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// material tags interned to material indices
+	TagRegistry m_materialTags;
+	// uniform blocks holding every material and the scene lights
+	UniformBuffer m_materialBuffer;
+	UniformBuffer m_lightBuffer;
+	// scene point lights and their assignment to view clusters
+	std::vector<POINT_LIGHT> m_pointLights;
+	LightClusters m_lightClusters;
+	// true when the point lights need to be uploaded
+	bool m_bLightsDirty;
+	// cached shadow maps of the shadow casting lights, the casters
+	// by object and the objects drawn into the overlay each frame
+	ShadowMaps m_shadowMaps;
+	std::vector<SHADOW_CASTER> m_shadowCasters;
+	std::vector<int> m_dynamicObjects;
+	// retained draw list recorded in PrepareScene()
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	// transformation values and model matrices of the objects
+	TransformSystem m_transforms;
+	// per-instance values of every object
+	std::vector<MeshLibrary::MESH_INSTANCE> m_instanceData;
+	// per-instance values of the visible objects in draw order
+	std::vector<MeshLibrary::MESH_INSTANCE> m_visibleInstances;
+	// object of each visible instance in draw order
+	std::vector<int> m_visibleOrder;
+	// visible objects in the order they were recorded
+	std::vector<int> m_visibleObjectIndices;
+	// visible objects sorted by render state and depth
+	RenderQueue m_renderQueue;
+	// draw and state change counters of the sorted queue
+	RENDER_STATS m_renderStats;
+	// one instanced draw per mesh and texture array combination
+	std::vector<DRAW_BATCH> m_drawBatches;
+	// the draw batches as passed to the mesh library
+	std::vector<MeshLibrary::MESH_DRAW> m_meshDraws;
+	// multi-draw calls covering all of the draw batches
+	std::vector<DRAW_SUBMISSION> m_drawSubmissions;
+	// true when the instance buffer needs to be rebuilt
+	bool m_bInstancesDirty;
+	// hierarchy of the object bounding boxes for frustum culling
+	SceneBVH m_sceneBVH;
+	// object bounding boxes passed to the hierarchy
+	std::vector<BVH_BOUNDS> m_objectBounds;
+	// true when object bounding boxes have changed since the last cull
+	bool m_bBoundsDirty;
+	// view and projection matrices the scene is lit and culled with
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	glm::mat4 m_viewProjection;
+	// size in pixels of the viewport the scene is drawn to
+	glm::vec2 m_viewportSize;
+	// false until a view-projection matrix has been passed in
+	bool m_bCullingEnabled;
+	// one flag per object, set when the object is in the view
+	std::vector<unsigned char> m_visibleObjects;
+	std::vector<unsigned char> m_culledVisibility;
+	// true when the visible objects need to be sorted and uploaded,
+	// after the visible set or the view has changed
+	bool m_bQueueDirty;
+	// frames left that must write the packed values into their
+	// section of the mesh library's frame buffer
+	int m_pendingFrameUploads;
+	// counters from the last culling pass
+	CULL_STATS m_cullStats;
+	// scratch memory that only lives for the current frame
+	FrameArena m_frameArena;
+
+	// queue texture images to be decoded in the background
+	bool CreateGLTexture(const char* filename, const char* tag);
+	// allocate the texture arrays and bind them
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// find a loaded texture by tag
+	int FindTextureIndex(TAG_ID tag);
+	// find a defined material by tag
+	int FindMaterialIndex(TAG_ID tag);
+
+	// lighting/material 
+	void DefineObjectMaterials();
+	void UploadObjectMaterials();
+	void SetupSceneLights();
+	void UpdateSceneLights();
+
+	// scene file loading
+	void ResolveSceneTags(const SceneFile& scene, std::vector<int>& textureIndices,
+		std::vector<int>& materialIndices);
+	void AssignSceneRecord(int index, const SCENE_FILE_OBJECT& record);
+	void ApplySceneRecord(int index, const SCENE_FILE_OBJECT& record);
+	void TruncateSceneObjects(int count);
+
+	// retained draw list processing
+	void UpdateSceneObjects();
+	void UpdateObjectBounds(int index);
+	void UpdateShadowCaster(int index);
+	void BuildInstanceData();
+	void CullSceneObjects();
+	void SortVisibleObjects();
+	void CountStateChanges(const std::vector<int>& objects, STATE_CHANGES& changes) const;
+	int GetDrawnTextureArray(const SCENE_OBJECT& object) const;
+	void PackVisibleInstances();
+
+public:
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	// loads textures for the 3D scene im creating
+	void PrepareScene();
+	// brings the scene up to date for the frame, then draws it
+	void UpdateScene();
+	void DrawScene();
+	void LoadSceneTextures();
+	// records the objects of the 3D scene into the draw list
+	void BuildSceneObjects();
+	// records the objects of a scene file into the draw list, or
+	// when a scene is loaded only the objects that differ from it,
+	// returns the number of objects added, changed or removed, or
+	// -1 if the file cannot be read
+	int LoadSceneFile(const char* filename);
+
+	// add an object to the retained draw list, returns its index
+	int AddSceneObject(
+		MESH_TYPE mesh,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// change a recorded object - transform changes mark it dirty
+	void SetObjectTransformations(
+		int index,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+	void SetObjectColor(
+		int index,
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+	void SetObjectTexture(
+		int index,
+		TAG_ID textureTag);
+	void SetObjectUVScale(
+		int index,
+		float u, float v);
+	void SetObjectMaterial(
+		int index,
+		TAG_ID materialTag);
+	// mark an object as moving every frame, so its shadow is drawn
+	// over the cached shadow maps instead of into them
+	void SetObjectDynamic(
+		int index,
+		bool bDynamic);
+
+	// add a point light to the scene, a radius of 0 lights the
+	// whole scene without fading, returns its index
+	int AddPointLight(
+		glm::vec3 positionXYZ,
+		float radius,
+		glm::vec3 ambientColor,
+		glm::vec3 diffuseColor,
+		glm::vec3 specularColor);
+	// get the number of point lights in the scene
+	int GetPointLightCount() const;
+	// give a point light a shadow map, returns false when every
+	// shadow map is taken
+	bool EnablePointLightShadows(int index);
+
+	// set the view and projection the scene is culled against, and
+	// the size in pixels of the viewport it is drawn to
+	void SetViewProjection(const glm::mat4& view, const glm::mat4& projection, const glm::vec2& viewportSize);
+	// get the counters from the last culling pass
+	const CULL_STATS& GetCullStats() const;
+	// get the draw and state change counters of the last sort
+	const RENDER_STATS& GetRenderStats() const;
+	// get the counters of the waits for the GPU to release frame data
+	const RING_BUFFER_STATS& GetFrameBufferStats() const;
+	// get the counters of the shadow map passes
+	const SHADOW_STATS& GetShadowStats() const;
+	// get the counters of the frame scratch memory
+	const FRAME_ARENA_STATS& GetFrameArenaStats() const;
+	// get the counters of the uniform uploads made and skipped
+	UNIFORM_UPLOAD_STATS GetUniformStats() const;
+	// get the number of textures still streaming in
+	int GetPendingTextureCount() const;
+	// set the profiler timing the scene, NULL turns it off
+	void SetProfiler(Profiler* pProfiler);
+	// set the job system the scene update is spread over, NULL
+	// keeps all of the work on the rendering thread
+	void SetJobSystem(JobSystem* pJobSystem);
+	// set the scene file loaded by PrepareScene()
+	void SetSceneFile(const char* filename);
+	// build every variant of the scene program, returns false when
+	// the shaders fail to build
+	bool LoadSceneShaders(const char* vertexShaderFilename, const char* fragmentShaderFilename);
+	// watch the scene file and the shader files and reload them
+	// when they change
+	void EnableHotReload();
+	// reload the watched files that have changed, and swap in the
+	// shaders that have finished building
+	void ReloadChangedFiles();
+
 };
\ No newline at end of file
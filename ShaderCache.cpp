@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.cpp
+// ============
+// on-disk cache of the program binaries the driver built from the shaders
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderCache.h"
+#include "MappedFile.h"
+#include "DataHash.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// directory the cache files are written to
+	const char* g_CacheDirectory = "ShaderCache";
+
+	// identifier at the start of every cache file
+	const char g_CacheIdentifier[8] = { 'G', 'L', 'P', 'R', 'O', 'G', 'B', 'N' };
+	// version of the cache file layout
+	const uint32_t g_CacheVersion = 1;
+
+	// header at the start of a cache file, followed by the binary
+	struct SHADER_CACHE_HEADER
+	{
+		char identifier[8];
+		uint32_t version;
+		uint32_t binaryFormat;		// format the driver gave for the binary
+		uint64_t key;				// key of the program, repeated from the name
+		uint64_t binarySize;
+	};
+
+	// false when the cache has been turned off
+	bool g_bEnabled = true;
+	// counters of the cache use
+	SHADER_CACHE_STATS g_Stats = { 0, 0, 0 };
+
+	// append a value to the text a key is hashed from
+	void AppendKeyText(std::string& text, const char* value)
+	{
+		text += (NULL != value) ? value : "";
+		text += '\n';
+	}
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method is used for checking whether programs go
+ *  through the cache.  A driver that offers no binary format
+ *  has nothing to save.
+ ***********************************************************/
+bool ShaderCache::IsEnabled()
+{
+	if ((g_bEnabled == false) || (GLEW_ARB_get_program_binary == GL_FALSE))
+	{
+		return(false);
+	}
+
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	return(formatCount > 0);
+}
+
+/***********************************************************
+ *  SetEnabled()
+ *
+ *  This method is used for turning the cache on or off, such
+ *  as for timing a start with every shader compiled.
+ ***********************************************************/
+void ShaderCache::SetEnabled(bool bEnabled)
+{
+	g_bEnabled = bEnabled;
+}
+
+/***********************************************************
+ *  GetProgramKey()
+ *
+ *  This method is used for hashing the source of every stage
+ *  of a program together with the strings that identify the
+ *  driver.  A binary is only good for the driver that wrote
+ *  it, so a new driver version gets new keys.
+ ***********************************************************/
+uint64_t ShaderCache::GetProgramKey(const GLenum* types, const std::string* sources, int stageCount)
+{
+	std::string text;
+	AppendKeyText(text, (const char*)glGetString(GL_VENDOR));
+	AppendKeyText(text, (const char*)glGetString(GL_RENDERER));
+	AppendKeyText(text, (const char*)glGetString(GL_VERSION));
+	for (int i = 0; i < stageCount; i++)
+	{
+		AppendKeyText(text, std::to_string(types[i]).c_str());
+		AppendKeyText(text, sources[i].c_str());
+	}
+
+	return(HashData((const unsigned char*)text.data(), text.size()));
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for getting the path of the cache
+ *  file holding the binary of a program.
+ ***********************************************************/
+std::string ShaderCache::GetCachePath(uint64_t key)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)key);
+
+	return(std::string(g_CacheDirectory) + name);
+}
+
+/***********************************************************
+ *  Read()
+ *
+ *  This method is used for creating a program from the
+ *  binary in its cache file.  The binary is handed to the
+ *  driver straight from the mapped file.  A binary the
+ *  driver does not accept, after a driver update that kept
+ *  its version string for instance, is counted as rejected
+ *  and the caller compiles the program from source.
+ ***********************************************************/
+GLuint ShaderCache::Read(uint64_t key)
+{
+	if (IsEnabled() == false)
+	{
+		return(0);
+	}
+
+	MappedFile file;
+	if (file.Open(GetCachePath(key).c_str()) == false)
+	{
+		g_Stats.misses++;
+		return(0);
+	}
+
+	const SHADER_CACHE_HEADER* header = (const SHADER_CACHE_HEADER*)file.GetData();
+	if ((file.GetSize() < sizeof(SHADER_CACHE_HEADER)) ||
+		(memcmp(header->identifier, g_CacheIdentifier, sizeof(g_CacheIdentifier)) != 0) ||
+		(header->version != g_CacheVersion) ||
+		(header->key != key) ||
+		(header->binarySize != file.GetSize() - sizeof(SHADER_CACHE_HEADER)))
+	{
+		g_Stats.misses++;
+		return(0);
+	}
+
+	GLuint program = glCreateProgram();
+	glProgramBinary(program, (GLenum)header->binaryFormat,
+		file.GetData() + sizeof(SHADER_CACHE_HEADER), (GLsizei)header->binarySize);
+
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE)
+	{
+		glDeleteProgram(program);
+		g_Stats.rejected++;
+		g_Stats.misses++;
+		return(0);
+	}
+
+	g_Stats.hits++;
+	return(program);
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for writing the binary of a linked
+ *  program to its cache file.  The program must have been
+ *  linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.  The
+ *  file is written under a temporary name and renamed when
+ *  complete, so a partly written file is never read.
+ ***********************************************************/
+bool ShaderCache::Write(uint64_t key, GLuint program)
+{
+	if (IsEnabled() == false)
+	{
+		return(false);
+	}
+
+	GLint binarySize = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+	if (binarySize <= 0)
+	{
+		return(false);
+	}
+
+	std::vector<unsigned char> binary(binarySize);
+	GLenum binaryFormat = 0;
+	glGetProgramBinary(program, binarySize, &binarySize, &binaryFormat, binary.data());
+
+#ifdef _WIN32
+	_mkdir(g_CacheDirectory);
+#else
+	mkdir(g_CacheDirectory, 0755);
+#endif
+
+	SHADER_CACHE_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.identifier, g_CacheIdentifier, sizeof(g_CacheIdentifier));
+	header.version = g_CacheVersion;
+	header.binaryFormat = binaryFormat;
+	header.key = key;
+	header.binarySize = (uint64_t)binarySize;
+
+	std::string path = GetCachePath(key);
+	std::string tempPath = path + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (file == NULL)
+	{
+		return(false);
+	}
+
+	bool bWritten = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+		(fwrite(binary.data(), 1, binarySize, file) == (size_t)binarySize);
+	bWritten = (fclose(file) == 0) && bWritten;
+
+	// replace any older file with the new one
+	remove(path.c_str());
+	if ((bWritten == false) || (rename(tempPath.c_str(), path.c_str()) != 0))
+	{
+		remove(tempPath.c_str());
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the counters of the
+ *  cache use.
+ ***********************************************************/
+const SHADER_CACHE_STATS& ShaderCache::GetStats()
+{
+	return(g_Stats);
+}
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.h
+// ============
+// on-disk cache of the program binaries the driver built from the shaders
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+
+// counters of the cache use since the application started
+struct SHADER_CACHE_STATS
+{
+	int hits;					// programs loaded from a cached binary
+	int misses;					// programs compiled from source
+	int rejected;				// cached binaries the driver would not load
+};
+
+/***********************************************************
+ *  ShaderCache
+ *
+ *  This class reads and writes cache files holding the
+ *  binary of a linked shader program, as handed out by the
+ *  driver.  A cache file is named after a hash of the source
+ *  of every stage together with the vendor, renderer and
+ *  version of the driver, so editing a shader or updating
+ *  the driver simply misses the cache.  A driver may still
+ *  refuse a binary it wrote, in which case the program is
+ *  compiled from source again.
+ ***********************************************************/
+class ShaderCache
+{
+public:
+	// check whether programs are loaded from and saved to the
+	// cache, which needs a driver with program binary formats
+	static bool IsEnabled();
+	// turn the cache on or off
+	static void SetEnabled(bool bEnabled);
+
+	// get the key of a program built from the passed in stages
+	// by the current driver
+	static uint64_t GetProgramKey(const GLenum* types, const std::string* sources, int stageCount);
+	// get the path of the cache file for a program key
+	static std::string GetCachePath(uint64_t key);
+
+	// create a program from a cached binary, returns 0 if the file
+	// is missing or the driver does not accept the binary
+	static GLuint Read(uint64_t key);
+	// write the binary of a linked program to its cache file
+	static bool Write(uint64_t key, GLuint program);
+
+	// get the counters of the cache use
+	static const SHADER_CACHE_STATS& GetStats();
+};
@@ -0,0 +1,538 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderprogram.cpp
+// ============
+// compile and link shader programs that are not managed by the ShaderManager
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderProgram.h"
+#include "ShaderCache.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	// true once the driver has been asked to compile on its own threads
+	bool g_bParallelCompileEnabled = false;
+}
+
+/***********************************************************
+ *  ShaderProgram()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderProgram::ShaderProgram()
+{
+	m_programID = 0;
+	m_stageCount = 0;
+	m_pendingProgramID = 0;
+	m_pendingKey = 0;
+	m_bPendingFromCache = false;
+	for (int i = 0; i < MAX_STAGES; i++)
+	{
+		m_stageTypes[i] = 0;
+		m_pendingShaders[i] = 0;
+	}
+}
+
+/***********************************************************
+ *  ~ShaderProgram()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShaderProgram::~ShaderProgram()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  LoadCompute()
+ *
+ *  This method is used for building the program from a
+ *  compute shader file.  The previous program is replaced
+ *  when the new one builds.
+ ***********************************************************/
+bool ShaderProgram::LoadCompute(const char* computeFilename)
+{
+	GLenum type = GL_COMPUTE_SHADER;
+	if (BeginLoad(&type, &computeFilename, 1) == false)
+	{
+		return(false);
+	}
+
+	return(FinishPendingLoad());
+}
+
+/***********************************************************
+ *  LoadShaders()
+ *
+ *  This method is used for building the program from vertex
+ *  and fragment shader files.  The previous program is
+ *  replaced when the new one builds.
+ ***********************************************************/
+bool ShaderProgram::LoadShaders(const char* vertexFilename, const char* fragmentFilename)
+{
+	if (BeginLoadShaders(vertexFilename, fragmentFilename) == false)
+	{
+		return(false);
+	}
+
+	return(FinishPendingLoad());
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for releasing the program, and the
+ *  one being built.
+ ***********************************************************/
+void ShaderProgram::Destroy()
+{
+	CancelPendingLoad();
+
+	if (m_programID != 0)
+	{
+		glDeleteProgram(m_programID);
+		m_programID = 0;
+	}
+}
+
+/***********************************************************
+ *  SetDefines()
+ *
+ *  This method is used for setting the preprocessor defines
+ *  put in front of the source of every stage.  They are kept
+ *  for reloading, and are part of the source the binary
+ *  cache key is made from, so each variant of a program is
+ *  cached on its own.
+ ***********************************************************/
+void ShaderProgram::SetDefines(const char* defines)
+{
+	m_defines = (NULL != defines) ? defines : "";
+}
+
+/***********************************************************
+ *  BeginLoadShaders()
+ *
+ *  This method is used for starting to build a program from
+ *  vertex and fragment shader files.  The current program
+ *  stays in use until UpdatePendingLoad() swaps the new one
+ *  in.
+ ***********************************************************/
+bool ShaderProgram::BeginLoadShaders(const char* vertexFilename, const char* fragmentFilename)
+{
+	GLenum types[2] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+	const char* filenames[2] = { vertexFilename, fragmentFilename };
+
+	return(BeginLoad(types, filenames, 2));
+}
+
+/***********************************************************
+ *  BeginReload()
+ *
+ *  This method is used for starting to build the program
+ *  again from its files, after they have been edited.  A
+ *  build that is still pending is dropped first.  Every file
+ *  is read before anything is handed to the driver, so a
+ *  missing file leaves nothing pending.  When the binary
+ *  cache holds a program built from the same sources by the
+ *  same driver it is loaded from there instead, and is
+ *  ready at once.
+ ***********************************************************/
+bool ShaderProgram::BeginReload()
+{
+	if (m_stageCount == 0)
+	{
+		return(false);
+	}
+
+	CancelPendingLoad();
+
+	std::string sources[MAX_STAGES];
+	for (int i = 0; i < m_stageCount; i++)
+	{
+		if (ReadSourceFile(m_filenames[i].c_str(), sources[i]) == false)
+		{
+			return(false);
+		}
+		InsertDefines(sources[i], m_defines);
+	}
+
+	m_pendingKey = ShaderCache::GetProgramKey(m_stageTypes, sources, m_stageCount);
+	m_pendingProgramID = ShaderCache::Read(m_pendingKey);
+	m_bPendingFromCache = (m_pendingProgramID != 0);
+	if (m_bPendingFromCache == true)
+	{
+		return(true);
+	}
+
+	// with parallel compiling the compile and link calls below
+	// return at once, and the driver finishes them on its own
+	// threads
+	if ((g_bParallelCompileEnabled == false) && (GLEW_KHR_parallel_shader_compile == GL_TRUE))
+	{
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+		g_bParallelCompileEnabled = true;
+	}
+
+	m_pendingProgramID = glCreateProgram();
+	if (ShaderCache::IsEnabled() == true)
+	{
+		glProgramParameteri(m_pendingProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	for (int i = 0; i < m_stageCount; i++)
+	{
+		m_pendingShaders[i] = CompileShader(m_stageTypes[i], sources[i]);
+		glAttachShader(m_pendingProgramID, m_pendingShaders[i]);
+	}
+	glLinkProgram(m_pendingProgramID);
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsLoadPending()
+ *
+ *  This method is used for checking whether a program is
+ *  being built.
+ ***********************************************************/
+bool ShaderProgram::IsLoadPending() const
+{
+	return(m_pendingProgramID != 0);
+}
+
+/***********************************************************
+ *  UpdatePendingLoad()
+ *
+ *  This method is used for swapping in the program being
+ *  built once the driver reports it finished, which it can
+ *  only do with parallel compiling.  Without it the build
+ *  is finished here, waiting for the driver.  Returns true
+ *  when a new program took over, which the caller has to
+ *  make current and set up again.
+ ***********************************************************/
+bool ShaderProgram::UpdatePendingLoad()
+{
+	if (m_pendingProgramID == 0)
+	{
+		return(false);
+	}
+
+	if (GLEW_KHR_parallel_shader_compile == GL_TRUE)
+	{
+		GLint completed = GL_FALSE;
+		glGetProgramiv(m_pendingProgramID, GL_COMPLETION_STATUS_KHR, &completed);
+		if (completed == GL_FALSE)
+		{
+			return(false);
+		}
+	}
+
+	return(FinishPendingLoad());
+}
+
+/***********************************************************
+ *  UsesFile()
+ *
+ *  This method is used for checking whether one of the files
+ *  the program is built from is the passed in file.
+ ***********************************************************/
+bool ShaderProgram::UsesFile(const char* filename) const
+{
+	for (int i = 0; i < m_stageCount; i++)
+	{
+		if (m_filenames[i] == filename)
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetFileCount()
+ *
+ *  This method is used for getting the number of files the
+ *  program is built from.
+ ***********************************************************/
+int ShaderProgram::GetFileCount() const
+{
+	return(m_stageCount);
+}
+
+/***********************************************************
+ *  GetFilename()
+ *
+ *  This method is used for getting one of the files the
+ *  program is built from.
+ ***********************************************************/
+const char* ShaderProgram::GetFilename(int index) const
+{
+	if ((index < 0) || (index >= m_stageCount))
+	{
+		return(NULL);
+	}
+
+	return(m_filenames[index].c_str());
+}
+
+/***********************************************************
+ *  IsLoaded()
+ *
+ *  This method is used for checking whether the program has
+ *  been built.
+ ***********************************************************/
+bool ShaderProgram::IsLoaded() const
+{
+	return(m_programID != 0);
+}
+
+/***********************************************************
+ *  GetProgram()
+ *
+ *  This method is used for getting the OpenGL program.
+ ***********************************************************/
+GLuint ShaderProgram::GetProgram() const
+{
+	return(m_programID);
+}
+
+/***********************************************************
+ *  GetUniformLocation()
+ *
+ *  This method is used for getting the location of a uniform
+ *  in the program.  The locations never change once the
+ *  program is linked, so callers look them up once, and
+ *  again after a new program has been swapped in.
+ ***********************************************************/
+GLint ShaderProgram::GetUniformLocation(const char* name) const
+{
+	if (m_programID == 0)
+	{
+		return(-1);
+	}
+
+	return(glGetUniformLocation(m_programID, name));
+}
+
+/***********************************************************
+ *  BeginLoad()
+ *
+ *  This method is used for keeping the stages and files of
+ *  the program, so it can be built again later, and for
+ *  starting the build.
+ ***********************************************************/
+bool ShaderProgram::BeginLoad(const GLenum* types, const char* const* filenames, int stageCount)
+{
+	CancelPendingLoad();
+
+	m_stageCount = stageCount;
+	for (int i = 0; i < stageCount; i++)
+	{
+		m_stageTypes[i] = types[i];
+		m_filenames[i] = filenames[i];
+	}
+
+	return(BeginReload());
+}
+
+/***********************************************************
+ *  FinishPendingLoad()
+ *
+ *  This method is used for checking the program being built
+ *  and swapping it in for the current program.  Asking for
+ *  the status waits for the driver when it is not done yet.
+ *  The stages are no longer needed once the program is
+ *  linked, so they are always released.  A program with
+ *  errors is dropped and the current program kept, and a
+ *  program compiled from source is saved to the binary
+ *  cache for the next time.
+ ***********************************************************/
+bool ShaderProgram::FinishPendingLoad()
+{
+	if (m_pendingProgramID == 0)
+	{
+		return(false);
+	}
+
+	// a program from the cache has no stages
+	bool bCompiled = true;
+	for (int i = 0; (i < m_stageCount) && (m_bPendingFromCache == false); i++)
+	{
+		if (CheckShader(m_pendingShaders[i], m_filenames[i].c_str()) == false)
+		{
+			bCompiled = false;
+		}
+		glDetachShader(m_pendingProgramID, m_pendingShaders[i]);
+		glDeleteShader(m_pendingShaders[i]);
+		m_pendingShaders[i] = 0;
+	}
+
+	GLuint program = m_pendingProgramID;
+	m_pendingProgramID = 0;
+
+	// the link log only repeats the compile errors
+	if ((bCompiled == false) ||
+		(CheckProgram(program, m_filenames[m_stageCount - 1].c_str()) == false))
+	{
+		glDeleteProgram(program);
+		return(false);
+	}
+
+	if (m_bPendingFromCache == false)
+	{
+		ShaderCache::Write(m_pendingKey, program);
+	}
+
+	if (m_programID != 0)
+	{
+		glDeleteProgram(m_programID);
+	}
+	m_programID = program;
+
+	return(true);
+}
+
+/***********************************************************
+ *  CancelPendingLoad()
+ *
+ *  This method is used for dropping the program being built
+ *  along with its stages.
+ ***********************************************************/
+void ShaderProgram::CancelPendingLoad()
+{
+	if (m_pendingProgramID == 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < m_stageCount; i++)
+	{
+		glDeleteShader(m_pendingShaders[i]);
+		m_pendingShaders[i] = 0;
+	}
+	glDeleteProgram(m_pendingProgramID);
+	m_pendingProgramID = 0;
+}
+
+/***********************************************************
+ *  ReadSourceFile()
+ *
+ *  This method is used for reading the whole source of a
+ *  shader file.
+ ***********************************************************/
+bool ShaderProgram::ReadSourceFile(const char* filename, std::string& source)
+{
+	std::ifstream file(filename);
+	if (file.is_open() == false)
+	{
+		std::cout << "Could not open shader file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::stringstream stream;
+	stream << file.rdbuf();
+	source = stream.str();
+
+	return(true);
+}
+
+/***********************************************************
+ *  InsertDefines()
+ *
+ *  This method is used for putting the defines into a shader
+ *  source right after its #version line, which has to stay
+ *  the first line.  A source without one gets them in front.
+ ***********************************************************/
+void ShaderProgram::InsertDefines(std::string& source, const std::string& defines)
+{
+	if (defines.empty() == true)
+	{
+		return;
+	}
+
+	size_t position = 0;
+	size_t version = source.find("#version");
+	if (version != std::string::npos)
+	{
+		size_t lineEnd = source.find('\n', version);
+		if (lineEnd == std::string::npos)
+		{
+			source += '\n';
+			lineEnd = source.size() - 1;
+		}
+		position = lineEnd + 1;
+	}
+
+	source.insert(position, defines);
+}
+
+/***********************************************************
+ *  CompileShader()
+ *
+ *  This method is used for starting to compile one shader
+ *  stage.  Whether it compiled is only asked for later, so
+ *  the driver is not made to wait here.
+ ***********************************************************/
+GLuint ShaderProgram::CompileShader(GLenum type, const std::string& source)
+{
+	GLuint shader = glCreateShader(type);
+	const GLchar* sourceText = source.c_str();
+	glShaderSource(shader, 1, &sourceText, NULL);
+	glCompileShader(shader);
+
+	return(shader);
+}
+
+/***********************************************************
+ *  CheckShader()
+ *
+ *  This method is used for checking that a shader stage
+ *  compiled.  The compile log is written out when it did
+ *  not.
+ ***********************************************************/
+bool ShaderProgram::CheckShader(GLuint shader, const char* filename)
+{
+	GLint compiled = GL_FALSE;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+	if (compiled == GL_FALSE)
+	{
+		GLint logLength = 0;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+		std::vector<GLchar> log(logLength + 1, 0);
+		glGetShaderInfoLog(shader, logLength, NULL, log.data());
+		std::cout << "Could not compile shader file:" << filename << "\n" << log.data() << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CheckProgram()
+ *
+ *  This method is used for checking that a program linked.
+ *  The link log is written out when it did not.
+ ***********************************************************/
+bool ShaderProgram::CheckProgram(GLuint program, const char* filename)
+{
+	GLint linked = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+	if (linked == GL_FALSE)
+	{
+		GLint logLength = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+		std::vector<GLchar> log(logLength + 1, 0);
+		glGetProgramInfoLog(program, logLength, NULL, log.data());
+		std::cout << "Could not link shader program:" << filename << "\n" << log.data() << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
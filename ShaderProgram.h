@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderprogram.h
+// ============
+// compile and link shader programs that are not managed by the ShaderManager
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  ShaderProgram
+ *
+ *  This class owns one shader program built from GLSL source
+ *  files, such as the compute passes that run beside the
+ *  scene shaders.  Compile and link errors are written to
+ *  the console along with the file they came from.  A
+ *  program can be built again while the current one stays
+ *  in use: the driver compiles it on its own threads where
+ *  it can, and the new program only takes over once it has
+ *  built without errors.  A program built before from the
+ *  same sources is loaded from the binary the driver gave
+ *  for it, which skips compiling altogether.  Lines of
+ *  preprocessor defines can be put in front of the source of
+ *  every stage, so one set of files builds several variants
+ *  of a program.
+ ***********************************************************/
+class ShaderProgram
+{
+public:
+	// constructor
+	ShaderProgram();
+	// destructor
+	~ShaderProgram();
+
+	// build a program from a compute shader file, returns false
+	// when it does not compile or link
+	bool LoadCompute(const char* computeFilename);
+	// build a program from vertex and fragment shader files,
+	// returns false when they do not compile or link
+	bool LoadShaders(const char* vertexFilename, const char* fragmentFilename);
+	// release the program
+	void Destroy();
+	// set the preprocessor defines put after the #version line of
+	// every stage, such as "#define USE_TEXTURE\n", for the builds
+	// that follow
+	void SetDefines(const char* defines);
+
+	// start building a program from vertex and fragment shader
+	// files without waiting for the driver, returns false when
+	// a file cannot be read
+	bool BeginLoadShaders(const char* vertexFilename, const char* fragmentFilename);
+	// start building the program again from the files it was
+	// last built from, returns false when a file cannot be read
+	bool BeginReload();
+	// check whether a program is being built
+	bool IsLoadPending() const;
+	// swap in the program being built once the driver has
+	// finished it, returns true when the new program took over,
+	// a program with errors is dropped and the current one kept
+	bool UpdatePendingLoad();
+	// wait for the program being built and swap it in, returns
+	// false when it has errors
+	bool FinishPendingLoad();
+	// check whether the program is built from a file
+	bool UsesFile(const char* filename) const;
+	// get the number of files the program is built from, and
+	// each of the files
+	int GetFileCount() const;
+	const char* GetFilename(int index) const;
+
+	// check whether the program has been built
+	bool IsLoaded() const;
+	// get the OpenGL program
+	GLuint GetProgram() const;
+	// get the location of a uniform, -1 when it is not used
+	GLint GetUniformLocation(const char* name) const;
+
+private:
+	// most shader stages a program is built from
+	static const int MAX_STAGES = 2;
+
+	// OpenGL program object
+	GLuint m_programID;
+	// shader stages and the files they are built from
+	GLenum m_stageTypes[MAX_STAGES];
+	std::string m_filenames[MAX_STAGES];
+	int m_stageCount;
+	// program being built and its stages, 0 when none is pending
+	GLuint m_pendingProgramID;
+	GLuint m_pendingShaders[MAX_STAGES];
+	// binary cache key of the program being built, and whether it
+	// was loaded from the cache rather than compiled
+	uint64_t m_pendingKey;
+	bool m_bPendingFromCache;
+	// preprocessor defines put in front of every stage
+	std::string m_defines;
+
+	// remember the stages of the program and start building it
+	bool BeginLoad(const GLenum* types, const char* const* filenames, int stageCount);
+	// drop the program being built
+	void CancelPendingLoad();
+
+	// read the source of a shader file
+	static bool ReadSourceFile(const char* filename, std::string& source);
+	// put the defines after the #version line of a source
+	static void InsertDefines(std::string& source, const std::string& defines);
+	// start compiling one shader stage
+	static GLuint CompileShader(GLenum type, const std::string& source);
+	// check that a shader stage compiled, writing out its log
+	// when it did not
+	static bool CheckShader(GLuint shader, const char* filename);
+	// check that a program linked, writing out its log when it
+	// did not
+	static bool CheckProgram(GLuint program, const char* filename);
+};
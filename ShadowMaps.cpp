@@ -0,0 +1,490 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.cpp
+// ============
+// cached cube shadow maps for the shadow casting point lights
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShadowMaps.h"
+
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// width and height of every cube face
+	const int g_ShadowMapSize = 512;
+	// distance from the light where the shadow pass starts
+	const float g_ShadowNearPlane = 0.05f;
+	// casters the caster buffer has room for when first created
+	const int g_InitialCasterCapacity = 64;
+
+	// view direction and up vector of each cube face, in the
+	// order of the cube map layers
+	const glm::vec3 g_FaceDirections[6][2] =
+	{
+		{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f) },
+		{ glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) },
+		{ glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f) },
+		{ glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, -1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f) }
+	};
+}
+
+/***********************************************************
+ *  ShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShadowMaps::ShadowMaps()
+{
+	m_faceViewProjectionLocation = -1;
+	m_lightPositionLocation = -1;
+	m_framebuffer = 0;
+	m_casterBuffer = 0;
+	m_commandBuffer = 0;
+	m_casterCapacity = 0;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/***********************************************************
+ *  ~ShadowMaps()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShadowMaps::~ShadowMaps()
+{
+	for (int i = 0; i < m_lights.size(); i++)
+	{
+		glDeleteTextures(1, &m_lights[i].staticMap);
+		glDeleteTextures(1, &m_lights[i].shadowMap);
+	}
+	m_lights.clear();
+
+	if (m_framebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		glDeleteBuffers(1, &m_casterBuffer);
+		glDeleteBuffers(1, &m_commandBuffer);
+		m_framebuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for building the depth pass and
+ *  creating the buffers the casters are drawn from.  The
+ *  cube maps are only created as lights are given shadows.
+ ***********************************************************/
+bool ShadowMaps::Create(const char* vertexShaderFilename, const char* fragmentShaderFilename)
+{
+	if (m_depthProgram.LoadShaders(vertexShaderFilename, fragmentShaderFilename) == false)
+	{
+		return(false);
+	}
+
+	m_faceViewProjectionLocation = m_depthProgram.GetUniformLocation("faceViewProjection");
+	m_lightPositionLocation = m_depthProgram.GetUniformLocation("lightPosition");
+
+	// the depth pass has no color output
+	GLint previousFramebuffer = 0;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+
+	m_casterCapacity = g_InitialCasterCapacity;
+	glGenBuffers(1, &m_casterBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_casterBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::mat4) * m_casterCapacity, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SHADOW_CASTER_BINDING, m_casterBuffer);
+
+	// one command per mesh is all a pass ever needs
+	glGenBuffers(1, &m_commandBuffer);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(MeshLibrary::DRAW_ELEMENTS_COMMAND) * MESH_COUNT, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used for giving a light one of the shadow
+ *  maps, and binding the map the scene is lit with to the
+ *  texture unit of its index.  The map is rendered with the
+ *  next pass.
+ ***********************************************************/
+int ShadowMaps::AddLight()
+{
+	if ((m_framebuffer == 0) || (m_lights.size() >= MAX_SHADOW_LIGHTS))
+	{
+		return(-1);
+	}
+
+	SHADOW_LIGHT light;
+	light.staticMap = CreateCubeMap(false);
+	light.shadowMap = CreateCubeMap(true);
+	light.position = glm::vec3(0.0f);
+	light.farPlane = 1.0f;
+	light.bStaticDirty = true;
+	light.bHasOverlay = false;
+	m_lights.push_back(light);
+
+	glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_TEXTURE_UNIT + (GLenum)m_lights.size() - 1);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, light.shadowMap);
+	glActiveTexture(GL_TEXTURE0);
+
+	return((int)m_lights.size() - 1);
+}
+
+/***********************************************************
+ *  SetLight()
+ *
+ *  This method is used for placing the light of a shadow
+ *  map.  The cached map is only rendered again when the
+ *  light has actually moved or its reach has changed.
+ ***********************************************************/
+void ShadowMaps::SetLight(int shadowIndex, glm::vec3 position, float farPlane)
+{
+	if ((shadowIndex < 0) || (shadowIndex >= m_lights.size()))
+	{
+		return;
+	}
+
+	SHADOW_LIGHT& light = m_lights[shadowIndex];
+	if ((light.position != position) || (light.farPlane != farPlane))
+	{
+		light.position = position;
+		light.farPlane = farPlane;
+		light.bStaticDirty = true;
+	}
+}
+
+/***********************************************************
+ *  InvalidateBounds()
+ *
+ *  This method is used for marking the cached maps of the
+ *  lights that reach a box as out of date.  It is passed the
+ *  box of a static caster both before and after it changes,
+ *  so the shadow is removed from where it was as well.
+ ***********************************************************/
+void ShadowMaps::InvalidateBounds(const BVH_BOUNDS& bounds)
+{
+	for (int i = 0; i < m_lights.size(); i++)
+	{
+		if (IsInRange(m_lights[i], bounds) == true)
+		{
+			m_lights[i].bStaticDirty = true;
+		}
+	}
+}
+
+/***********************************************************
+ *  ReloadShaders()
+ *
+ *  This method is used for building the depth pass again
+ *  after one of its shader files was edited.  The current
+ *  pass keeps rendering until the new one is ready.
+ ***********************************************************/
+void ShadowMaps::ReloadShaders(const char* filename)
+{
+	if (m_depthProgram.UsesFile(filename) == true)
+	{
+		m_depthProgram.BeginReload();
+	}
+}
+
+/***********************************************************
+ *  SwapReloadedShaders()
+ *
+ *  This method is used for switching to the rebuilt depth
+ *  pass once it has built.  Its uniforms are looked up again,
+ *  and every cached map is rendered again with it.
+ ***********************************************************/
+bool ShadowMaps::SwapReloadedShaders()
+{
+	if (m_depthProgram.UpdatePendingLoad() == false)
+	{
+		return(false);
+	}
+
+	m_faceViewProjectionLocation = m_depthProgram.GetUniformLocation("faceViewProjection");
+	m_lightPositionLocation = m_depthProgram.GetUniformLocation("lightPosition");
+	for (int i = 0; i < m_lights.size(); i++)
+	{
+		m_lights[i].bStaticDirty = true;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Render()
+ *
+ *  This method is used for bringing the shadow maps up to
+ *  date.  A cached map that is out of date is rendered from
+ *  the static casters in range and copied to the map the
+ *  scene is lit with.  When dynamic casters are in range,
+ *  the cache is copied again and they are drawn over it, so
+ *  the cache never holds a moving object.  A light with
+ *  nothing changed and no dynamic casters costs nothing.
+ ***********************************************************/
+bool ShadowMaps::Render(
+	const MeshLibrary* pMeshes,
+	FrameArena& arena,
+	const std::vector<SHADOW_CASTER>& casters,
+	const std::vector<int>& dynamicCasters)
+{
+	if ((NULL == pMeshes) || (m_depthProgram.IsLoaded() == false))
+	{
+		return(false);
+	}
+
+	bool bStarted = false;
+	GLint previousFramebuffer = 0;
+	GLint previousViewport[4];
+
+	for (int i = 0; i < m_lights.size(); i++)
+	{
+		SHADOW_LIGHT& light = m_lights[i];
+		bool bStaticRendered = light.bStaticDirty;
+		int staticDraws = 0;
+		int dynamicDraws = 0;
+
+		if ((bStaticRendered == false) && (dynamicCasters.size() == 0) && (light.bHasOverlay == false))
+		{
+			continue;
+		}
+
+		// the depth pass state is only set up once something draws
+		if (bStarted == false)
+		{
+			glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+			glGetIntegerv(GL_VIEWPORT, previousViewport);
+			glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+			glViewport(0, 0, g_ShadowMapSize, g_ShadowMapSize);
+			glUseProgram(m_depthProgram.GetProgram());
+			bStarted = true;
+		}
+		glUniform4f(m_lightPositionLocation, light.position.x, light.position.y, light.position.z, light.farPlane);
+
+		if (bStaticRendered == true)
+		{
+			staticDraws = GatherCasters(pMeshes, arena, light, casters, NULL);
+			RenderFaces(pMeshes, light.staticMap, i, staticDraws, true);
+			light.bStaticDirty = false;
+			m_stats.staticRenders++;
+		}
+
+		if (dynamicCasters.size() > 0)
+		{
+			dynamicDraws = GatherCasters(pMeshes, arena, light, casters, &dynamicCasters);
+		}
+
+		// the overlay of the last frame is wiped out by the copy
+		if ((bStaticRendered == true) || (light.bHasOverlay == true) || (dynamicDraws > 0))
+		{
+			glCopyImageSubData(
+				light.staticMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+				light.shadowMap, GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+				g_ShadowMapSize, g_ShadowMapSize, 6);
+		}
+		if (dynamicDraws > 0)
+		{
+			RenderFaces(pMeshes, light.shadowMap, i, dynamicDraws, false);
+			m_stats.overlayRenders++;
+		}
+		light.bHasOverlay = (dynamicDraws > 0);
+	}
+
+	if (bStarted == true)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, previousFramebuffer);
+		glViewport(previousViewport[0], previousViewport[1], previousViewport[2], previousViewport[3]);
+	}
+
+	return(bStarted);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the counters of the
+ *  shadow map passes.
+ ***********************************************************/
+const SHADOW_STATS& ShadowMaps::GetStats() const
+{
+	return(m_stats);
+}
+
+/***********************************************************
+ *  IsInRange()
+ *
+ *  This method is used for checking whether any part of a
+ *  box is closer to a light than the reach of its shadows.
+ ***********************************************************/
+bool ShadowMaps::IsInRange(const SHADOW_LIGHT& light, const BVH_BOUNDS& bounds)
+{
+	glm::vec3 closest = glm::clamp(light.position, bounds.boundsMin, bounds.boundsMax);
+	glm::vec3 offset = closest - light.position;
+
+	return(glm::dot(offset, offset) <= light.farPlane * light.farPlane);
+}
+
+/***********************************************************
+ *  GatherCasters()
+ *
+ *  This method is used for uploading the model matrices of
+ *  the casters in range of a light, grouped by mesh, and one
+ *  indirect command per mesh.  Without a list of dynamic
+ *  casters every static caster is considered.  The matrices
+ *  are gathered in frame scratch memory, and the caster
+ *  buffer only grows.
+ ***********************************************************/
+int ShadowMaps::GatherCasters(
+	const MeshLibrary* pMeshes,
+	FrameArena& arena,
+	const SHADOW_LIGHT& light,
+	const std::vector<SHADOW_CASTER>& casters,
+	const std::vector<int>* pDynamicCasters)
+{
+	// the casters in range are counted by mesh first, so their
+	// matrices can be placed grouped by mesh in one pass
+	int count = (NULL == pDynamicCasters) ? (int)casters.size() : (int)pDynamicCasters->size();
+	int* casterIndices = arena.Allocate<int>(count);
+	int inRangeCount = 0;
+	int meshCounts[MESH_COUNT] = {};
+	for (int i = 0; i < count; i++)
+	{
+		int casterIndex = (NULL == pDynamicCasters) ? i : (*pDynamicCasters)[i];
+		const SHADOW_CASTER& caster = casters[casterIndex];
+		if ((NULL == pDynamicCasters) && (caster.bDynamic == true))
+		{
+			continue;
+		}
+		if (IsInRange(light, caster.bounds) == true)
+		{
+			casterIndices[inRangeCount++] = casterIndex;
+			meshCounts[caster.mesh]++;
+		}
+	}
+	if (inRangeCount == 0)
+	{
+		return(0);
+	}
+
+	MeshLibrary::DRAW_ELEMENTS_COMMAND commands[MESH_COUNT];
+	int meshStarts[MESH_COUNT];
+	int drawCount = 0;
+	int firstInstance = 0;
+	for (int mesh = 0; mesh < MESH_COUNT; mesh++)
+	{
+		meshStarts[mesh] = firstInstance;
+		if (meshCounts[mesh] > 0)
+		{
+			// shadows are always cast by the finest level of detail
+			pMeshes->MakeDrawCommand((MESH_TYPE)mesh, 0, firstInstance, meshCounts[mesh], commands[drawCount]);
+			firstInstance += meshCounts[mesh];
+			drawCount++;
+		}
+	}
+
+	glm::mat4* casterModels = arena.Allocate<glm::mat4>(inRangeCount);
+	for (int i = 0; i < inRangeCount; i++)
+	{
+		const SHADOW_CASTER& caster = casters[casterIndices[i]];
+		casterModels[meshStarts[caster.mesh]++] = caster.model;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_casterBuffer);
+	if (inRangeCount > m_casterCapacity)
+	{
+		m_casterCapacity = inRangeCount * 2;
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(glm::mat4) * m_casterCapacity, NULL, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(glm::mat4) * inRangeCount, casterModels);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(MeshLibrary::DRAW_ELEMENTS_COMMAND) * drawCount, commands);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	m_stats.castersDrawn += inRangeCount * 6;
+
+	return(drawCount);
+}
+
+/***********************************************************
+ *  CreateCubeMap()
+ *
+ *  This method is used for creating an empty cube map for
+ *  the depth of the shadow casters.  A map the scene is lit
+ *  with compares the depth when sampled, which the sampler
+ *  filters over the closest four texels.
+ ***********************************************************/
+GLuint ShadowMaps::CreateCubeMap(bool bCompare)
+{
+	GLuint cubeMap = 0;
+	glGenTextures(1, &cubeMap);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMap);
+	glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_DEPTH_COMPONENT24, g_ShadowMapSize, g_ShadowMapSize);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	if (bCompare == true)
+	{
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	}
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+	return(cubeMap);
+}
+
+/***********************************************************
+ *  RenderFaces()
+ *
+ *  This method is used for drawing the gathered casters into
+ *  the six faces of the cube map of a light, looking out
+ *  from the light along each axis.
+ ***********************************************************/
+void ShadowMaps::RenderFaces(
+	const MeshLibrary* pMeshes,
+	GLuint cubeMap,
+	int shadowIndex,
+	int drawCount,
+	bool bClear)
+{
+	const SHADOW_LIGHT& light = m_lights[shadowIndex];
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, g_ShadowNearPlane, light.farPlane);
+
+	for (int face = 0; face < 6; face++)
+	{
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, cubeMap, 0);
+		if (bClear == true)
+		{
+			glClear(GL_DEPTH_BUFFER_BIT);
+		}
+
+		glm::mat4 view = glm::lookAt(light.position, light.position + g_FaceDirections[face][0], g_FaceDirections[face][1]);
+		glm::mat4 faceViewProjection = projection * view;
+		glUniformMatrix4fv(m_faceViewProjectionLocation, 1, GL_FALSE, glm::value_ptr(faceViewProjection));
+
+		pMeshes->DrawCommands(m_commandBuffer, drawCount);
+	}
+}
@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.h
+// ============
+// cached cube shadow maps for the shadow casting point lights
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderProgram.h"
+#include "MeshLibrary.h"
+#include "SceneBVH.h"
+#include "FrameArena.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// shader storage binding point of the caster model matrices read
+// by the shadow vertex shader - this must match the shader
+const GLuint SHADOW_CASTER_BINDING = 5;
+// texture unit of the first shadow map, the first one after the
+// units of the texture arrays - each further map uses the next unit,
+// this must match the define in the fragment shader
+const int SHADOW_MAP_TEXTURE_UNIT = 8;
+// most lights that can cast shadows at the same time - this
+// must match the fragment shader
+const int MAX_SHADOW_LIGHTS = 4;
+
+// one object that can cast a shadow
+struct SHADOW_CASTER
+{
+	glm::mat4 model;
+	BVH_BOUNDS bounds;
+	MESH_TYPE mesh;
+	bool bDynamic;			// drawn into the overlay every frame instead of the cache
+};
+
+// counters of the shadow map passes since the maps were created
+struct SHADOW_STATS
+{
+	int staticRenders;		// cached maps rendered again
+	int overlayRenders;		// maps with the dynamic casters drawn over the cache
+	int castersDrawn;		// casters drawn into all of the cube faces
+};
+
+/***********************************************************
+ *  ShadowMaps
+ *
+ *  This class renders a cube shadow map for each shadow
+ *  casting point light, holding the distance from the light
+ *  to the closest caster in every direction.  The static
+ *  casters are rendered into a cached map, which is only
+ *  rendered again when the light moves or a static caster
+ *  within its range changes.  The dynamic casters are drawn
+ *  over a copy of the cache each frame, so a moving object
+ *  never costs more than its own draws.  Each map stays
+ *  bound to its own texture unit for the fragment shader.
+ ***********************************************************/
+class ShadowMaps
+{
+public:
+	// constructor
+	ShadowMaps();
+	// destructor
+	~ShadowMaps();
+
+	// build the depth pass and create the shadow maps, returns
+	// false when the shaders fail to build
+	bool Create(const char* vertexShaderFilename, const char* fragmentShaderFilename);
+	// give a light a shadow map, returns the index of the map or
+	// -1 when every shadow map is taken
+	int AddLight();
+	// place the light of a shadow map, and set the distance its
+	// shadows reach
+	void SetLight(int shadowIndex, glm::vec3 position, float farPlane);
+	// mark the cached maps covering a box as out of date, after a
+	// static caster inside of it has changed
+	void InvalidateBounds(const BVH_BOUNDS& bounds);
+	// start building the depth pass again when it is built from
+	// a changed file
+	void ReloadShaders(const char* filename);
+	// swap in the rebuilt depth pass once it is ready, returns
+	// true when it took over
+	bool SwapReloadedShaders();
+
+	// render the shadow maps that are out of date and draw the
+	// dynamic casters over them, gathering the casters in frame
+	// scratch memory, returns true when anything was drawn,
+	// which leaves the depth program current
+	bool Render(
+		const MeshLibrary* pMeshes,
+		FrameArena& arena,
+		const std::vector<SHADOW_CASTER>& casters,
+		const std::vector<int>& dynamicCasters);
+
+	// get the counters of the shadow map passes
+	const SHADOW_STATS& GetStats() const;
+
+private:
+	// placement of the light of a shadow map, and its cube maps
+	struct SHADOW_LIGHT
+	{
+		// cube map with the cached static casters, and the one the
+		// scene is lit with
+		GLuint staticMap;
+		GLuint shadowMap;
+		glm::vec3 position;
+		float farPlane;
+		// true when the cached map must be rendered again
+		bool bStaticDirty;
+		// true when dynamic casters were drawn over the cache
+		bool bHasOverlay;
+	};
+
+	// depth pass writing the distance to the light
+	ShaderProgram m_depthProgram;
+	GLint m_faceViewProjectionLocation;
+	GLint m_lightPositionLocation;
+	// framebuffer the cube faces are attached to in turn
+	GLuint m_framebuffer;
+	// model matrices and indirect commands of the casters drawn
+	GLuint m_casterBuffer;
+	GLuint m_commandBuffer;
+	int m_casterCapacity;
+	// the lights of the shadow maps
+	std::vector<SHADOW_LIGHT> m_lights;
+	SHADOW_STATS m_stats;
+
+	// check whether a box is within the reach of a light
+	static bool IsInRange(const SHADOW_LIGHT& light, const BVH_BOUNDS& bounds);
+	// upload the casters in range of a light, the static ones or
+	// the listed dynamic ones, returns the number of draws
+	int GatherCasters(
+		const MeshLibrary* pMeshes,
+		FrameArena& arena,
+		const SHADOW_LIGHT& light,
+		const std::vector<SHADOW_CASTER>& casters,
+		const std::vector<int>* pDynamicCasters);
+	// create an empty cube map for the depth of the shadow casters
+	static GLuint CreateCubeMap(bool bCompare);
+	// draw the gathered casters into the six faces of a cube map
+	void RenderFaces(
+		const MeshLibrary* pMeshes,
+		GLuint cubeMap,
+		int shadowIndex,
+		int drawCount,
+		bool bClear);
+};
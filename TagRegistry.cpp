@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// tagregistry.cpp
+// ============
+// intern texture and material tag names into integer IDs
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TagRegistry.h"
+
+#include <iostream>
+
+/***********************************************************
+ *  Register()
+ *
+ *  This method is used for interning a tag name and
+ *  associating it with an index.  Two different names that
+ *  hash to the same ID are reported, since they could not
+ *  be told apart by later lookups.
+ ***********************************************************/
+TAG_ID TagRegistry::Register(const char* name, int index)
+{
+	TAG_ID tag = HashTag(name);
+	std::unordered_map<TAG_ID, TAG_ENTRY>::iterator found = m_tags.find(tag);
+
+	if ((found != m_tags.end()) && (found->second.name.compare(name) != 0))
+	{
+		std::cout << "Tag hash collision between:" << found->second.name << " and:" << name << std::endl;
+	}
+
+	TAG_ENTRY& entry = m_tags[tag];
+	entry.name = name;
+	entry.index = index;
+
+	return(tag);
+}
+
+/***********************************************************
+ *  Find()
+ *
+ *  This method is used for getting the index registered for
+ *  a tag ID.
+ ***********************************************************/
+int TagRegistry::Find(TAG_ID tag) const
+{
+	std::unordered_map<TAG_ID, TAG_ENTRY>::const_iterator found = m_tags.find(tag);
+
+	if (found == m_tags.end())
+	{
+		return(-1);
+	}
+
+	return(found->second.index);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for forgetting all registered tags.
+ ***********************************************************/
+void TagRegistry::Clear()
+{
+	m_tags.clear();
+}
@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////
+// tagregistry.h
+// ============
+// intern texture and material tag names into integer IDs
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+// hashed tag name used for all texture and material lookups
+typedef uint32_t TAG_ID;
+
+/***********************************************************
+ *  HashTag()
+ *
+ *  FNV-1a hash of a tag name.  It is constexpr, so tags
+ *  written as string literals are hashed by the compiler.
+ ***********************************************************/
+constexpr TAG_ID HashTag(const char* tag, TAG_ID hash = 2166136261u)
+{
+	return((*tag == 0) ? hash : HashTag(tag + 1, (hash ^ (TAG_ID)(unsigned char)*tag) * 16777619u));
+}
+
+// hash a string literal tag at compile time
+#define TAG(literal) (std::integral_constant<TAG_ID, HashTag(literal)>::value)
+
+/***********************************************************
+ *  TagRegistry
+ *
+ *  This class maps interned tag IDs to indices, such as a
+ * *  texture index or a material index.  Names are only seen
+ *  when a tag is registered; every lookup after that is a
+ *  single hashed integer lookup.
+ ***********************************************************/
+class TagRegistry
+{
+public:
+	// register a tag name for an index, returns its tag ID
+	TAG_ID Register(const char* name, int index);
+	// find the index registered for a tag ID, -1 if unknown
+	int Find(TAG_ID tag) const;
+	// forget all registered tags
+	void Clear();
+
+private:
+	struct TAG_ENTRY
+	{
+		std::string name;
+		int index;
+	};
+
+	// registered tags by tag ID
+	std::unordered_map<TAG_ID, TAG_ENTRY> m_tags;
+};
@@ -0,0 +1,361 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.cpp
+// ============
+// on-disk cache of compressed texture mip chains in a KTX2-style container
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// directory the cache files are written to
+	const char* g_CacheDirectory = "TextureCache";
+
+	// KTX2 file identifier
+	const unsigned char g_KTX2Identifier[12] =
+		{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	// Vulkan format numbers used in the KTX2 header
+	const uint32_t g_VkFormatRGBA8 = 37;		// VK_FORMAT_R8G8B8A8_UNORM
+	const uint32_t g_VkFormatBC1 = 131;			// VK_FORMAT_BC1_RGB_UNORM_BLOCK
+	const uint32_t g_VkFormatBC3 = 137;			// VK_FORMAT_BC3_UNORM_BLOCK
+
+	// KTX2 file header
+	struct KTX2_HEADER
+	{
+		unsigned char identifier[12];
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+
+	// KTX2 entry of the level index following the header
+	struct KTX2_LEVEL
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+
+	static_assert(sizeof(KTX2_HEADER) == 80, "KTX2 header must be 80 bytes");
+	static_assert(sizeof(KTX2_LEVEL) == 24, "KTX2 level index entry must be 24 bytes");
+
+	// Khronos Data Format values used in the data format descriptor
+	const uint32_t g_DfdColorModelRGBSDA = 1;
+	const uint32_t g_DfdColorModelBC1A = 128;
+	const uint32_t g_DfdColorModelBC3 = 130;
+	const uint32_t g_DfdPrimariesBT709 = 1;
+	const uint32_t g_DfdTransferLinear = 1;
+	const uint32_t g_DfdChannelAlpha = 15;
+
+	// get the Vulkan format number of a texture format
+	uint32_t GetVkFormat(TEXTURE_FORMAT format)
+	{
+		switch (format)
+		{
+		case TEXTURE_FORMAT_BC1:
+			return(g_VkFormatBC1);
+		case TEXTURE_FORMAT_BC3:
+			return(g_VkFormatBC3);
+		default:
+			return(g_VkFormatRGBA8);
+		}
+	}
+
+	// add one sample of the basic data format descriptor block
+	void AddDfdSample(std::vector<uint32_t>& dfd, uint32_t bitOffset, uint32_t bitLength,
+		uint32_t channel, uint32_t upper)
+	{
+		dfd.push_back(bitOffset | ((bitLength - 1) << 16) | (channel << 24));
+		dfd.push_back(0);
+		dfd.push_back(0);
+		dfd.push_back(upper);
+	}
+
+	// build the data format descriptor KTX2 requires after the level
+	// index - a total size followed by one basic descriptor block
+	// describing the texel blocks of a format
+	void BuildDataFormatDescriptor(TEXTURE_FORMAT format, std::vector<uint32_t>& dfd)
+	{
+		uint32_t colorModel = g_DfdColorModelRGBSDA;
+		uint32_t blockDimensions = 0;
+		uint32_t bytesPerBlock = 4;
+		if (format == TEXTURE_FORMAT_BC1)
+		{
+			colorModel = g_DfdColorModelBC1A;
+			blockDimensions = 3 | (3 << 8);
+			bytesPerBlock = 8;
+		}
+		else if (format == TEXTURE_FORMAT_BC3)
+		{
+			colorModel = g_DfdColorModelBC3;
+			blockDimensions = 3 | (3 << 8);
+			bytesPerBlock = 16;
+		}
+
+		dfd.clear();
+		dfd.push_back(0);
+		dfd.push_back(0);
+		dfd.push_back(0);
+		dfd.push_back(colorModel | (g_DfdPrimariesBT709 << 8) | (g_DfdTransferLinear << 16));
+		dfd.push_back(blockDimensions);
+		dfd.push_back(bytesPerBlock);
+		dfd.push_back(0);
+
+		switch (format)
+		{
+		case TEXTURE_FORMAT_BC1:
+			AddDfdSample(dfd, 0, 64, 0, 0xFFFFFFFF);
+			break;
+		case TEXTURE_FORMAT_BC3:
+			AddDfdSample(dfd, 0, 64, g_DfdChannelAlpha, 0xFFFFFFFF);
+			AddDfdSample(dfd, 64, 64, 0, 0xFFFFFFFF);
+			break;
+		default:
+			AddDfdSample(dfd, 0, 8, 0, 255);
+			AddDfdSample(dfd, 8, 8, 1, 255);
+			AddDfdSample(dfd, 16, 8, 2, 255);
+			AddDfdSample(dfd, 24, 8, g_DfdChannelAlpha, 255);
+			break;
+		}
+
+		// the block size counts the block header and the samples,
+		// the total size counts every word
+		uint32_t blockSize = (uint32_t)(dfd.size() - 1) * sizeof(uint32_t);
+		dfd[0] = (uint32_t)dfd.size() * sizeof(uint32_t);
+		dfd[2] = 2 | (blockSize << 16);
+	}
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for getting the path of the cache
+ *  file holding a source image in a format.
+ ***********************************************************/
+std::string TextureCache::GetCachePath(uint64_t sourceHash, TEXTURE_FORMAT format)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "/%016llx_%u.ktx2",
+		(unsigned long long)sourceHash, (unsigned int)GetVkFormat(format));
+
+	return(std::string(g_CacheDirectory) + name);
+}
+
+/***********************************************************
+ *  GetLevelCount()
+ *
+ *  This method is used for getting the number of levels in
+ *  a full mip chain, down to a single pixel.
+ ***********************************************************/
+int TextureCache::GetLevelCount(int width, int height)
+{
+	int levels = 1;
+	int size = std::max(width, height);
+
+	while (size > 1)
+	{
+		size = size / 2;
+		levels++;
+	}
+
+	return(levels);
+}
+
+/***********************************************************
+ *  GetLevelSize()
+ *
+ *  This method is used for getting the size in bytes of one
+ *  level.  Compressed formats always store whole 4x4 blocks.
+ ***********************************************************/
+size_t TextureCache::GetLevelSize(TEXTURE_FORMAT format, int width, int height)
+{
+	size_t blocks = (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4);
+
+	switch (format)
+	{
+	case TEXTURE_FORMAT_BC1:
+		return(blocks * 8);
+	case TEXTURE_FORMAT_BC3:
+		return(blocks * 16);
+	default:
+		return((size_t)width * height * 4);
+	}
+}
+
+/***********************************************************
+ *  GetLevels()
+ *
+ *  This method is used for laying out a full mip chain with
+ *  the levels stored back to back, largest level first.
+ ***********************************************************/
+size_t TextureCache::GetLevels(TEXTURE_FORMAT format, int width, int height, std::vector<TEXTURE_LEVEL>& levels)
+{
+	int levelCount = GetLevelCount(width, height);
+	size_t offset = 0;
+
+	levels.resize(levelCount);
+	for (int i = 0; i < levelCount; i++)
+	{
+		levels[i].width = std::max(width >> i, 1);
+		levels[i].height = std::max(height >> i, 1);
+		levels[i].offset = offset;
+		levels[i].size = GetLevelSize(format, levels[i].width, levels[i].height);
+		offset += levels[i].size;
+	}
+
+	return(offset);
+}
+
+/***********************************************************
+ *  Read()
+ *
+ *  This method is used for mapping a cache file and finding
+ *  its levels.  The levels point into the mapped file, so
+ *  the data is uploaded without being copied or decoded.
+ ***********************************************************/
+bool TextureCache::Read(const std::string& path, TEXTURE_FORMAT format, int width, int height,
+	MappedFile& file, std::vector<TEXTURE_LEVEL>& levels)
+{
+	if (file.Open(path.c_str()) == false)
+	{
+		return(false);
+	}
+
+	// the header must describe exactly the texture being loaded
+	const KTX2_HEADER* header = (const KTX2_HEADER*)file.GetData();
+	int levelCount = GetLevelCount(width, height);
+	if ((file.GetSize() < sizeof(KTX2_HEADER) + levelCount * sizeof(KTX2_LEVEL)) ||
+		(memcmp(header->identifier, g_KTX2Identifier, sizeof(g_KTX2Identifier)) != 0) ||
+		(header->vkFormat != GetVkFormat(format)) ||
+		(header->pixelWidth != (uint32_t)width) ||
+		(header->pixelHeight != (uint32_t)height) ||
+		(header->levelCount != (uint32_t)levelCount) ||
+		(header->supercompressionScheme != 0))
+	{
+		file.Close();
+		return(false);
+	}
+
+	// every level must have the expected size and lie inside the file
+	const KTX2_LEVEL* levelIndex = (const KTX2_LEVEL*)(file.GetData() + sizeof(KTX2_HEADER));
+	GetLevels(format, width, height, levels);
+	for (int i = 0; i < levelCount; i++)
+	{
+		if ((levelIndex[i].byteLength != levels[i].size) ||
+			(levels[i].size > file.GetSize()) ||
+			(levelIndex[i].byteOffset > file.GetSize() - levels[i].size))
+		{
+			file.Close();
+			return(false);
+		}
+		levels[i].offset = (size_t)levelIndex[i].byteOffset;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method is used for writing a full mip chain to a
+ *  KTX2 cache file.  The level index is followed by the data
+ *  format descriptor, then the level data from the smallest
+ *  level to the largest, each level starting on a multiple
+ *  of the texel block size.  The file is written under a
+ *  temporary name and renamed when complete, so a partly
+ *  written file is never read.
+ ***********************************************************/
+bool TextureCache::Write(const std::string& path, TEXTURE_FORMAT format, int width, int height,
+	const unsigned char* data, const std::vector<TEXTURE_LEVEL>& levels)
+{
+#ifdef _WIN32
+	_mkdir(g_CacheDirectory);
+#else
+	mkdir(g_CacheDirectory, 0755);
+#endif
+
+	KTX2_HEADER header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.identifier, g_KTX2Identifier, sizeof(g_KTX2Identifier));
+	header.vkFormat = GetVkFormat(format);
+	header.typeSize = 1;
+	header.pixelWidth = width;
+	header.pixelHeight = height;
+	header.faceCount = 1;
+	header.levelCount = (uint32_t)levels.size();
+
+	std::vector<uint32_t> dfd;
+	BuildDataFormatDescriptor(format, dfd);
+	header.dfdByteOffset = (uint32_t)(sizeof(KTX2_HEADER) + levels.size() * sizeof(KTX2_LEVEL));
+	header.dfdByteLength = (uint32_t)(dfd.size() * sizeof(uint32_t));
+
+	// lay out the level data after the header, level index and
+	// descriptor, the level sizes keep every level aligned once
+	// the first one is
+	uint64_t alignment = GetLevelSize(format, 1, 1);
+	uint64_t dataStart = header.dfdByteOffset + header.dfdByteLength;
+	uint64_t offset = (dataStart + alignment - 1) / alignment * alignment;
+	std::vector<unsigned char> padding((size_t)(offset - dataStart), 0);
+	std::vector<KTX2_LEVEL> levelIndex(levels.size());
+	for (int i = (int)levels.size() - 1; i >= 0; i--)
+	{
+		levelIndex[i].byteOffset = offset;
+		levelIndex[i].byteLength = levels[i].size;
+		levelIndex[i].uncompressedByteLength = levels[i].size;
+		offset += levels[i].size;
+	}
+
+	std::string tempPath = path + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+	if (file == NULL)
+	{
+		return(false);
+	}
+
+	bool bWritten = (fwrite(&header, sizeof(header), 1, file) == 1) &&
+		(fwrite(levelIndex.data(), sizeof(KTX2_LEVEL), levelIndex.size(), file) == levelIndex.size()) &&
+		(fwrite(dfd.data(), sizeof(uint32_t), dfd.size(), file) == dfd.size()) &&
+		(fwrite(padding.data(), 1, padding.size(), file) == padding.size());
+	for (int i = (int)levels.size() - 1; (i >= 0) && bWritten; i--)
+	{
+		bWritten = (fwrite(data + levels[i].offset, 1, levels[i].size, file) == levels[i].size);
+	}
+	bWritten = (fclose(file) == 0) && bWritten;
+
+	// replace any older file with the new one
+	remove(path.c_str());
+	if ((bWritten == false) || (rename(tempPath.c_str(), path.c_str()) != 0))
+	{
+		remove(tempPath.c_str());
+		return(false);
+	}
+
+	return(true);
+}
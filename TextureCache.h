@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.h
+// ============
+// on-disk cache of compressed texture mip chains in a KTX2-style container
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// pixel formats a texture can be stored in
+enum TEXTURE_FORMAT
+{
+	TEXTURE_FORMAT_RGBA8,			// uncompressed, 4 bytes per pixel
+	TEXTURE_FORMAT_BC1,				// S3TC DXT1, 8 bytes per 4x4 block
+	TEXTURE_FORMAT_BC3				// S3TC DXT5, 16 bytes per 4x4 block
+};
+
+// one mip level inside a block of texture data
+struct TEXTURE_LEVEL
+{
+	int width;
+	int height;
+	size_t offset;
+	size_t size;
+};
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  This class reads and writes cache files holding the full
+ *  compressed mip chain of one texture.  A cache file is
+ *  named after a hash of the source image file contents, so
+ *  editing an image simply misses the cache.  The files are
+ *  KTX2 files with a data format descriptor, so they can be
+ *  inspected with the usual KTX tools.
+ ***********************************************************/
+class TextureCache
+{
+public:
+	// get the path of the cache file for a source hash and format
+	static std::string GetCachePath(uint64_t sourceHash, TEXTURE_FORMAT format);
+
+	// get the number of levels in a full mip chain
+	static int GetLevelCount(int width, int height);
+	// get the size in bytes of one level in a format
+	static size_t GetLevelSize(TEXTURE_FORMAT format, int width, int height);
+	// fill in the levels of a full mip chain stored back to back,
+	// returns the total size in bytes
+	static size_t GetLevels(TEXTURE_FORMAT format, int width, int height, std::vector<TEXTURE_LEVEL>& levels);
+
+	// map a cache file and find its levels, returns false if the file
+	// is missing or does not hold the expected format and size
+	static bool Read(const std::string& path, TEXTURE_FORMAT format, int width, int height,
+		MappedFile& file, std::vector<TEXTURE_LEVEL>& levels);
+	// write a full mip chain to a cache file
+	static bool Write(const std::string& path, TEXTURE_FORMAT format, int width, int height,
+		const unsigned char* data, const std::vector<TEXTURE_LEVEL>& levels);
+};
@@ -0,0 +1,380 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture image files on a pool of worker threads
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+#include "DataHash.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// the most worker threads started when no count is given
+	const int g_MaxDefaultWorkers = 4;
+
+	// read a whole file into memory
+	bool ReadWholeFile(const std::string& filename, std::vector<unsigned char>& contents)
+	{
+		FILE* file = fopen(filename.c_str(), "rb");
+		if (file == NULL)
+		{
+			return(false);
+		}
+
+		fseek(file, 0, SEEK_END);
+		long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		contents.resize(size > 0 ? size : 0);
+		bool bRead = (size > 0) && (fread(contents.data(), 1, contents.size(), file) == contents.size());
+		fclose(file);
+
+		return(bRead);
+	}
+
+	// fill every level after the first by averaging 2x2 pixels of
+	// the level above it
+	void BuildMipChain(unsigned char* pixels, const std::vector<TEXTURE_LEVEL>& levels)
+	{
+		for (int i = 1; i < levels.size(); i++)
+		{
+			const TEXTURE_LEVEL& source = levels[i - 1];
+			const TEXTURE_LEVEL& target = levels[i];
+			const unsigned char* sourcePixels = pixels + source.offset;
+			unsigned char* targetPixels = pixels + target.offset;
+
+			for (int y = 0; y < target.height; y++)
+			{
+				int y0 = std::min(y * 2, source.height - 1);
+				int y1 = std::min(y * 2 + 1, source.height - 1);
+				for (int x = 0; x < target.width; x++)
+				{
+					int x0 = std::min(x * 2, source.width - 1);
+					int x1 = std::min(x * 2 + 1, source.width - 1);
+					for (int c = 0; c < 4; c++)
+					{
+						int sum = sourcePixels[(y0 * source.width + x0) * 4 + c] +
+							sourcePixels[(y0 * source.width + x1) * 4 + c] +
+							sourcePixels[(y1 * source.width + x0) * 4 + c] +
+							sourcePixels[(y1 * source.width + x1) * 4 + c];
+						targetPixels[(y * target.width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+					}
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_pendingCount = 0;
+	m_bStopping = false;
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the worker threads.  By
+ *  default one core is left free for the rendering thread.
+ ***********************************************************/
+void TextureLoader::Start(int workerCount)
+{
+	if (m_workers.size() > 0)
+	{
+		return;
+	}
+
+	if (workerCount <= 0)
+	{
+		int cores = (int)std::thread::hardware_concurrency();
+		workerCount = std::min(std::max(cores - 1, 1), g_MaxDefaultWorkers);
+	}
+
+	// the flip setting is global in stb_image, so it is set once
+	// here before any worker can be decoding
+	stbi_set_flip_vertically_on_load(true);
+
+	m_bStopping = false;
+	for (int i = 0; i < workerCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::WorkerMain, this));
+	}
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the worker threads and
+ *  freeing every image that was not collected.  Queued
+ *  image loads are dropped, but queued cache writes are
+ *  finished first so the next run can use them.
+ ***********************************************************/
+void TextureLoader::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+		for (int i = (int)m_requests.size() - 1; i >= 0; i--)
+		{
+			if (m_requests[i].bWriteCache == false)
+			{
+				m_requests.erase(m_requests.begin() + i);
+			}
+		}
+	}
+	m_wakeWorkers.notify_all();
+
+	for (int i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+
+	for (int i = 0; i < m_decoded.size(); i++)
+	{
+		FreeImage(m_decoded[i]);
+	}
+	m_decoded.clear();
+	m_pendingCount = 0;
+}
+
+/***********************************************************
+ *  Request()
+ *
+ *  This method is used for queuing an image file to be
+ *  loaded by the next free worker thread.
+ ***********************************************************/
+void TextureLoader::Request(const char* filename, int textureIndex, TEXTURE_FORMAT format, int width, int height)
+{
+	LOAD_REQUEST request;
+	request.bWriteCache = false;
+	request.textureIndex = textureIndex;
+	request.filename = filename;
+	request.format = format;
+	request.width = width;
+	request.height = height;
+	request.sourceHash = 0;
+	request.data = NULL;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back(request);
+		m_pendingCount++;
+	}
+	m_wakeWorkers.notify_one();
+}
+
+/***********************************************************
+ *  WriteCache()
+ *
+ *  This method is used for queuing a compressed mip chain to
+ *  be written to its cache file by a worker thread, so the
+ *  rendering thread never waits on the disk.
+ ***********************************************************/
+void TextureLoader::WriteCache(uint64_t sourceHash, TEXTURE_FORMAT format, int width, int height,
+	unsigned char* data, const std::vector<TEXTURE_LEVEL>& levels)
+{
+	LOAD_REQUEST request;
+	request.bWriteCache = true;
+	request.textureIndex = -1;
+	request.format = format;
+	request.width = width;
+	request.height = height;
+	request.sourceHash = sourceHash;
+	request.data = data;
+	request.levels = levels;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_requests.push_back(request);
+	}
+	m_wakeWorkers.notify_one();
+}
+
+/***********************************************************
+ *  Collect()
+ *
+ *  This method is used for taking decoded images off the
+ *  decoded queue.  The caller owns the pixels afterwards
+ *  and frees them with FreeImage().
+ ***********************************************************/
+int TextureLoader::Collect(std::vector<DECODED_IMAGE>& images, int maxImages)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	int collected = 0;
+	while ((m_decoded.size() > 0) && (collected < maxImages))
+	{
+		images.push_back(m_decoded.front());
+		m_decoded.pop_front();
+		m_pendingCount--;
+		collected++;
+	}
+
+	return(collected);
+}
+
+/***********************************************************
+ *  FreeImage()
+ *
+ *  This method is used for freeing the pixels of a decoded
+ *  image, or unmapping its cache file.
+ ***********************************************************/
+void TextureLoader::FreeImage(DECODED_IMAGE& image)
+{
+	free(image.pixels);
+	delete image.pCacheFile;
+	image.pixels = NULL;
+	image.pCacheFile = NULL;
+	image.data = NULL;
+}
+
+/***********************************************************
+ *  GetPendingCount()
+ *
+ *  This method is used for getting the number of requested
+ *  images that have not been collected yet.
+ ***********************************************************/
+int TextureLoader::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return(m_pendingCount);
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is run by every worker thread.  It waits for
+ *  a request, handles it outside of the lock and queues any
+ *  loaded image for the rendering thread.
+ ***********************************************************/
+void TextureLoader::WorkerMain()
+{
+	while (true)
+	{
+		LOAD_REQUEST request;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wakeWorkers.wait(lock, [this]() { return(m_bStopping || (m_requests.size() > 0)); });
+			if (m_requests.size() == 0)
+			{
+				return;
+			}
+			request = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		if (request.bWriteCache == true)
+		{
+			TextureCache::Write(TextureCache::GetCachePath(request.sourceHash, request.format),
+				request.format, request.width, request.height, request.data, request.levels);
+			free(request.data);
+			continue;
+		}
+
+		DECODED_IMAGE image;
+		DecodeImage(request, image);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_bStopping)
+		{
+			FreeImage(image);
+			continue;
+		}
+		m_decoded.push_back(image);
+	}
+}
+
+/***********************************************************
+ *  DecodeImage()
+ *
+ *  This method is used for loading one requested image.  The
+ *  source file is hashed to find its cache file, which is
+ *  mapped as it is when it holds the requested format.
+ *  Otherwise the image is decoded to RGBA and its full mip
+ *  chain is built here, off the rendering thread.
+ ***********************************************************/
+void TextureLoader::DecodeImage(const LOAD_REQUEST& request, DECODED_IMAGE& image)
+{
+	image.textureIndex = request.textureIndex;
+	image.filename = request.filename;
+	image.width = 0;
+	image.height = 0;
+	image.sourceHash = 0;
+	image.format = TEXTURE_FORMAT_RGBA8;
+	image.data = NULL;
+	image.pixels = NULL;
+	image.pCacheFile = NULL;
+
+	std::vector<unsigned char> source;
+	if (ReadWholeFile(request.filename, source) == false)
+	{
+		return;
+	}
+
+	if (request.format != TEXTURE_FORMAT_RGBA8)
+	{
+		image.sourceHash = HashData(source.data(), source.size());
+
+		MappedFile* pCacheFile = new MappedFile();
+		if (TextureCache::Read(TextureCache::GetCachePath(image.sourceHash, request.format),
+			request.format, request.width, request.height, *pCacheFile, image.levels) == true)
+		{
+			image.width = request.width;
+			image.height = request.height;
+			image.format = request.format;
+			image.pCacheFile = pCacheFile;
+			image.data = pCacheFile->GetData();
+			return;
+		}
+		delete pCacheFile;
+	}
+
+	// every image is expanded to RGBA so it fits any array layer
+	int colorChannels = 0;
+	unsigned char* pixels = stbi_load_from_memory(
+		source.data(),
+		(int)source.size(),
+		&image.width,
+		&image.height,
+		&colorChannels,
+		4);
+	if (pixels == NULL)
+	{
+		return;
+	}
+
+	size_t size = TextureCache::GetLevels(TEXTURE_FORMAT_RGBA8, image.width, image.height, image.levels);
+	image.pixels = (unsigned char*)malloc(size);
+	memcpy(image.pixels, pixels, image.levels[0].size);
+	stbi_image_free(pixels);
+
+	BuildMipChain(image.pixels, image.levels);
+	image.data = image.pixels;
+}
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture image files on a pool of worker threads
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureCache.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class decodes image files into RGBA mip chains on
+ *  worker threads, or maps the cached compressed mip chain
+ *  of an image when there is one.  It never calls OpenGL;
+ *  the images are collected on the rendering thread, which
+ *  uploads them and hands new cache files back to be written.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// an image decoded by a worker thread
+	struct DECODED_IMAGE
+	{
+		int textureIndex;
+		std::string filename;
+		int width;
+		int height;
+		// hash of the source file contents, 0 when not hashed
+		uint64_t sourceHash;
+		// format and mip levels of the data - RGBA8 unless the
+		// compressed mip chain was found in the cache
+		TEXTURE_FORMAT format;
+		std::vector<TEXTURE_LEVEL> levels;
+		// all of the levels, NULL if the image could not be loaded
+		const unsigned char* data;
+		// owners of the data, only one of them is set
+		unsigned char* pixels;
+		MappedFile* pCacheFile;
+	};
+
+	// constructor
+	TextureLoader();
+	// destructor
+	~TextureLoader();
+
+	// start the worker threads, 0 picks a count from the CPU
+	void Start(int workerCount = 0);
+	// stop the worker threads, dropping any queued requests
+	void Stop();
+
+	// queue an image file to be loaded for a texture index - when a
+	// compressed format is passed the cache is searched for the
+	// image in that format first
+	void Request(const char* filename, int textureIndex, TEXTURE_FORMAT format, int width, int height);
+	// queue a compressed mip chain to be written to the cache,
+	// the loader takes ownership of the malloc allocated data
+	void WriteCache(uint64_t sourceHash, TEXTURE_FORMAT format, int width, int height,
+		unsigned char* data, const std::vector<TEXTURE_LEVEL>& levels);
+	// move up to maxImages decoded images into the passed list,
+	// returns the number of images collected
+	int Collect(std::vector<DECODED_IMAGE>& images, int maxImages);
+	// free the pixels of a decoded image
+	static void FreeImage(DECODED_IMAGE& image);
+
+	// get the number of requests not yet collected
+	int GetPendingCount();
+
+private:
+	struct LOAD_REQUEST
+	{
+		// true for a cache write, false for an image load
+		bool bWriteCache;
+		int textureIndex;
+		std::string filename;
+		TEXTURE_FORMAT format;
+		int width;
+		int height;
+		// cache writes only
+		uint64_t sourceHash;
+		unsigned char* data;
+		std::vector<TEXTURE_LEVEL> levels;
+	};
+
+	// worker threads decoding the requested images
+	std::vector<std::thread> m_workers;
+	// guards the request and decoded queues
+	std::mutex m_mutex;
+	// wakes the workers when a request is queued
+	std::condition_variable m_wakeWorkers;
+	// images waiting to be decoded and cache files waiting to be written
+	std::deque<LOAD_REQUEST> m_requests;
+	// images decoded and waiting to be collected
+	std::deque<DECODED_IMAGE> m_decoded;
+	// number of requests not yet collected
+	int m_pendingCount;
+	// set to make the workers exit
+	bool m_bStopping;
+
+	// body of each worker thread
+	void WorkerMain();
+	// load one requested image from the cache or the image file
+	void DecodeImage(const LOAD_REQUEST& request, DECODED_IMAGE& image);
+};
@@ -0,0 +1,672 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturemanager.cpp
+// ============
+// load texture images and pack them into OpenGL texture arrays
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureManager.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// number of pixel buffer objects the uploads rotate through
+	const int g_StagingBufferCount = 2;
+
+	// get the OpenGL internal format of a texture format
+	GLenum GetInternalFormat(TEXTURE_FORMAT format)
+	{
+		switch (format)
+		{
+		case TEXTURE_FORMAT_BC1:
+			return(GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+		case TEXTURE_FORMAT_BC3:
+			return(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+		default:
+			return(GL_RGBA8);
+		}
+	}
+}
+
+/***********************************************************
+ *  TextureManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureManager::TextureManager()
+{
+	m_maxLayers = 0;
+	m_maxUnits = 0;
+	m_bCompressionSupported = false;
+	m_nextStagingBuffer = 0;
+	m_pendingCount = 0;
+}
+
+/***********************************************************
+ *  ~TextureManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureManager::~TextureManager()
+{
+	DestroyTextures();
+}
+
+/***********************************************************
+ *  QueryLimits()
+ *
+ *  This method is used for reading the maximum number of
+ *  layers in a texture array and the number of texture
+ *  units available to the fragment shader, and checking for
+ *  S3TC texture compression.  No more units are used than
+ *  the shader has samplers for its texture arrays.
+ ***********************************************************/
+void TextureManager::QueryLimits()
+{
+	if (m_maxLayers == 0)
+	{
+		glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &m_maxLayers);
+		glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &m_maxUnits);
+		m_maxUnits = std::min(m_maxUnits, MAX_BOUND_TEXTURE_ARRAYS);
+		m_boundArrays.assign(m_maxUnits, -1);
+		m_bCompressionSupported = (GLEW_EXT_texture_compression_s3tc == GL_TRUE);
+	}
+}
+
+/***********************************************************
+ *  LoadTexture()
+ *
+ *  This method is used for reading the size of a texture
+ *  image and queuing the image to be decoded by the texture
+ *  loader.  Only the image header is read here, so loading
+ *  a texture does not wait for the image to be decoded.
+ *  Images with an alpha channel are stored as BC3 and all
+ *  others as BC1 when compression is available.
+ ***********************************************************/
+int TextureManager::LoadTexture(const char* filename, const char* tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// read the image size from the header of the image file
+	if (stbi_info(filename, &width, &height, &colorChannels) == 0)
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+		return(-1);
+	}
+
+	QueryLimits();
+
+	TEXTURE_ENTRY texture;
+	texture.tag = tag;
+	texture.width = width;
+	texture.height = height;
+	texture.colorChannels = colorChannels;
+	texture.format = TEXTURE_FORMAT_RGBA8;
+	if (m_bCompressionSupported == true)
+	{
+		texture.format = ((colorChannels == 2) || (colorChannels == 4)) ? TEXTURE_FORMAT_BC3 : TEXTURE_FORMAT_BC1;
+	}
+	texture.arrayIndex = -1;
+	texture.layer = -1;
+	texture.bResident = false;
+	m_textures.push_back(texture);
+
+	int textureIndex = (int)m_textures.size() - 1;
+	m_unpacked.push_back(textureIndex);
+
+	// register the loaded texture and associate it with the special tag string
+	m_tags.Register(tag, textureIndex);
+
+	// decode the image pixels on a worker thread
+	m_loader.Start();
+	m_loader.Request(filename, textureIndex, texture.format, width, height);
+	m_pendingCount++;
+
+	return(textureIndex);
+}
+
+/***********************************************************
+ *  BuildTextureArrays()
+ *
+ *  This method is used for allocating texture arrays for the
+ *  queued textures.  Textures are grouped by format and size,
+ *  and a group larger than the layer limit is split over
+ *  several arrays.  The layers are filled by FinalizeUploads().
+ ***********************************************************/
+void TextureManager::BuildTextureArrays()
+{
+	QueryLimits();
+
+	// order the queued textures so textures of the same format and size are together
+	std::stable_sort(m_unpacked.begin(), m_unpacked.end(),
+		[this](int a, int b)
+		{
+			const TEXTURE_ENTRY& textureA = m_textures[a];
+			const TEXTURE_ENTRY& textureB = m_textures[b];
+			if (textureA.format != textureB.format)
+			{
+				return(textureA.format < textureB.format);
+			}
+			if (textureA.width != textureB.width)
+			{
+				return(textureA.width < textureB.width);
+			}
+			return(textureA.height < textureB.height);
+		});
+
+	std::vector<int> group;
+	for (int i = 0; i < m_unpacked.size(); i++)
+	{
+		const TEXTURE_ENTRY& texture = m_textures[m_unpacked[i]];
+
+		// start a new array when the format or size changes or the array is full
+		if ((group.size() > 0) &&
+			((m_textures[group[0]].format != texture.format) ||
+			 (m_textures[group[0]].width != texture.width) ||
+			 (m_textures[group[0]].height != texture.height) ||
+			 (group.size() >= m_maxLayers)))
+		{
+			CreateTextureArray(group);
+			group.clear();
+		}
+		group.push_back(m_unpacked[i]);
+	}
+	if (group.size() > 0)
+	{
+		CreateTextureArray(group);
+	}
+
+	m_unpacked.clear();
+}
+
+/***********************************************************
+ *  CreateTextureArray()
+ *
+ *  This method is used for creating one texture array for a
+ *  group of textures with the same format and size, and
+ *  configuring the texture mapping parameters.  Only the
+ *  storage of the full mip chain is allocated.
+ ***********************************************************/
+void TextureManager::CreateTextureArray(const std::vector<int>& textures)
+{
+	TEXTURE_ARRAY textureArray;
+	textureArray.width = m_textures[textures[0]].width;
+	textureArray.height = m_textures[textures[0]].height;
+	textureArray.layers = (int)textures.size();
+	textureArray.format = m_textures[textures[0]].format;
+	textureArray.levels = TextureCache::GetLevelCount(textureArray.width, textureArray.height);
+
+	glGenTextures(1, &textureArray.textureID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, textureArray.levels - 1);
+
+	// allocate every level of every layer - the pixels and the
+	// precomputed mipmaps arrive from the loader later
+	GLenum internalFormat = GetInternalFormat(textureArray.format);
+	for (int level = 0; level < textureArray.levels; level++)
+	{
+		int width = std::max(textureArray.width >> level, 1);
+		int height = std::max(textureArray.height >> level, 1);
+
+		if (textureArray.format == TEXTURE_FORMAT_RGBA8)
+		{
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat,
+				width, height, textureArray.layers,
+				0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		}
+		else
+		{
+			GLsizei levelSize = (GLsizei)TextureCache::GetLevelSize(textureArray.format, width, height);
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat,
+				width, height, textureArray.layers,
+				0, levelSize * textureArray.layers, NULL);
+		}
+	}
+	for (int layer = 0; layer < textures.size(); layer++)
+	{
+		m_textures[textures[layer]].arrayIndex = (int)m_arrays.size();
+		m_textures[textures[layer]].layer = layer;
+	}
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	m_arrays.push_back(textureArray);
+}
+
+/***********************************************************
+ *  FinalizeUploads()
+ *
+ *  This method is used for uploading the images decoded by
+ *  the loader into their texture array layers.  At least one
+ *  image is uploaded per call, and no more are started once
+ *  the time budget has been spent, so a large scene streams
+ *  in over several frames instead of stalling one.
+ ***********************************************************/
+int TextureManager::FinalizeUploads(double budgetMilliseconds)
+{
+	if (m_pendingCount == 0)
+	{
+		return(0);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	int finalized = 0;
+	int next = 0;
+
+	while (true)
+	{
+		// take another decoded image when none are waiting
+		if ((next >= m_decoded.size()) && (m_loader.Collect(m_decoded, 1) == 0))
+		{
+			break;
+		}
+
+		// images decoded before their array was allocated wait for it
+		TextureLoader::DECODED_IMAGE& image = m_decoded[next];
+		if (m_textures[image.textureIndex].arrayIndex < 0)
+		{
+			next++;
+			continue;
+		}
+
+		UploadImage(image);
+		TextureLoader::FreeImage(image);
+		m_decoded.erase(m_decoded.begin() + next);
+		m_pendingCount--;
+		finalized++;
+
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		if (elapsed.count() >= budgetMilliseconds)
+		{
+			break;
+		}
+	}
+
+	return(finalized);
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for uploading a loaded image into its
+ *  texture array layer.  An image that was decoded instead of
+ *  found in the cache is compressed first, and the result is
+ *  handed back to the loader to be written to the cache.
+ ***********************************************************/
+void TextureManager::UploadImage(const TextureLoader::DECODED_IMAGE& image)
+{
+	TEXTURE_ENTRY& texture = m_textures[image.textureIndex];
+
+	if (image.data == NULL)
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return;
+	}
+	if ((image.width != texture.width) || (image.height != texture.height))
+	{
+		std::cout << "Image size changed while loading:" << image.filename << std::endl;
+		return;
+	}
+
+	if (image.format == texture.format)
+	{
+		UploadLevels(texture, image.data, image.levels);
+	}
+	else
+	{
+		std::vector<TEXTURE_LEVEL> levels;
+		unsigned char* blocks = CompressImage(image, texture.format, levels);
+		if (blocks == NULL)
+		{
+			std::cout << "Could not compress image:" << image.filename << std::endl;
+			return;
+		}
+		UploadLevels(texture, blocks, levels);
+		m_loader.WriteCache(image.sourceHash, texture.format, texture.width, texture.height, blocks, levels);
+	}
+
+	if (image.pCacheFile != NULL)
+	{
+		std::cout << "Successfully loaded cached image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << texture.colorChannels << std::endl;
+	}
+	else
+	{
+		std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << texture.colorChannels << std::endl;
+	}
+
+	texture.bResident = true;
+}
+
+/***********************************************************
+ *  CompressImage()
+ *
+ *  This method is used for compressing the RGBA mip chain of
+ *  an image by uploading each level into a scratch texture
+ *  with a compressed internal format and reading the blocks
+ *  the driver produced back.  Reading them back waits for
+ *  the driver, but it only happens the first time an image
+ *  is loaded, since the blocks are cached afterwards.
+ ***********************************************************/
+unsigned char* TextureManager::CompressImage(const TextureLoader::DECODED_IMAGE& image,
+	TEXTURE_FORMAT format, std::vector<TEXTURE_LEVEL>& levels)
+{
+	size_t size = TextureCache::GetLevels(format, image.width, image.height, levels);
+	unsigned char* blocks = (unsigned char*)malloc(size);
+	GLenum internalFormat = GetInternalFormat(format);
+
+	GLuint scratchTexture = 0;
+	glGenTextures(1, &scratchTexture);
+	glBindTexture(GL_TEXTURE_2D, scratchTexture);
+
+	bool bCompressed = (blocks != NULL);
+	for (int level = 0; (level < levels.size()) && bCompressed; level++)
+	{
+		const TEXTURE_LEVEL& source = image.levels[level];
+		glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, source.width, source.height,
+			0, GL_RGBA, GL_UNSIGNED_BYTE, image.data + source.offset);
+
+		// the driver must have produced exactly the expected blocks
+		GLint compressed = GL_FALSE;
+		GLint compressedSize = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &compressed);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+		bCompressed = (compressed == GL_TRUE) && (compressedSize == (GLint)levels[level].size);
+		if (bCompressed == true)
+		{
+			glGetCompressedTexImage(GL_TEXTURE_2D, 0, blocks + levels[level].offset);
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDeleteTextures(1, &scratchTexture);
+
+	if (bCompressed == false)
+	{
+		free(blocks);
+		return(NULL);
+	}
+
+	return(blocks);
+}
+
+/***********************************************************
+ *  UploadLevels()
+ *
+ *  This method is used for copying a mip chain into the next
+ *  staging pixel buffer object and uploading every level
+ *  from there into the texture array layer.  The buffer is
+ *  orphaned first, so the copy never waits for the previous
+ *  upload from the same buffer to finish.
+ ***********************************************************/
+void TextureManager::UploadLevels(const TEXTURE_ENTRY& texture, const unsigned char* data,
+	const std::vector<TEXTURE_LEVEL>& levels)
+{
+	TEXTURE_ARRAY& textureArray = m_arrays[texture.arrayIndex];
+	GLenum internalFormat = GetInternalFormat(textureArray.format);
+
+	if (m_stagingBuffers.size() == 0)
+	{
+		m_stagingBuffers.resize(g_StagingBufferCount);
+		glGenBuffers(g_StagingBufferCount, m_stagingBuffers.data());
+	}
+
+	// pack the levels back to back in the staging buffer
+	std::vector<size_t> offsets(levels.size());
+	size_t size = 0;
+	for (int level = 0; level < levels.size(); level++)
+	{
+		offsets[level] = size;
+		size += levels[level].size;
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffers[m_nextStagingBuffer]);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+	unsigned char* staging = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	m_nextStagingBuffer = (m_nextStagingBuffer + 1) % g_StagingBufferCount;
+
+	// upload straight from the passed in data if the buffer cannot be mapped
+	const unsigned char* source = NULL;
+	if (staging != NULL)
+	{
+		for (int level = 0; level < levels.size(); level++)
+		{
+			memcpy(staging + offsets[level], data + levels[level].offset, levels[level].size);
+		}
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+	else
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		source = data;
+		for (int level = 0; level < levels.size(); level++)
+		{
+			offsets[level] = levels[level].offset;
+		}
+	}
+
+	// the uploads read from the bound pixel buffer at the level offsets
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.textureID);
+	for (int level = 0; (level < levels.size()) && (level < textureArray.levels); level++)
+	{
+		if (textureArray.format == TEXTURE_FORMAT_RGBA8)
+		{
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, texture.layer,
+				levels[level].width, levels[level].height, 1,
+				GL_RGBA, GL_UNSIGNED_BYTE, source + offsets[level]);
+		}
+		else
+		{
+			glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, texture.layer,
+				levels[level].width, levels[level].height, 1,
+				internalFormat, (GLsizei)levels[level].size, source + offsets[level]);
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	// the array is now bound to the active texture unit
+	int activeUnit = 0;
+	glGetIntegerv(GL_ACTIVE_TEXTURE, &activeUnit);
+	activeUnit -= GL_TEXTURE0;
+	if ((activeUnit >= 0) && (activeUnit < m_boundArrays.size()))
+	{
+		m_boundArrays[activeUnit] = texture.arrayIndex;
+	}
+}
+
+/***********************************************************
+ *  BindTextureArrays()
+ *
+ *  This method is used for binding the texture arrays to
+ *  texture units.  Each array keeps its unit, so no texture
+ *  is bound again while drawing unless there are more
+ *  arrays than texture units.
+ ***********************************************************/
+void TextureManager::BindTextureArrays()
+{
+	QueryLimits();
+
+	for (int i = 0; (i < m_arrays.size()) && (i < m_maxUnits); i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i].textureID);
+		m_boundArrays[i] = i;
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  SelectTextureArray()
+ *
+ *  This method is used for getting the texture unit that
+ *  holds a texture array.  The array is only bound when its
+ *  unit currently holds a different array.
+ ***********************************************************/
+int TextureManager::SelectTextureArray(int arrayIndex)
+{
+	if ((arrayIndex < 0) || (arrayIndex >= m_arrays.size()))
+	{
+		return(0);
+	}
+
+	QueryLimits();
+
+	int unit = arrayIndex % m_maxUnits;
+	if (m_boundArrays[unit] != arrayIndex)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[arrayIndex].textureID);
+		glActiveTexture(GL_TEXTURE0);
+		m_boundArrays[unit] = arrayIndex;
+	}
+
+	return(unit);
+}
+
+/***********************************************************
+ *  DestroyTextures()
+ *
+ *  This method is used for freeing the memory of all the
+ *  texture arrays and any images still waiting to be uploaded.
+ ***********************************************************/
+void TextureManager::DestroyTextures()
+{
+	// stop decoding before anything the workers write to is freed
+	m_loader.Stop();
+
+	for (int i = 0; i < m_arrays.size(); i++)
+	{
+		glDeleteTextures(1, &m_arrays[i].textureID);
+	}
+	for (int i = 0; i < m_decoded.size(); i++)
+	{
+		TextureLoader::FreeImage(m_decoded[i]);
+	}
+	if (m_stagingBuffers.size() > 0)
+	{
+		glDeleteBuffers((GLsizei)m_stagingBuffers.size(), m_stagingBuffers.data());
+	}
+
+	m_arrays.clear();
+	m_decoded.clear();
+	m_unpacked.clear();
+	m_stagingBuffers.clear();
+	m_textures.clear();
+	m_tags.Clear();
+	m_boundArrays.assign(m_boundArrays.size(), -1);
+	m_pendingCount = 0;
+}
+
+/***********************************************************
+ *  FindTexture()
+ *
+ *  This method is used for getting the index of a loaded
+ *  texture associated with the passed in tag.
+ ***********************************************************/
+int TextureManager::FindTexture(TAG_ID tag) const
+{
+	return(m_tags.Find(tag));
+}
+
+/***********************************************************
+ *  GetTextureArray()
+ *
+ *  This method is used for getting the texture array that
+ *  holds a texture, -1 if it has not been packed yet.
+ ***********************************************************/
+int TextureManager::GetTextureArray(int textureIndex) const
+{
+	if ((textureIndex < 0) || (textureIndex >= m_textures.size()))
+	{
+		return(-1);
+	}
+
+	return(m_textures[textureIndex].arrayIndex);
+}
+
+/***********************************************************
+ *  GetTextureLayer()
+ *
+ *  This method is used for getting the layer of its texture
+ *  array that holds a texture, -1 if it has not been packed.
+ ***********************************************************/
+int TextureManager::GetTextureLayer(int textureIndex) const
+{
+	if ((textureIndex < 0) || (textureIndex >= m_textures.size()))
+	{
+		return(-1);
+	}
+
+	return(m_textures[textureIndex].layer);
+}
+
+/***********************************************************
+ *  IsTextureResident()
+ *
+ *  This method is used for checking whether the pixels of a
+ *  texture have been uploaded into its texture array layer.
+ ***********************************************************/
+bool TextureManager::IsTextureResident(int textureIndex) const
+{
+	if ((textureIndex < 0) || (textureIndex >= m_textures.size()))
+	{
+		return(false);
+	}
+
+	return(m_textures[textureIndex].bResident);
+}
+
+/***********************************************************
+ *  GetTextureCount()
+ *
+ *  This method is used for getting the number of loaded
+ *  textures.
+ ***********************************************************/
+int TextureManager::GetTextureCount() const
+{
+	return((int)m_textures.size());
+}
+
+/***********************************************************
+ *  GetArrayCount()
+ *
+ *  This method is used for getting the number of texture
+ *  arrays.
+ ***********************************************************/
+int TextureManager::GetArrayCount() const
+{
+	return((int)m_arrays.size());
+}
+
+/***********************************************************
+ *  GetPendingCount()
+ *
+ *  This method is used for getting the number of textures
+ *  still waiting for their pixels to be uploaded.
+ ***********************************************************/
+int TextureManager::GetPendingCount() const
+{
+	return(m_pendingCount);
+}
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturemanager.h
+// ============
+// load texture images and pack them into OpenGL texture arrays
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TagRegistry.h"
+#include "TextureLoader.h"
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+
+// most texture units the texture arrays are kept bound to, so the
+// arrays drawn every frame are not bound again each time
+const int MAX_BOUND_TEXTURE_ARRAYS = 8;
+
+/***********************************************************
+ *  TextureManager
+ *
+ *  This class loads texture images and packs every image of
+ *  the same size into the layers of one GL_TEXTURE_2D_ARRAY.
+ *  A texture is selected by its index, which maps to an
+ *  array and a layer in that array, so thousands of textures
+ *  only need as many texture units as there are image sizes.
+ *
+ *  Images are decoded on the worker threads of a texture
+ *  loader.  Only the image header is read when a texture is
+ *  loaded, so the arrays can be allocated right away, and
+ *  the pixels are uploaded later through pixel buffer objects
+ *  under a per-frame time budget.  Until then the texture is
+ *  not resident and should be drawn with a placeholder.
+ *
+ *  When S3TC compression is available the arrays store BC1
+ *  or BC3 blocks with a full mip chain.  The first load of an
+ *  image compresses it through the driver and writes the
+ *  result to the texture cache; later runs upload the cached
+ *  blocks directly.
+ ***********************************************************/
+class TextureManager
+{
+public:
+	// constructor
+	TextureManager();
+	// destructor
+	~TextureManager();
+
+	// read the size of a texture image and queue it for decoding,
+	// returns the texture index or -1 on failure
+	int LoadTexture(const char* filename, const char* tag);
+	// allocate texture arrays for all of the queued images
+	void BuildTextureArrays();
+	// upload decoded images until the time budget is spent,
+	// returns the number of textures that became resident
+	int FinalizeUploads(double budgetMilliseconds);
+	// bind the texture arrays to their texture units
+	void BindTextureArrays();
+	// free all of the texture arrays
+	void DestroyTextures();
+
+	// find a loaded texture by tag, -1 if unknown
+	int FindTexture(TAG_ID tag) const;
+	// get the texture array and layer holding a texture
+	int GetTextureArray(int textureIndex) const;
+	int GetTextureLayer(int textureIndex) const;
+	// check whether the pixels of a texture have been uploaded
+	bool IsTextureResident(int textureIndex) const;
+	// make sure a texture array is bound, returns its texture unit
+	int SelectTextureArray(int arrayIndex);
+
+	// get the number of loaded textures and texture arrays
+	int GetTextureCount() const;
+	int GetArrayCount() const;
+	// get the number of textures still waiting for their pixels
+	int GetPendingCount() const;
+
+private:
+	struct TEXTURE_ENTRY
+	{
+		std::string tag;
+		int width;
+		int height;
+		int colorChannels;
+		TEXTURE_FORMAT format;
+		int arrayIndex;
+		int layer;
+		bool bResident;
+	};
+
+	struct TEXTURE_ARRAY
+	{
+		GLuint textureID;
+		int width;
+		int height;
+		int layers;
+		TEXTURE_FORMAT format;
+		int levels;
+	};
+
+	// all loaded textures by texture index
+	std::vector<TEXTURE_ENTRY> m_textures;
+	// all created texture arrays
+	std::vector<TEXTURE_ARRAY> m_arrays;
+	// textures not yet packed into an array
+	std::vector<int> m_unpacked;
+	// worker threads decoding the texture images
+	TextureLoader m_loader;
+	// decoded images waiting to be uploaded
+	std::vector<TextureLoader::DECODED_IMAGE> m_decoded;
+	// pixel buffer objects the uploads are staged through
+	std::vector<GLuint> m_stagingBuffers;
+	int m_nextStagingBuffer;
+	// number of textures still waiting for their pixels
+	int m_pendingCount;
+	// texture tags interned to texture indices
+	TagRegistry m_tags;
+	// texture array currently bound to each texture unit
+	std::vector<int> m_boundArrays;
+	// limits queried from OpenGL
+	int m_maxLayers;
+	int m_maxUnits;
+	bool m_bCompressionSupported;
+
+	// query the texture limits the first time they are needed
+	void QueryLimits();
+	// create one texture array for a group of same-size textures
+	void CreateTextureArray(const std::vector<int>& textures);
+	// upload one decoded image into its texture array layer
+	void UploadImage(const TextureLoader::DECODED_IMAGE& image);
+	// compress the RGBA mip chain of an image through the driver,
+	// returns the malloc allocated blocks or NULL on failure
+	unsigned char* CompressImage(const TextureLoader::DECODED_IMAGE& image,
+		TEXTURE_FORMAT format, std::vector<TEXTURE_LEVEL>& levels);
+	// copy a mip chain into a staging buffer and upload it into a layer
+	void UploadLevels(const TEXTURE_ENTRY& texture, const unsigned char* data,
+		const std::vector<TEXTURE_LEVEL>& levels);
+};
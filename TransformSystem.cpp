@@ -0,0 +1,467 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformsystem.cpp
+// ============
+// batched composition of the scene object model matrices
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformSystem.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <cmath>
+
+// SSE2 is part of every x64 target, 32-bit builds need it enabled
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define TRANSFORM_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	const float g_DegreesToRadians = 3.14159265358979f / 180.0f;
+	// blocks composed by one job when the update is spread out
+	const int g_BlocksPerJob = 64;
+
+#ifdef TRANSFORM_USE_SSE2
+	// compute the sines and cosines of four angles in radians - the
+	// angles are reduced to a quarter turn around zero and then fed
+	// through the single precision minimax polynomials from Cephes
+	void SinCos4(__m128 angles, __m128& sines, __m128& cosines)
+	{
+		// nearest multiple of a quarter turn
+		__m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angles, _mm_set1_ps(0.63661977236758134f)));
+		__m128 turns = _mm_cvtepi32_ps(quadrant);
+
+		// subtract the quarter turns in three parts to keep precision
+		__m128 x = _mm_sub_ps(angles, _mm_mul_ps(turns, _mm_set1_ps(1.5703125f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(4.837512969970703125e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(7.54978995489188216e-8f)));
+		__m128 x2 = _mm_mul_ps(x, x);
+
+		__m128 sine = _mm_mul_ps(x2, _mm_set1_ps(-1.9515295891e-4f));
+		sine = _mm_mul_ps(x2, _mm_add_ps(sine, _mm_set1_ps(8.3321608736e-3f)));
+		sine = _mm_mul_ps(x2, _mm_add_ps(sine, _mm_set1_ps(-1.6666654611e-1f)));
+		sine = _mm_add_ps(x, _mm_mul_ps(x, sine));
+
+		__m128 cosine = _mm_mul_ps(x2, _mm_set1_ps(2.443315711809948e-5f));
+		cosine = _mm_mul_ps(x2, _mm_add_ps(cosine, _mm_set1_ps(-1.388731625493765e-3f)));
+		cosine = _mm_mul_ps(x2, _mm_add_ps(cosine, _mm_set1_ps(4.166664568298827e-2f)));
+		cosine = _mm_mul_ps(x2, _mm_sub_ps(cosine, _mm_set1_ps(0.5f)));
+		cosine = _mm_add_ps(cosine, _mm_set1_ps(1.0f));
+
+		// odd quadrants swap the sine and cosine
+		__m128i one = _mm_set1_epi32(1);
+		__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+		sines = _mm_or_ps(_mm_and_ps(swap, cosine), _mm_andnot_ps(swap, sine));
+		cosines = _mm_or_ps(_mm_and_ps(swap, sine), _mm_andnot_ps(swap, cosine));
+
+		// the second bit of the quadrant flips the sign of the sine,
+		// and of the cosine one quadrant later
+		__m128i two = _mm_set1_epi32(2);
+		__m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+		__m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+		sines = _mm_xor_ps(sines, sineSign);
+		cosines = _mm_xor_ps(cosines, cosineSign);
+	}
+
+	// transpose four vectors of one value per object into one
+	// matrix column per object and store them
+	void StoreColumns(float* matrices, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(matrices + column * 4, x);
+		_mm_storeu_ps(matrices + 16 + column * 4, y);
+		_mm_storeu_ps(matrices + 32 + column * 4, z);
+		_mm_storeu_ps(matrices + 48 + column * 4, w);
+	}
+#endif
+}
+
+/***********************************************************
+ *  TransformSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformSystem::TransformSystem()
+{
+	m_count = 0;
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method is used for adding the transformation values
+ *  of an object.  The arrays grow a whole block at a time,
+ *  and the padding objects hold an identity transform.
+ ***********************************************************/
+int TransformSystem::Add(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	if (m_count == m_scaleX.size())
+	{
+		int size = m_count + BLOCK_SIZE;
+		m_scaleX.resize(size, 1.0f);
+		m_scaleY.resize(size, 1.0f);
+		m_scaleZ.resize(size, 1.0f);
+		m_rotationX.resize(size, 0.0f);
+		m_rotationY.resize(size, 0.0f);
+		m_rotationZ.resize(size, 0.0f);
+		m_positionX.resize(size, 0.0f);
+		m_positionY.resize(size, 0.0f);
+		m_positionZ.resize(size, 0.0f);
+		m_matrices.resize(size, glm::mat4(1.0f));
+		m_dirty.resize(size, 0);
+		m_dirtyBlocks.resize(size / BLOCK_SIZE, 0);
+	}
+
+	int index = m_count;
+	m_count++;
+	Set(index, scaleXYZ, XrotationDegrees, YrotationDegrees, ZrotationDegrees, positionXYZ);
+
+	return(index);
+}
+
+/***********************************************************
+ *  Reserve()
+ *
+ *  This method is used for making room for a number of
+ *  objects, so adding a large scene does not grow the
+ *  arrays over and over.
+ ***********************************************************/
+void TransformSystem::Reserve(int count)
+{
+	int size = (count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+
+	m_scaleX.reserve(size);
+	m_scaleY.reserve(size);
+	m_scaleZ.reserve(size);
+	m_rotationX.reserve(size);
+	m_rotationY.reserve(size);
+	m_rotationZ.reserve(size);
+	m_positionX.reserve(size);
+	m_positionY.reserve(size);
+	m_positionZ.reserve(size);
+	m_matrices.reserve(size);
+	m_dirty.reserve(size);
+	m_dirtyBlocks.reserve(size / BLOCK_SIZE);
+}
+
+/***********************************************************
+ *  Set()
+ *
+ *  This method is used for changing the transformation values
+ *  of an object.  The object and its block are marked dirty
+ *  so the matrix is recomputed by the next update.
+ ***********************************************************/
+void TransformSystem::Set(
+	int index,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	if ((index < 0) || (index >= m_count))
+	{
+		return;
+	}
+
+	m_scaleX[index] = scaleXYZ.x;
+	m_scaleY[index] = scaleXYZ.y;
+	m_scaleZ[index] = scaleXYZ.z;
+	m_rotationX[index] = XrotationDegrees;
+	m_rotationY[index] = YrotationDegrees;
+	m_rotationZ[index] = ZrotationDegrees;
+	m_positionX[index] = positionXYZ.x;
+	m_positionY[index] = positionXYZ.y;
+	m_positionZ[index] = positionXYZ.z;
+	m_dirty[index] = 1;
+	m_dirtyBlocks[index / BLOCK_SIZE] = 1;
+}
+
+/***********************************************************
+ *  Truncate()
+ *
+ *  This method is used for removing the objects at the end,
+ *  from the passed in index on.  The slots left over in the
+ *  last block go back to the values of an unused slot, so
+ *  they are never listed as changed.
+ ***********************************************************/
+void TransformSystem::Truncate(int count)
+{
+	if ((count < 0) || (count >= m_count))
+	{
+		return;
+	}
+
+	int size = (count + BLOCK_SIZE - 1) / BLOCK_SIZE * BLOCK_SIZE;
+	m_scaleX.resize(size);
+	m_scaleY.resize(size);
+	m_scaleZ.resize(size);
+	m_rotationX.resize(size);
+	m_rotationY.resize(size);
+	m_rotationZ.resize(size);
+	m_positionX.resize(size);
+	m_positionY.resize(size);
+	m_positionZ.resize(size);
+	m_matrices.resize(size);
+	m_dirty.resize(size);
+	m_dirtyBlocks.resize(size / BLOCK_SIZE);
+
+	for (int i = count; i < size; i++)
+	{
+		m_scaleX[i] = 1.0f;
+		m_scaleY[i] = 1.0f;
+		m_scaleZ[i] = 1.0f;
+		m_rotationX[i] = 0.0f;
+		m_rotationY[i] = 0.0f;
+		m_rotationZ[i] = 0.0f;
+		m_positionX[i] = 0.0f;
+		m_positionY[i] = 0.0f;
+		m_positionZ[i] = 0.0f;
+		m_matrices[i] = glm::mat4(1.0f);
+		m_dirty[i] = 0;
+	}
+	m_count = count;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every object.
+ ***********************************************************/
+void TransformSystem::Clear()
+{
+	m_scaleX.clear();
+	m_scaleY.clear();
+	m_scaleZ.clear();
+	m_rotationX.clear();
+	m_rotationY.clear();
+	m_rotationZ.clear();
+	m_positionX.clear();
+	m_positionY.clear();
+	m_positionZ.clear();
+	m_matrices.clear();
+	m_dirty.clear();
+	m_dirtyBlocks.clear();
+	m_updated.clear();
+	m_count = 0;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for recomputing the model matrices of
+ *  every block holding a changed object.  Each block only
+ *  writes its own matrices, so the blocks can be composed on
+ *  any thread.  The changed objects are listed for the
+ *  caller, which uses them to update their bounding boxes.
+ ***********************************************************/
+int TransformSystem::Update(JobSystem* pJobSystem)
+{
+	m_updated.clear();
+	m_blocksToCompose.clear();
+
+	for (int block = 0; block < m_dirtyBlocks.size(); block++)
+	{
+		if (m_dirtyBlocks[block] != 0)
+		{
+			m_blocksToCompose.push_back(block);
+		}
+	}
+
+	if (m_blocksToCompose.size() == 0)
+	{
+		return(0);
+	}
+
+	if (NULL != pJobSystem)
+	{
+		pJobSystem->ParallelFor((int)m_blocksToCompose.size(), g_BlocksPerJob,
+			[this](int begin, int end)
+			{
+				for (int i = begin; i < end; i++)
+				{
+					ComposeBlock(m_blocksToCompose[i] * BLOCK_SIZE);
+				}
+			});
+	}
+	else
+	{
+		for (int i = 0; i < m_blocksToCompose.size(); i++)
+		{
+			ComposeBlock(m_blocksToCompose[i] * BLOCK_SIZE);
+		}
+	}
+
+	for (int j = 0; j < m_blocksToCompose.size(); j++)
+	{
+		int block = m_blocksToCompose[j];
+		int first = block * BLOCK_SIZE;
+
+		for (int i = first; (i < first + BLOCK_SIZE) && (i < m_count); i++)
+		{
+			if (m_dirty[i] != 0)
+			{
+				m_updated.push_back(i);
+				m_dirty[i] = 0;
+			}
+		}
+		m_dirtyBlocks[block] = 0;
+	}
+
+	return((int)m_updated.size());
+}
+
+/***********************************************************
+ *  ComposeBlock()
+ *
+ *  This method is used for composing the model matrices of
+ *  one block of objects.  The matrix is
+ *  translation * rotationZ * rotationY * rotationX * scale,
+ *  written out so the upper 3x3 is the rotation matrix with
+ *  each column multiplied by its scale and the last column is
+ *  the position.
+ ***********************************************************/
+void TransformSystem::ComposeBlock(int first)
+{
+#ifdef TRANSFORM_USE_SSE2
+	__m128 toRadians = _mm_set1_ps(g_DegreesToRadians);
+	__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+	SinCos4(_mm_mul_ps(_mm_loadu_ps(&m_rotationX[first]), toRadians), sinX, cosX);
+	SinCos4(_mm_mul_ps(_mm_loadu_ps(&m_rotationY[first]), toRadians), sinY, cosY);
+	SinCos4(_mm_mul_ps(_mm_loadu_ps(&m_rotationZ[first]), toRadians), sinZ, cosZ);
+
+	__m128 scaleX = _mm_loadu_ps(&m_scaleX[first]);
+	__m128 scaleY = _mm_loadu_ps(&m_scaleY[first]);
+	__m128 scaleZ = _mm_loadu_ps(&m_scaleZ[first]);
+
+	__m128 sinYsinX = _mm_mul_ps(sinY, sinX);
+	__m128 sinYcosX = _mm_mul_ps(sinY, cosX);
+	__m128 zero = _mm_setzero_ps();
+
+	float* matrices = &m_matrices[first][0][0];
+
+	// first column - rotated X axis
+	StoreColumns(matrices, 0,
+		_mm_mul_ps(_mm_mul_ps(cosZ, cosY), scaleX),
+		_mm_mul_ps(_mm_mul_ps(sinZ, cosY), scaleX),
+		_mm_mul_ps(_mm_sub_ps(zero, sinY), scaleX),
+		zero);
+	// second column - rotated Y axis
+	StoreColumns(matrices, 1,
+		_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(cosZ, sinYsinX), _mm_mul_ps(sinZ, cosX)), scaleY),
+		_mm_mul_ps(_mm_add_ps(_mm_mul_ps(sinZ, sinYsinX), _mm_mul_ps(cosZ, cosX)), scaleY),
+		_mm_mul_ps(_mm_mul_ps(cosY, sinX), scaleY),
+		zero);
+	// third column - rotated Z axis
+	StoreColumns(matrices, 2,
+		_mm_mul_ps(_mm_add_ps(_mm_mul_ps(cosZ, sinYcosX), _mm_mul_ps(sinZ, sinX)), scaleZ),
+		_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sinZ, sinYcosX), _mm_mul_ps(cosZ, sinX)), scaleZ),
+		_mm_mul_ps(_mm_mul_ps(cosY, cosX), scaleZ),
+		zero);
+	// fourth column - position
+	StoreColumns(matrices, 3,
+		_mm_loadu_ps(&m_positionX[first]),
+		_mm_loadu_ps(&m_positionY[first]),
+		_mm_loadu_ps(&m_positionZ[first]),
+		_mm_set1_ps(1.0f));
+#else
+	for (int i = first; i < first + BLOCK_SIZE; i++)
+	{
+		float sinX = std::sin(m_rotationX[i] * g_DegreesToRadians);
+		float cosX = std::cos(m_rotationX[i] * g_DegreesToRadians);
+		float sinY = std::sin(m_rotationY[i] * g_DegreesToRadians);
+		float cosY = std::cos(m_rotationY[i] * g_DegreesToRadians);
+		float sinZ = std::sin(m_rotationZ[i] * g_DegreesToRadians);
+		float cosZ = std::cos(m_rotationZ[i] * g_DegreesToRadians);
+
+		glm::mat4& matrix = m_matrices[i];
+		matrix[0] = glm::vec4(cosZ * cosY, sinZ * cosY, -sinY, 0.0f) * m_scaleX[i];
+		matrix[1] = glm::vec4(
+			cosZ * sinY * sinX - sinZ * cosX,
+			sinZ * sinY * sinX + cosZ * cosX,
+			cosY * sinX,
+			0.0f) * m_scaleY[i];
+		matrix[2] = glm::vec4(
+			cosZ * sinY * cosX + sinZ * sinX,
+			sinZ * sinY * cosX - cosZ * sinX,
+			cosY * cosX,
+			0.0f) * m_scaleZ[i];
+		matrix[3] = glm::vec4(m_positionX[i], m_positionY[i], m_positionZ[i], 1.0f);
+	}
+#endif
+}
+
+/***********************************************************
+ *  GetUpdated()
+ *
+ *  This method is used for getting the objects whose model
+ *  matrices were recomputed by the last update.
+ ***********************************************************/
+const std::vector<int>& TransformSystem::GetUpdated() const
+{
+	return(m_updated);
+}
+
+/***********************************************************
+ *  GetMatrix()
+ *
+ *  This method is used for getting the model matrix of an
+ *  object as of the last update.
+ ***********************************************************/
+const glm::mat4& TransformSystem::GetMatrix(int index) const
+{
+	return(m_matrices[index]);
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of objects.
+ ***********************************************************/
+int TransformSystem::GetCount() const
+{
+	return(m_count);
+}
+
+/***********************************************************
+ *  ComposeReference()
+ *
+ *  This method is used for composing one model matrix by
+ *  multiplying the five transformation matrices together.
+ *  It is kept to check and benchmark the batched kernel.
+ ***********************************************************/
+glm::mat4 TransformSystem::ComposeReference(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// variables for this method
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+
+	// set the scale value in the transform buffer
+	scale = glm::scale(scaleXYZ);
+	// set the rotation values in the transform buffer
+	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+	// set the translation value in the transform buffer
+	translation = glm::translate(positionXYZ);
+
+	return(translation * rotationZ * rotationY * rotationX * scale);
+}
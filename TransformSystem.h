@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformsystem.h
+// ============
+// batched composition of the scene object model matrices
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "JobSystem.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  TransformSystem
+ *
+ *  This class keeps the scale, rotation and position of
+ *  every scene object in structure-of-arrays layout and
+ *  composes their model matrices four objects at a time
+ *  with SSE.  Each matrix is written directly from the sines
+ *  and cosines of the three angles, which gives the same
+ *  result as multiplying the translation, rotation and scale
+ *  matrices together.  Only blocks of four holding a changed
+ *  object are recomputed.
+ ***********************************************************/
+class TransformSystem
+{
+public:
+	// constructor
+	TransformSystem();
+
+	// add the transformation values of an object, returns its index
+	int Add(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+	// make room for a number of objects before adding them
+	void Reserve(int count);
+	// change the transformation values of an object
+	void Set(
+		int index,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+	// remove the objects from an index on, keeping the ones
+	// before it
+	void Truncate(int count);
+	// remove every object
+	void Clear();
+
+	// recompute the model matrices of the changed objects, spread
+	// over the job system when one is passed in, returns the number
+	// of objects that were recomputed
+	int Update(JobSystem* pJobSystem = NULL);
+	// get the objects recomputed by the last update
+	const std::vector<int>& GetUpdated() const;
+	// get the model matrix of an object
+	const glm::mat4& GetMatrix(int index) const;
+	// get the number of objects
+	int GetCount() const;
+
+	// compose one model matrix through glm matrix multiplies, the
+	// way the objects were transformed before this class
+	static glm::mat4 ComposeReference(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+private:
+	// objects composed together by one kernel call
+	static const int BLOCK_SIZE = 4;
+
+	// transformation values, padded to a whole number of blocks
+	std::vector<float> m_scaleX;
+	std::vector<float> m_scaleY;
+	std::vector<float> m_scaleZ;
+	std::vector<float> m_rotationX;
+	std::vector<float> m_rotationY;
+	std::vector<float> m_rotationZ;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	// composed model matrices, padded the same way
+	std::vector<glm::mat4> m_matrices;
+	// one flag per object, set when its values have changed
+	std::vector<unsigned char> m_dirty;
+	// one flag per block, set when any object in it has changed
+	std::vector<unsigned char> m_dirtyBlocks;
+	// blocks being recomputed by the current update
+	std::vector<int> m_blocksToCompose;
+	// objects recomputed by the last update
+	std::vector<int> m_updated;
+	// number of objects, not counting the padding
+	int m_count;
+
+	// compose the model matrices of one block of objects
+	void ComposeBlock(int first);
+};
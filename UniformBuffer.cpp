@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformbuffer.cpp
+// ============
+// std140 uniform buffer objects shared by the scene shaders
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformBuffer.h"
+
+#include <cstring>
+
+/***********************************************************
+ *  UniformBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformBuffer::UniformBuffer()
+{
+	m_bufferID = 0;
+	m_bindingPoint = 0;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/***********************************************************
+ *  ~UniformBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+UniformBuffer::~UniformBuffer()
+{
+	if (m_bufferID != 0)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the uniform buffer with
+ *  the passed in size and attaching it to its binding point.
+ ***********************************************************/
+void UniformBuffer::Create(GLuint bindingPoint, GLsizeiptr size)
+{
+	m_bindingPoint = bindingPoint;
+	m_shadowData.clear();
+
+	glGenBuffers(1, &m_bufferID);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, m_bindingPoint, m_bufferID);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for uploading new data into the
+ *  buffer.  Nothing is uploaded when the data is the same as
+ *  the last upload.
+ ***********************************************************/
+bool UniformBuffer::Update(const void* data, GLsizeiptr size)
+{
+	if (m_bufferID == 0)
+	{
+		return(false);
+	}
+
+	if ((m_shadowData.size() == (size_t)size) &&
+		(memcmp(m_shadowData.data(), data, size) == 0))
+	{
+		m_stats.uploadsSkipped++;
+		return(false);
+	}
+
+	m_shadowData.assign((const unsigned char*)data, (const unsigned char*)data + size);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	m_stats.uploadsIssued++;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsCreated()
+ *
+ *  This method is used for checking whether the buffer has
+ *  been created.
+ ***********************************************************/
+bool UniformBuffer::IsCreated() const
+{
+	return(m_bufferID != 0);
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method is used for getting the counters of the
+ *  uploads made to the buffer, and of the ones skipped
+ *  because the data had not changed.
+ ***********************************************************/
+const UNIFORM_UPLOAD_STATS& UniformBuffer::GetStats() const
+{
+	return(m_stats);
+}
@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformbuffer.h
+// ============
+// std140 uniform buffer objects shared by the scene shaders
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// binding points of the uniform blocks used by the scene shaders -
+// these must match the shaders
+const GLuint FRAME_BLOCK_BINDING = 0;
+const GLuint MATERIAL_BLOCK_BINDING = 1;
+const GLuint LIGHT_BLOCK_BINDING = 2;
+
+// size of the material array in the material block - this must
+// match the define in the scene shaders
+const int MAX_BLOCK_MATERIALS = 64;
+
+// std140 layout of the per-frame block
+struct FRAME_BLOCK
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec4 viewPosition;			// xyz = camera position
+};
+
+// std140 layout of one material in the material block
+struct MATERIAL_BLOCK_ENTRY
+{
+	glm::vec4 ambient;				// rgb = ambient color, a = ambient strength
+	glm::vec4 diffuse;				// rgb = diffuse color, a = shininess
+	glm::vec4 specular;				// rgb = specular color
+};
+
+// std140 layout of the material block
+struct MATERIAL_BLOCK
+{
+	MATERIAL_BLOCK_ENTRY materials[MAX_BLOCK_MATERIALS];
+};
+
+// std140 layout of the light block, the lights themselves are
+// in the light buffer of the light clusters
+struct LIGHT_BLOCK
+{
+	glm::ivec4 settings;			// x = use lighting, y = number of lights
+	glm::vec4 clusterMapping;		// x = depth slice scale, y = depth slice bias
+	glm::mat4 clusterView;			// view the lights were assigned to the clusters with
+	glm::mat4 clusterProjection;	// projection the lights were assigned to the clusters with
+};
+
+// counters of the uploads made to scene uniforms, and of the ones
+// skipped because the data had not changed
+struct UNIFORM_UPLOAD_STATS
+{
+	int uploadsIssued;
+	int uploadsSkipped;
+};
+
+/***********************************************************
+ *  UniformBuffer
+ *
+ *  This class wraps one uniform buffer object bound to a
+ *  fixed binding point.  It keeps a copy of the last data
+ *  uploaded, so updating it with unchanged data is skipped.
+ ***********************************************************/
+class UniformBuffer
+{
+public:
+	// constructor
+	UniformBuffer();
+	// destructor
+	~UniformBuffer();
+
+	// create the buffer and attach it to its binding point
+	void Create(GLuint bindingPoint, GLsizeiptr size);
+	// upload the data if it differs from the last upload,
+	// returns true when an upload was made
+	bool Update(const void* data, GLsizeiptr size);
+
+	// check whether the buffer has been created
+	bool IsCreated() const;
+	// get the counters of the uploads made and skipped
+	const UNIFORM_UPLOAD_STATS& GetStats() const;
+
+private:
+	// OpenGL buffer object
+	GLuint m_bufferID;
+	// binding point the buffer is attached to
+	GLuint m_bindingPoint;
+	// copy of the last uploaded data
+	std::vector<unsigned char> m_shadowData;
+	// upload counters
+	UNIFORM_UPLOAD_STATS m_stats;
+};
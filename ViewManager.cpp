@@ -1,261 +1,643 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.cpp
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-	g_pCamera->MovementSpeed = 20;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = xMousePos - gLastX;
-	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-//adjusting mouse wheel to allow camera zoom to be faster or slower.
-void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-	g_pCamera->ProcessMouseScroll(static_cast<float>(yoffset));
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// process camera zooming in and out
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-	}
-
-	// process camera panning left and right
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-	}
-
-	// process camera moving upward
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-	}
-
-	// process camera moving downward
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-	}
-	//switch to perspective projection
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		bOrthographicProjection = false;
-	}
-
-	// switch to orthographic projection
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		bOrthographicProjection = true;
-	}
-
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-
-// The line I removed is below just in case
-// projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-// Now it does switch between perspective and orthgrpahic if you press P or O.
-	if (bOrthographicProjection)
-	{	//2D style camera
-		projection = glm::ortho(-5.0f, 5.0f, -10.0f, 5.0f, 0.5f, 100.0f);
-	}
-	else
-	{		//3D style camera
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom),
-			(GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-	}
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.cpp
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for window width and height
+	const int WINDOW_WIDTH = 1000;
+	const int WINDOW_HEIGHT = 800;
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// queue the window callbacks hand their events to the frame
+	// through, timestamped as they are received
+	InputQueue* g_pInputQueue = nullptr;
+
+	// these variables are used for mouse movement processing
+	float gLastX = WINDOW_WIDTH / 2.0f;
+	float gLastY = WINDOW_HEIGHT / 2.0f;
+	bool gFirstMouse = true;
+
+	// keys that move the camera while they are held, and the
+	// direction each of them moves it
+	const int g_MovementKeys[] = { GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_A, GLFW_KEY_D, GLFW_KEY_E, GLFW_KEY_Q };
+	const Camera_Movement g_MovementDirections[] = { FORWARD, BACKWARD, LEFT, RIGHT, UP, DOWN };
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	bool bOrthographicProjection = false;
+
+	// add an event received by a window callback to the queue
+	void QueueInputEvent(int type, int key, int action, double x, double y)
+	{
+		if (NULL == g_pInputQueue)
+		{
+			return;
+		}
+
+		INPUT_EVENT event;
+		event.type = type;
+		event.key = key;
+		event.action = action;
+		event.x = x;
+		event.y = y;
+		event.time = std::chrono::steady_clock::now();
+		g_pInputQueue->Push(event);
+	}
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pWindow = NULL;
+	m_offscreenFramebuffer = 0;
+	m_offscreenColor = 0;
+	m_offscreenDepth = 0;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_viewportSize = glm::vec2((float)WINDOW_WIDTH, (float)WINDOW_HEIGHT);
+	m_bLateLatch = false;
+	for (int i = 0; i < MOVEMENT_KEY_COUNT; i++)
+	{
+		m_bKeysHeld[i] = false;
+	}
+	m_bInputShown = false;
+	m_inputStats.eventsApplied = 0;
+	m_inputStats.lateEvents = 0;
+	m_inputStats.eventsDropped = 0;
+	g_pInputQueue = new InputQueue();
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+	g_pCamera->MovementSpeed = 20;
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	m_pWindow = NULL;
+	if (m_offscreenFramebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &m_offscreenFramebuffer);
+		glDeleteRenderbuffers(1, &m_offscreenColor);
+		glDeleteRenderbuffers(1, &m_offscreenDepth);
+		m_offscreenFramebuffer = 0;
+	}
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+	if (NULL != g_pInputQueue)
+	{
+		delete g_pInputQueue;
+		g_pInputQueue = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// the default viewport covers the framebuffer, which can be
+	// larger than the window on high resolution displays, and is
+	// never changed afterwards
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+	m_viewportSize = glm::vec2((float)framebufferWidth, (float)framebufferHeight);
+
+	// tell GLFW to capture all mouse events
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// this callback is used to receive mouse moving events
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+
+	// this callback is used to receive mouse wheel scrolling events
+	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
+
+	// this callback is used to receive key presses and releases
+	glfwSetKeyCallback(window, &ViewManager::Key_Callback);
+
+	// the window delivers input while a frame is being prepared,
+	// so the camera is latched again before the scene is drawn
+	m_bLateLatch = true;
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  CreateOffscreenWindow()
+ *
+ *  This method is used to create a window that is never shown
+ *  and only provides the OpenGL context for headless runs.
+ *  On the GLFW null platform the context comes from EGL, or
+ *  from OSMesa when EGL is not available, so no display
+ *  server is needed.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateOffscreenWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// llvmpipe and most headless drivers stop at OpenGL 4.5
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+	// try EGL first and fall back on OSMesa
+	const int contextAPIs[] = { GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API };
+	for (int i = 0; (i < 2) && (window == NULL); i++)
+	{
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, contextAPIs[i]);
+		window = glfwCreateWindow(
+			WINDOW_WIDTH,
+			WINDOW_HEIGHT,
+			windowTitle,
+			NULL, NULL);
+	}
+	if (window == NULL)
+	{
+		std::cout << "Failed to create offscreen GLFW context" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  CreateOffscreenTarget()
+ *
+ *  This method is used to create the framebuffer that the
+ *  scene is rendered into when running headless.  It has
+ *  the same size as the display window, so headless frames
+ *  match what the window would show.
+ ***********************************************************/
+bool ViewManager::CreateOffscreenTarget()
+{
+	glGenRenderbuffers(1, &m_offscreenColor);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenColor);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WINDOW_WIDTH, WINDOW_HEIGHT);
+
+	glGenRenderbuffers(1, &m_offscreenDepth);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenDepth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, WINDOW_WIDTH, WINDOW_HEIGHT);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_offscreenFramebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_offscreenFramebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_offscreenColor);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_offscreenDepth);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Offscreen framebuffer is incomplete" << std::endl;
+		return(false);
+	}
+
+	// the framebuffer stays bound for the rest of the run
+	glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+	m_viewportSize = glm::vec2((float)WINDOW_WIDTH, (float)WINDOW_HEIGHT);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ *  The position is queued with the time it was received,
+ *  and moves the camera when the frame latches it.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	QueueInputEvent(INPUT_CURSOR, 0, 0, xMousePos, yMousePos);
+}
+//adjusting mouse wheel to allow camera zoom to be faster or slower.
+void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	QueueInputEvent(INPUT_SCROLL, 0, 0, xoffset, yoffset);
+}
+
+/***********************************************************
+ *  Key_Callback()
+ *
+ *  This method is automatically called from GLFW whenever a
+ *  key is pressed, repeated or released within the active
+ *  GLFW display window.  The key is queued with the time it
+ *  was received, so a key held for part of a frame only
+ *  moves the camera for that part.
+ ***********************************************************/
+void ViewManager::Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	QueueInputEvent(INPUT_KEY, key, action, 0.0, 0.0);
+}
+
+/***********************************************************
+ *  ApplyInputEvent()
+ *
+ *  This method is used for applying one queued input event
+ *  to the camera, in the order the events were received.
+ ***********************************************************/
+void ViewManager::ApplyInputEvent(const INPUT_EVENT& event)
+{
+	if (event.type == INPUT_CURSOR)
+	{
+		// when the first mouse move event is received, this needs to be recorded so that
+		// all subsequent mouse moves can correctly calculate the X position offset and Y
+		// position offset for proper operation
+		if (gFirstMouse)
+		{
+			gLastX = event.x;
+			gLastY = event.y;
+			gFirstMouse = false;
+		}
+
+		// calculate the X offset and Y offset values for moving the 3D camera accordingly
+		float xOffset = event.x - gLastX;
+		float yOffset = gLastY - event.y; // reversed since y-coordinates go from bottom to top
+
+		// set the current positions into the last position variables
+		gLastX = event.x;
+		gLastY = event.y;
+
+		// move the 3D camera according to the calculated offsets
+		g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+	}
+	else if (event.type == INPUT_SCROLL)
+	{
+		g_pCamera->ProcessMouseScroll(static_cast<float>(event.y));
+	}
+	else if (event.type == INPUT_KEY)
+	{
+		// the camera moves along a held key from the time it was
+		// pressed up to the time it was released
+		for (int i = 0; i < MOVEMENT_KEY_COUNT; i++)
+		{
+			if (event.key != g_MovementKeys[i])
+			{
+				continue;
+			}
+			if ((event.action == GLFW_PRESS) && (m_bKeysHeld[i] == false))
+			{
+				m_bKeysHeld[i] = true;
+				m_keysMovedUntil[i] = event.time;
+			}
+			else if ((event.action == GLFW_RELEASE) && (m_bKeysHeld[i] == true))
+			{
+				MoveHeldKey(i, event.time);
+				m_bKeysHeld[i] = false;
+			}
+		}
+
+		if (event.action == GLFW_PRESS)
+		{
+			// close the window if the escape key has been pressed
+			if (event.key == GLFW_KEY_ESCAPE)
+			{
+				glfwSetWindowShouldClose(m_pWindow, true);
+			}
+			//switch to perspective projection
+			if (event.key == GLFW_KEY_P)
+			{
+				bOrthographicProjection = false;
+			}
+			// switch to orthographic projection
+			if (event.key == GLFW_KEY_O)
+			{
+				bOrthographicProjection = true;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  MoveHeldKey()
+ *
+ *  This method is used for moving the camera along a held
+ *  key for the time since it was last moved along it.
+ ***********************************************************/
+void ViewManager::MoveHeldKey(int keyIndex, std::chrono::steady_clock::time_point until)
+{
+	if (until <= m_keysMovedUntil[keyIndex])
+	{
+		return;
+	}
+
+	std::chrono::duration<float> heldTime = until - m_keysMovedUntil[keyIndex];
+	g_pCamera->ProcessKeyboard(g_MovementDirections[keyIndex], heldTime.count());
+	m_keysMovedUntil[keyIndex] = until;
+}
+
+/***********************************************************
+ *  LatchInput()
+ *
+ *  This method is used for applying every input event that
+ *  is waiting in the queue to the camera, then moving the
+ *  camera along the held keys up to now.  The time of the
+ *  oldest input applied in the frame is kept for measuring
+ *  the input latency.
+ ***********************************************************/
+bool ViewManager::LatchInput(bool bLate)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	int eventCount = 0;
+
+	INPUT_EVENT event;
+	while (g_pInputQueue->Pop(event) == true)
+	{
+		if ((m_bInputShown == false) || (event.time < m_inputTime))
+		{
+			m_inputTime = event.time;
+			m_bInputShown = true;
+		}
+		ApplyInputEvent(event);
+		eventCount++;
+	}
+
+	// a held key moves the camera by the time up to now
+	bool bKeysHeld = false;
+	for (int i = 0; i < MOVEMENT_KEY_COUNT; i++)
+	{
+		if (m_bKeysHeld[i] == true)
+		{
+			MoveHeldKey(i, now);
+			bKeysHeld = true;
+		}
+	}
+	if ((bKeysHeld == true) && (m_bInputShown == false))
+	{
+		m_inputTime = now;
+		m_bInputShown = true;
+	}
+
+	m_inputStats.eventsApplied += eventCount;
+	if (bLate == true)
+	{
+		m_inputStats.lateEvents += eventCount;
+	}
+	m_inputStats.eventsDropped = g_pInputQueue->GetDroppedCount();
+
+	return((eventCount > 0) || (bKeysHeld == true));
+}
+
+/***********************************************************
+ *  WriteFrameBlock()
+ *
+ *  This method is used for computing the view and projection
+ *  matrices from the camera and writing them into the
+ *  frame's section of the frame block.
+ ***********************************************************/
+void ViewManager::WriteFrameBlock()
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+
+	// get the current view matrix from the camera
+	view = g_pCamera->GetViewMatrix();
+
+
+// The line I removed is below just in case
+// projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+// Now it does switch between perspective and orthgrpahic if you press P or O.
+	if (bOrthographicProjection)
+	{	//2D style camera
+		projection = glm::ortho(-5.0f, 5.0f, -10.0f, 5.0f, 0.5f, 100.0f);
+	}
+	else
+	{		//3D style camera
+		projection = glm::perspective(glm::radians(g_pCamera->Zoom),
+			(GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
+	}
+
+	// keep the matrices for culling the scene against
+	m_viewMatrix = view;
+	m_projectionMatrix = projection;
+
+	if (m_frameBlockRing.IsCreated() == false)
+	{
+		return;
+	}
+
+	FRAME_BLOCK* frame = (FRAME_BLOCK*)m_frameBlockRing.GetSectionData();
+	// set the view and projection matrices for proper rendering
+	frame->view = view;
+	frame->projection = projection;
+	// set the view position of the camera for proper rendering
+	frame->viewPosition = glm::vec4(g_pCamera->Position, 1.0f);
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering.  The input received since the last frame is
+ *  applied to the camera, and the matrices it gives are
+ *  used for culling and assigning the lights.
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	// the frame block is created on the first frame - the scene
+	// shaders name its binding point themselves, so every variant
+	// of the scene program reads it without being connected
+	if (m_frameBlockRing.IsCreated() == false)
+	{
+		m_frameBlockRing.Create(sizeof(FRAME_BLOCK));
+	}
+
+	// the section written this frame must no longer be in use
+	// by the GPU
+	m_frameBlockRing.BeginSection();
+	if (m_frameBlockRing.IsCreated() == true)
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, FRAME_BLOCK_BINDING, m_frameBlockRing.GetBuffer(),
+			m_frameBlockRing.GetSectionOffset(), sizeof(FRAME_BLOCK));
+	}
+
+	// apply the input events that arrived since the last frame
+	m_bInputShown = false;
+	LatchInput(false);
+
+	WriteFrameBlock();
+}
+
+/***********************************************************
+ *  LatchSceneView()
+ *
+ *  This method is used for moving the camera by the input
+ *  that arrived while the frame was being prepared, right
+ *  before the scene draws that read the frame block are
+ *  issued.  The section is persistently and coherently
+ *  mapped and no command issued so far reads it, so it can
+ *  simply be written again.  Culling and the light clusters
+ *  keep the view from PrepareSceneView(), which only differs
+ *  by the input of a few milliseconds, and the fragment
+ *  shader looks up the clusters with that view as well.
+ ***********************************************************/
+void ViewManager::LatchSceneView()
+{
+	if (m_bLateLatch == false)
+	{
+		return;
+	}
+
+	// collect the events waiting in the window system
+	glfwPollEvents();
+
+	if (LatchInput(true) == true)
+	{
+		WriteFrameBlock();
+	}
+}
+
+/***********************************************************
+ *  FinishSceneView()
+ *
+ *  This method is used for fencing the frame's section of
+ *  the frame block once the scene has been drawn.
+ ***********************************************************/
+void ViewManager::FinishSceneView()
+{
+	m_frameBlockRing.EndSection();
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  This method is used for placing the camera at a position
+ *  looking along a direction, such as for following the
+ *  benchmark camera path.
+ ***********************************************************/
+void ViewManager::SetCameraPose(const glm::vec3& position, const glm::vec3& front)
+{
+	g_pCamera->Position = position;
+	g_pCamera->Front = front;
+}
+
+/***********************************************************
+ *  GetViewMatrix()
+ *
+ *  This method is used for getting the view matrix computed
+ *  by the last latch of the camera.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetViewMatrix() const
+{
+	return(m_viewMatrix);
+}
+
+/***********************************************************
+ *  GetProjectionMatrix()
+ *
+ *  This method is used for getting the projection matrix
+ *  computed by the last latch of the camera.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetProjectionMatrix() const
+{
+	return(m_projectionMatrix);
+}
+
+/***********************************************************
+ *  GetViewportSize()
+ *
+ *  This method is used for getting the size in pixels of the
+ *  viewport the scene is drawn to, kept from when the window
+ *  or offscreen target was created.
+ ***********************************************************/
+const glm::vec2& ViewManager::GetViewportSize() const
+{
+	return(m_viewportSize);
+}
+
+/***********************************************************
+ *  GetInputTime()
+ *
+ *  This method is used for getting the time the oldest input
+ *  that moved the camera in the current frame was received,
+ *  for measuring how long input takes to reach the screen.
+ ***********************************************************/
+bool ViewManager::GetInputTime(std::chrono::steady_clock::time_point& inputTime) const
+{
+	if (m_bInputShown == false)
+	{
+		return(false);
+	}
+
+	inputTime = m_inputTime;
+	return(true);
+}
+
+/***********************************************************
+ *  GetInputStats()
+ *
+ *  This method is used for getting the counters of the input
+ *  events applied to the camera.
+ ***********************************************************/
+const INPUT_STATS& ViewManager::GetInputStats() const
+{
+	return(m_inputStats);
 }
\ No newline at end of file
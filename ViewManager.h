@@ -1,48 +1,120 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	// mouse scroll callback for zooming in/out or adjusting movement speed
-	static void Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "UniformBuffer.h"
+#include "RingBuffer.h"
+#include "InputQueue.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+#include <chrono>
+
+// counters of the input applied to the camera
+struct INPUT_STATS
+{
+	int eventsApplied;				// events applied to the camera
+	int lateEvents;					// events first applied by the late latch
+	int eventsDropped;				// events lost because the queue was full
+};
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+
+	// mouse scroll callback for zooming in/out or adjusting movement speed
+	static void Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
+
+	// keyboard callback for moving the camera and switching the projection
+	static void Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+private:
+	// keys that move the camera while they are held
+	static const int MOVEMENT_KEY_COUNT = 6;
+
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// per-frame uniform block - view, projection and camera - in
+	// a persistently mapped section per frame
+	RingBuffer m_frameBlockRing;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// framebuffer the scene is rendered into when running headless
+	GLuint m_offscreenFramebuffer;
+	GLuint m_offscreenColor;
+	GLuint m_offscreenDepth;
+	// view and projection matrices from the last latch of the camera
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	// size in pixels of the viewport the scene is drawn to
+	glm::vec2 m_viewportSize;
+	// true when the window delivers input to latch late in the frame
+	bool m_bLateLatch;
+	// movement keys that are held, and the time the camera has been
+	// moved up to for each of them
+	bool m_bKeysHeld[MOVEMENT_KEY_COUNT];
+	std::chrono::steady_clock::time_point m_keysMovedUntil[MOVEMENT_KEY_COUNT];
+	// time the oldest input shown by the current frame was received
+	std::chrono::steady_clock::time_point m_inputTime;
+	bool m_bInputShown;
+	// counters of the input applied to the camera
+	INPUT_STATS m_inputStats;
+
+	// apply the waiting input events and the held keys to the camera,
+	// returns true when the camera may have moved
+	bool LatchInput(bool bLate);
+	// apply one input event to the camera
+	void ApplyInputEvent(const INPUT_EVENT& event);
+	// move the camera along a held key up to a time
+	void MoveHeldKey(int keyIndex, std::chrono::steady_clock::time_point until);
+	// compute the matrices from the camera and write the frame block
+	void WriteFrameBlock();
+
+public:
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	// create a hidden window that only provides the OpenGL context
+	GLFWwindow* CreateOffscreenWindow(const char* windowTitle);
+	// create and bind the framebuffer for headless rendering,
+	// must be called after GLEW has been initialized
+	bool CreateOffscreenTarget();
+	// place the camera at a position looking along a direction
+	void SetCameraPose(const glm::vec3& position, const glm::vec3& front);
+	
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+	// move the camera again by the input received since
+	// PrepareSceneView(), right before the scene is drawn
+	void LatchSceneView();
+	// finish the frame after the scene has been drawn
+	void FinishSceneView();
+
+	// get the view and projection matrices of the current frame
+	const glm::mat4& GetViewMatrix() const;
+	const glm::mat4& GetProjectionMatrix() const;
+	// get the size in pixels of the viewport the scene is drawn to
+	const glm::vec2& GetViewportSize() const;
+	// get the time the oldest input shown by the current frame was
+	// received, returns false when the frame shows no new input
+	bool GetInputTime(std::chrono::steady_clock::time_point& inputTime) const;
+	// get the counters of the input applied to the camera
+	const INPUT_STATS& GetInputStats() const;
 };
\ No newline at end of file
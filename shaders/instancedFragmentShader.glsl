@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedFragmentShader.glsl
+// ============
+// fragment shader for the instanced basic shape meshes - phong lighting from
+// the point lights of the fragment's cluster using the per-instance color and
+// material index, with cube shadow maps for the shadow casting lights -
+// USE_TEXTURE and USE_LIGHTING are defined by the variant being built, so
+// each variant only holds the work its objects need
+///////////////////////////////////////////////////////////////////////////////
+#version 430 core
+
+// this must match the array size in UniformBuffer.h
+#define MAX_BLOCK_MATERIALS 64
+// these must match the cluster grid in LightClusters.h
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define MAX_LIGHTS_PER_CLUSTER 128
+// this must match SHADOW_MAP_TEXTURE_UNIT in ShadowMaps.h
+#define SHADOW_MAP_TEXTURE_UNIT 8
+// offsets keeping surfaces from shadowing themselves - along the
+// normal in world units, and in the stored depth
+// this must match MAX_SHADOW_LIGHTS in ShadowMaps.h
+#define MAX_SHADOW_LIGHTS 4
+#define SHADOW_NORMAL_OFFSET 0.02f
+#define SHADOW_DEPTH_BIAS 0.002f
+
+struct Material
+{
+	vec4 ambient;		// rgb = ambient color, a = ambient strength
+	vec4 diffuse;		// rgb = diffuse color, a = shininess
+	vec4 specular;		// rgb = specular color
+};
+
+struct PointLight
+{
+	vec4 position;		// xyz = position, w = radius, 0 lights everything
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+	vec4 shadow;		// x = shadow map index, -1 for none, y = reach of the shadows
+};
+
+flat in vec4 fragmentColor;
+#ifdef USE_LIGHTING
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+flat in int fragmentMaterialIndex;
+#endif
+#ifdef USE_TEXTURE
+in vec2 fragmentTextureCoordinate;
+flat in int fragmentTextureLayer;
+#endif
+
+out vec4 outFragmentColor;
+
+// per-frame values shared by every draw - the binding points of
+// the blocks must match the ones in UniformBuffer.h
+layout (std140, binding = 0) uniform FrameBlock
+{
+	mat4 view;
+	mat4 projection;
+	vec4 viewPosition;
+} frame;
+
+// every material defined by the scene
+layout (std140, binding = 1) uniform MaterialBlock
+{
+	Material materials[MAX_BLOCK_MATERIALS];
+};
+
+// lighting settings and the mapping from a fragment to its cluster
+layout (std140, binding = 2) uniform LightBlock
+{
+	ivec4 lightSettings;	// x = use lighting, y = number of lights
+	vec4 clusterMapping;	// x = depth slice scale, y = depth slice bias
+	mat4 clusterView;		// view the lights were assigned to the clusters with
+	mat4 clusterProjection;	// projection the lights were assigned to the clusters with
+};
+
+// every scene light, and the lights reaching each cluster as
+// assigned by the light cluster compute pass
+layout (std430, binding = 2) readonly buffer LightBuffer
+{
+	PointLight pointLights[];
+};
+layout (std430, binding = 3) readonly buffer ClusterCountBuffer
+{
+	uint clusterLightCounts[];
+};
+layout (std430, binding = 4) readonly buffer ClusterIndexBuffer
+{
+	uint clusterLightIndices[];
+};
+
+// texture array of the multi-draw call - every draw of a call
+// samples the same array, set as a uniform, since an index into
+// a sampler array taken from gl_DrawID is not dynamically uniform
+// across the draws of a call
+uniform sampler2DArray objectTexture;
+
+// cube shadow maps of the shadow casting lights, holding the
+// distance to the closest caster over the reach of the shadows
+layout (binding = SHADOW_MAP_TEXTURE_UNIT) uniform samplerCubeShadow shadowMaps[MAX_SHADOW_LIGHTS];
+
+#ifdef USE_LIGHTING
+
+// compare a depth against a shadow map - the lights of a cluster
+// differ between fragments, so the sampler is picked with
+// constant indices
+float SampleShadowMap(int shadowIndex, vec3 direction, float depth)
+{
+	switch (shadowIndex)
+	{
+	case 0: return(texture(shadowMaps[0], vec4(direction, depth)));
+	case 1: return(texture(shadowMaps[1], vec4(direction, depth)));
+	case 2: return(texture(shadowMaps[2], vec4(direction, depth)));
+	case 3: return(texture(shadowMaps[3], vec4(direction, depth)));
+	}
+	return(1.0f);
+}
+
+// get how much of a light reaches the fragment past the shadow
+// casters - the depth comparison is filtered over four texels
+float GetShadow(PointLight light, vec3 normal)
+{
+	if (light.shadow.x < 0.0f)
+	{
+		return(1.0f);
+	}
+
+	vec3 lightToFragment = fragmentPosition + normal * SHADOW_NORMAL_OFFSET - light.position.xyz;
+	float depth = length(lightToFragment) / light.shadow.y;
+	if (depth >= 1.0f)
+	{
+		return(1.0f);
+	}
+
+	return(SampleShadowMap(int(light.shadow.x), lightToFragment, depth - SHADOW_DEPTH_BIAS));
+}
+
+vec3 CalcPointLight(PointLight light, Material material, vec3 normal, vec3 viewDirection)
+{
+	vec3 lightDirection = normalize(light.position.xyz - fragmentPosition);
+	vec3 reflectDirection = reflect(-lightDirection, normal);
+
+	float diffuseImpact = max(dot(normal, lightDirection), 0.0f);
+	float specularImpact = pow(max(dot(viewDirection, reflectDirection), 0.0f), material.diffuse.a);
+
+	vec3 ambient = light.ambient.rgb * material.ambient.rgb * material.ambient.a;
+	vec3 diffuse = light.diffuse.rgb * diffuseImpact * material.diffuse.rgb;
+	vec3 specular = light.specular.rgb * specularImpact * material.specular.rgb;
+
+	// lights with a radius fade out smoothly to nothing at it
+	float attenuation = 1.0f;
+	if (light.position.w > 0.0f)
+	{
+		float distanceRatio = length(light.position.xyz - fragmentPosition) / light.position.w;
+		attenuation = clamp(1.0f - pow(distanceRatio, 4.0f), 0.0f, 1.0f);
+		attenuation *= attenuation;
+	}
+
+	// the shadows only hold back the direct light
+	float shadow = GetShadow(light, normal);
+
+	return((ambient + (diffuse + specular) * shadow) * attenuation);
+}
+
+// get the cluster holding the fragment from its screen tile and
+// view depth under the view the clusters were built for - the
+// late latch can have moved the frame's view since
+uint GetCluster()
+{
+	vec4 clusterPosition = clusterView * vec4(fragmentPosition, 1.0f);
+	vec4 clipPosition = clusterProjection * clusterPosition;
+	vec2 tile = (clipPosition.xy / clipPosition.w * 0.5f + 0.5f) * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y);
+	int slice = int(floor(log(max(-clusterPosition.z, 0.0001f)) * clusterMapping.x - clusterMapping.y));
+	uvec3 cell = uvec3(
+		clamp(ivec2(floor(tile)), ivec2(0), ivec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1)),
+		clamp(slice, 0, CLUSTER_GRID_Z - 1));
+
+	return(cell.x + (cell.y + cell.z * CLUSTER_GRID_Y) * CLUSTER_GRID_X);
+}
+
+#endif
+
+void main()
+{
+#ifdef USE_TEXTURE
+	vec4 baseColor = texture(objectTexture, vec3(fragmentTextureCoordinate, float(fragmentTextureLayer)));
+#else
+	vec4 baseColor = fragmentColor;
+#endif
+
+#ifndef USE_LIGHTING
+	// objects without a material have no lighting response
+	outFragmentColor = baseColor;
+#else
+	if (lightSettings.x == 0)
+	{
+		outFragmentColor = baseColor;
+		return;
+	}
+
+	Material material = materials[fragmentMaterialIndex];
+	vec3 normal = normalize(fragmentVertexNormal);
+	vec3 viewDirection = normalize(frame.viewPosition.xyz - fragmentPosition);
+	vec3 phongResult = vec3(0.0f);
+
+	// only the lights reaching the fragment's cluster are evaluated
+	uint cluster = GetCluster();
+	uint lightCount = min(clusterLightCounts[cluster], uint(MAX_LIGHTS_PER_CLUSTER));
+	for (uint i = 0u; i < lightCount; i++)
+	{
+		uint lightIndex = clusterLightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + i];
+		phongResult += CalcPointLight(pointLights[lightIndex], material, normal, viewDirection);
+	}
+
+	outFragmentColor = vec4(phongResult * baseColor.rgb, baseColor.a);
+#endif
+}
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedVertexShader.glsl
+// ============
+// vertex shader for drawing the basic shape meshes with multi-draw indirect -
+// the model matrix, color, material index and texture layer come from the
+// instance buffer - USE_TEXTURE and USE_LIGHTING are defined by the variant
+// being built, and leave out the values the fragment shader of the variant
+// does not read
+///////////////////////////////////////////////////////////////////////////////
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+struct Instance
+{
+	mat4 model;
+	vec4 color;
+	vec4 params;	// xy = UV scale, z = material index, w = texture array layer, -1 when untextured
+};
+
+// per-instance values of every drawn object - the binding
+// point must match the one in MeshLibrary.h
+layout (std430, binding = 0) readonly buffer InstanceBlock
+{
+	Instance instances[];
+};
+
+// per-frame values shared by every draw - the binding point must
+// match the one in UniformBuffer.h
+layout (std140, binding = 0) uniform FrameBlock
+{
+	mat4 view;
+	mat4 projection;
+	vec4 viewPosition;
+} frame;
+
+flat out vec4 fragmentColor;
+#ifdef USE_LIGHTING
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+flat out int fragmentMaterialIndex;
+#endif
+#ifdef USE_TEXTURE
+out vec2 fragmentTextureCoordinate;
+flat out int fragmentTextureLayer;
+#endif
+
+void main()
+{
+	// gl_InstanceID does not include the base instance of the draw
+	Instance instance = instances[gl_BaseInstanceARB + gl_InstanceID];
+	vec4 worldPosition = instance.model * vec4(inVertexPosition, 1.0f);
+
+	gl_Position = frame.projection * frame.view * worldPosition;
+	fragmentColor = instance.color;
+
+#ifdef USE_LIGHTING
+	fragmentPosition = vec3(worldPosition);
+	fragmentVertexNormal = mat3(transpose(inverse(instance.model))) * inVertexNormal;
+	fragmentMaterialIndex = int(floor(instance.params.z + 0.5f));
+#endif
+#ifdef USE_TEXTURE
+	fragmentTextureCoordinate = inTextureCoordinate * instance.params.xy;
+	fragmentTextureLayer = int(floor(instance.params.w + 0.5f));
+#endif
+}
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightClusterComputeShader.glsl
+// ============
+// compute shader assigning the scene point lights to the view-space clusters -
+// one invocation per cluster, testing the lights in batches shared by the group
+///////////////////////////////////////////////////////////////////////////////
+#version 430 core
+
+// these must match the values in LightClusters.h and LightClusters.cpp
+#define CLUSTER_GRID_X 16
+#define CLUSTER_GRID_Y 9
+#define CLUSTER_GRID_Z 24
+#define MAX_LIGHTS_PER_CLUSTER 128
+#define CLUSTERS_PER_GROUP 128
+
+#define CLUSTER_COUNT (CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z)
+
+layout (local_size_x = CLUSTERS_PER_GROUP) in;
+
+struct PointLight
+{
+	vec4 position;		// xyz = position, w = radius, 0 lights everything
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+	vec4 shadow;		// x = shadow map index, -1 for none, y = reach of the shadows
+};
+
+layout (std430, binding = 2) readonly buffer LightBuffer
+{
+	PointLight pointLights[];
+};
+
+layout (std430, binding = 3) writeonly buffer ClusterCountBuffer
+{
+	uint clusterLightCounts[];
+};
+
+layout (std430, binding = 4) writeonly buffer ClusterIndexBuffer
+{
+	uint clusterLightIndices[];
+};
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec2 depthRange;		// x = near plane, y = far plane
+uniform int lightCount;
+
+// view-space position and radius of the current batch of lights
+shared vec4 batchLights[CLUSTERS_PER_GROUP];
+
+// the view-space point at a view depth that projects onto a
+// position in normalized device coordinates
+vec3 GetViewPoint(vec2 ndc, float viewZ)
+{
+	float w = projection[2][3] * viewZ + projection[3][3];
+	float x = (ndc.x * w - projection[2][0] * viewZ - projection[3][0]) / projection[0][0];
+	float y = (ndc.y * w - projection[2][1] * viewZ - projection[3][1]) / projection[1][1];
+	return(vec3(x, y, viewZ));
+}
+
+void main()
+{
+	uint cluster = gl_GlobalInvocationID.x;
+	bool bValidCluster = (cluster < CLUSTER_COUNT);
+
+	// the screen tile and depth slice of the cluster
+	uvec3 cell = uvec3(
+		cluster % CLUSTER_GRID_X,
+		(cluster / CLUSTER_GRID_X) % CLUSTER_GRID_Y,
+		cluster / (CLUSTER_GRID_X * CLUSTER_GRID_Y));
+	vec2 tileMin = vec2(cell.xy) / vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y) * 2.0f - 1.0f;
+	vec2 tileMax = vec2(cell.xy + 1u) / vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y) * 2.0f - 1.0f;
+	float depthRatio = depthRange.y / depthRange.x;
+	float sliceNear = depthRange.x * pow(depthRatio, float(cell.z) / CLUSTER_GRID_Z);
+	float sliceFar = depthRange.x * pow(depthRatio, float(cell.z + 1u) / CLUSTER_GRID_Z);
+
+	// view-space box around the corners of the cluster
+	vec3 boxMin = vec3(1.0e30f);
+	vec3 boxMax = vec3(-1.0e30f);
+	for (int corner = 0; corner < 8; corner++)
+	{
+		vec2 ndc = vec2(((corner & 1) != 0) ? tileMax.x : tileMin.x, ((corner & 2) != 0) ? tileMax.y : tileMin.y);
+		vec3 point = GetViewPoint(ndc, ((corner & 4) != 0) ? -sliceFar : -sliceNear);
+		boxMin = min(boxMin, point);
+		boxMax = max(boxMax, point);
+	}
+
+	uint count = 0u;
+	for (int batchStart = 0; batchStart < lightCount; batchStart += CLUSTERS_PER_GROUP)
+	{
+		// each invocation moves one light of the batch into view space
+		int lightIndex = batchStart + int(gl_LocalInvocationID.x);
+		if (lightIndex < lightCount)
+		{
+			vec4 light = pointLights[lightIndex].position;
+			batchLights[gl_LocalInvocationID.x] = vec4((view * vec4(light.xyz, 1.0f)).xyz, light.w);
+		}
+		barrier();
+
+		int batchSize = min(CLUSTERS_PER_GROUP, lightCount - batchStart);
+		for (int i = 0; (i < batchSize) && bValidCluster; i++)
+		{
+			vec4 light = batchLights[i];
+			vec3 offset = clamp(light.xyz, boxMin, boxMax) - light.xyz;
+			if (((light.w <= 0.0f) || (dot(offset, offset) <= light.w * light.w)) &&
+				(count < MAX_LIGHTS_PER_CLUSTER))
+			{
+				clusterLightIndices[cluster * MAX_LIGHTS_PER_CLUSTER + count] = uint(batchStart + i);
+				count++;
+			}
+		}
+		barrier();
+	}
+
+	if (bValidCluster)
+	{
+		clusterLightCounts[cluster] = count;
+	}
+}
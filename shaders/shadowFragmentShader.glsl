@@ -0,0 +1,18 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowFragmentShader.glsl
+// ============
+// fragment shader for the cube shadow maps - the depth written is the distance
+// to the light over the reach of its shadows, so every face of the cube holds
+// the same measure
+///////////////////////////////////////////////////////////////////////////////
+#version 430 core
+
+in vec3 fragmentPosition;
+
+// xyz = light position, w = reach of the shadows
+uniform vec4 lightPosition;
+
+void main()
+{
+	gl_FragDepth = length(fragmentPosition - lightPosition.xyz) / lightPosition.w;
+}
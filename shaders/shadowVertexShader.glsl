@@ -0,0 +1,31 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowVertexShader.glsl
+// ============
+// vertex shader for drawing the shadow casters into one face of a cube shadow
+// map - the model matrix of each caster comes from the caster buffer
+///////////////////////////////////////////////////////////////////////////////
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout (location = 0) in vec3 inVertexPosition;
+
+// model matrix of every caster drawn - the binding point must
+// match the one in ShadowMaps.h
+layout (std430, binding = 5) readonly buffer CasterBlock
+{
+	mat4 casterModels[];
+};
+
+// view and projection of the cube face being drawn
+uniform mat4 faceViewProjection;
+
+out vec3 fragmentPosition;
+
+void main()
+{
+	// gl_InstanceID does not include the base instance of the draw
+	vec4 worldPosition = casterModels[gl_BaseInstanceARB + gl_InstanceID] * vec4(inVertexPosition, 1.0f);
+
+	gl_Position = faceViewProjection * worldPosition;
+	fragmentPosition = vec3(worldPosition);
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameallocationtest.cpp
+// ============
+// test that the steady-state frames of the scene never touch the heap
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// declaration of global variables
+namespace
+{
+	// frames rendered before measuring, so the textures have streamed
+	// in and the caches are filled, then the measured frames
+	const int g_WarmupFrames = 10;
+	const int g_TestFrames = 120;
+	// statistics file the scene program writes the counted
+	// allocations into
+	const char* g_StatsFilename = "frame_allocation_test.json";
+	// key of the allocation count in the statistics file
+	const char* g_AllocationsKey = "\"frame_allocations\":";
+}
+
+/***********************************************************
+ *  ReadFrameAllocations()
+ *
+ *  This function is used for reading the number of heap
+ *  allocations the measured frames made from the statistics
+ *  file of a benchmark run.  Returns -1 when the file or the
+ *  value is missing.
+ ***********************************************************/
+long long ReadFrameAllocations(const char* filename)
+{
+	FILE* file = fopen(filename, "rb");
+	if (NULL == file)
+	{
+		return(-1);
+	}
+
+	std::string text;
+	char buffer[1024];
+	size_t count = 0;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		text.append(buffer, count);
+	}
+	fclose(file);
+
+	size_t position = text.find(g_AllocationsKey);
+	if (position == std::string::npos)
+	{
+		return(-1);
+	}
+
+	return(strtoll(text.c_str() + position + strlen(g_AllocationsKey), NULL, 10));
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function renders the benchmark camera path headless
+ *  with the scene program at the passed in path, and fails
+ *  when the allocation tracker counted any heap allocation
+ *  in the steady-state frames, or the run itself failed.  It
+ *  is run from the folder holding the scenes and shaders,
+ *  like the scene program.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "Usage: " << argv[0] << " <path to the scene program>" << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	// a stale file must not pass for this run
+	remove(g_StatsFilename);
+
+	std::string command = std::string("\"") + argv[1] + "\" --headless" +
+		" --warmup " + std::to_string(g_WarmupFrames) +
+		" --frames " + std::to_string(g_TestFrames) +
+		" --stats " + g_StatsFilename +
+		" --check-allocations";
+	int result = std::system(command.c_str());
+
+	long long allocations = ReadFrameAllocations(g_StatsFilename);
+	if (allocations < 0)
+	{
+		std::cout << "FAIL: the benchmark run wrote no allocation count, exit status " << result << std::endl;
+		return(EXIT_FAILURE);
+	}
+	if (allocations > 0)
+	{
+		std::cout << "FAIL: " << allocations << " heap allocations over " << g_TestFrames
+			<< " steady-state frames" << std::endl;
+		return(EXIT_FAILURE);
+	}
+	if (result != 0)
+	{
+		std::cout << "FAIL: the benchmark run failed, exit status " << result << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	std::cout << "PASS: no heap allocations over " << g_TestFrames << " steady-state frames" << std::endl;
+	return(EXIT_SUCCESS);
+}